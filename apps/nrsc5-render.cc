@@ -0,0 +1,662 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * nrsc5-render: renders a configuration file (the same format as nrsc5-txd) to an IQ
+ * file as fast as the machine allows. Rendering the same configuration and input
+ * files twice gives byte-identical output.
+ *
+ * Audio encoding, PSD, SIS and Layer 2 run in a GNU Radio flowgraph. Layer 1, OFDM,
+ * the analog signal, resampling and output then run as a pipeline of threads, one
+ * frame at a time, so that each stage can use its own core.
+ *
+ * With fixed_point set, Layer 1 and OFDM produce int16 samples directly, as an
+ * exciter without a fast FPU would, and are written out without conversion.
+ */
+
+#include "render_analog.h"
+#include "render_collector.h"
+#include "render_queue.h"
+#include "txd_config.h"
+#include "txd_format.h"
+#include "txd_upstream.h"
+#include <gnuradio/high_res_timer.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/top_block.h>
+#include <nrsc5/core/l1_am_frame_encoder.h>
+#include <nrsc5/core/l1_fm_frame_encoder.h>
+#include <nrsc5/core/ofdm_modulator.h>
+#include <nrsc5/core/rational_resampler.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using namespace gr::nrsc5;
+
+namespace {
+
+constexpr double AUDIO_RATE = 44100;
+
+/* Frames each stage may run ahead of the next one */
+constexpr size_t QUEUE_FRAMES = 4;
+
+/* Used for the LOT expiry time when SOURCE_DATE_EPOCH is not set: 2024-01-01 */
+constexpr const char* DEFAULT_EPOCH = "1704067200";
+
+struct pipeline {
+    render::queue<render::frame> frames{ QUEUE_FRAMES };
+    render::queue<std::vector<float>> audio{ QUEUE_FRAMES };
+    render::queue<std::vector<gr_complex>> symbols{ QUEUE_FRAMES };
+    render::queue<std::vector<gr_complex>> digital{ QUEUE_FRAMES };
+    render::queue<std::vector<gr_complex>> analog{ QUEUE_FRAMES };
+    render::queue<std::vector<gr_complex>> baseband{ QUEUE_FRAMES };
+    render::queue<std::vector<sc16_t>> symbols_sc16{ QUEUE_FRAMES };
+    render::queue<std::vector<sc16_t>> baseband_sc16{ QUEUE_FRAMES };
+
+    std::mutex error_mutex;
+    std::string error;
+
+    /* Stops every stage after a failure */
+    void abort(const std::string& message)
+    {
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (error.empty()) {
+                error = message;
+            }
+        }
+        frames.close();
+        audio.close();
+        symbols.close();
+        digital.close();
+        analog.close();
+        baseband.close();
+        symbols_sc16.close();
+        baseband_sc16.close();
+    }
+};
+
+/* Seconds spent in each stage, excluding time spent waiting on the queues */
+struct stage_times {
+    double l1 = 0;
+    double ofdm = 0;
+    double analog = 0;
+    double resample = 0;
+    double output = 0;
+};
+
+class stopwatch
+{
+private:
+    double& total;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    stopwatch(double& total) : total(total), begin(std::chrono::steady_clock::now()) {}
+    ~stopwatch()
+    {
+        total += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin)
+                     .count();
+    }
+};
+
+void l1_stage(const txd::config& cfg, pipeline& p, double& busy)
+{
+    bool fm = (cfg.band == pids_mode::FM);
+    std::vector<l1_channel> channels =
+        fm ? l1_fm_frame_encoder::channels(cfg.service_mode)
+           : l1_am_frame_encoder::channels(cfg.service_mode);
+
+    std::unique_ptr<l1_fm_frame_encoder> fm_encoder;
+    std::unique_ptr<l1_am_frame_encoder> am_encoder;
+    size_t frame_size;
+    if (fm) {
+        fm_encoder.reset(new l1_fm_frame_encoder(cfg.service_mode));
+        frame_size =
+            l1_fm_frame_encoder::SYMBOLS_PER_FRAME * l1_fm_frame_encoder::FFT_SIZE;
+    } else {
+        am_encoder.reset(new l1_am_frame_encoder(cfg.service_mode));
+        frame_size =
+            l1_am_frame_encoder::SYMBOLS_PER_FRAME * l1_am_frame_encoder::FFT_SIZE;
+    }
+
+    // logical channels other than the first and PIDS are left empty, as in nrsc5-txd
+    std::vector<std::vector<unsigned char>> empty(channels.size());
+    std::vector<const unsigned char*> inputs(channels.size());
+    for (size_t c = 1; c + 1 < channels.size(); c++) {
+        empty[c].assign(channels[c].bits * channels[c].pdus_per_frame, 0);
+        inputs[c] = empty[c].data();
+    }
+
+    render::frame frame;
+    while (p.frames.pop(frame)) {
+        inputs.front() = frame.audio_channel.data();
+        inputs.back() = frame.pids.data();
+
+        if (cfg.fixed_point) {
+            std::vector<sc16_t> symbols(frame_size);
+            {
+                stopwatch sw(busy);
+                if (fm) {
+                    fm_encoder->encode_frame(inputs.data(), symbols.data());
+                } else {
+                    am_encoder->encode_frame(inputs.data(), symbols.data());
+                }
+            }
+            if (!p.symbols_sc16.push(std::move(symbols))) {
+                break;
+            }
+            continue;
+        }
+
+        std::vector<gr_complex> symbols(frame_size);
+        {
+            stopwatch sw(busy);
+            if (fm) {
+                fm_encoder->encode_frame(inputs.data(), symbols.data());
+            } else {
+                am_encoder->encode_frame(inputs.data(), symbols.data());
+            }
+        }
+        if (!p.symbols.push(std::move(symbols))) {
+            break;
+        }
+    }
+    p.symbols.close();
+    p.symbols_sc16.close();
+}
+
+void ofdm_stage(const txd::config& cfg, pipeline& p, double& busy)
+{
+    bool fm = (cfg.band == pids_mode::FM);
+    std::unique_ptr<fm_ofdm_modulator> fm_modulator;
+    std::unique_ptr<am_ofdm_modulator> am_modulator;
+    int symbols_per_frame;
+    int fft_size;
+    int symbol_size;
+    if (fm) {
+        fm_modulator.reset(new fm_ofdm_modulator(cfg.lsb_power_db, cfg.usb_power_db));
+        symbols_per_frame = l1_fm_frame_encoder::SYMBOLS_PER_FRAME;
+        fft_size = fm_ofdm_modulator::FFT_SIZE;
+        symbol_size = fm_ofdm_modulator::SYMBOL_SIZE;
+    } else {
+        am_modulator.reset(new am_ofdm_modulator());
+        symbols_per_frame = l1_am_frame_encoder::SYMBOLS_PER_FRAME;
+        fft_size = am_ofdm_modulator::FFT_SIZE;
+        symbol_size = am_ofdm_modulator::SYMBOL_SIZE;
+    }
+
+    std::vector<gr_complex> symbols;
+    while (p.symbols.pop(symbols)) {
+        std::vector<gr_complex> samples(symbols.size() / fft_size * symbol_size);
+        {
+            stopwatch sw(busy);
+            if (fm) {
+                fm_modulator->modulate(symbols.data(), samples.data(), symbols_per_frame);
+            } else {
+                am_modulator->modulate(symbols.data(), samples.data(), symbols_per_frame);
+            }
+        }
+        if (!p.digital.push(std::move(samples))) {
+            break;
+        }
+    }
+    p.digital.close();
+}
+
+/*
+ * Fixed-point counterpart of ofdm_stage, which also takes the place of
+ * resample_stage: the output needs no resampling, and the all-digital AM carrier is
+ * added by the modulator. An amplitude of 1 / gain is full scale, as in the float
+ * path.
+ */
+void ofdm_sc16_stage(const txd::config& cfg, pipeline& p, double& busy)
+{
+    bool fm = (cfg.band == pids_mode::FM);
+    double full_scale = 1.0 / cfg.gain;
+    std::unique_ptr<fm_ofdm_modulator_sc16> fm_modulator;
+    std::unique_ptr<am_ofdm_modulator_sc16> am_modulator;
+    int symbols_per_frame;
+    int fft_size;
+    int symbol_size;
+    if (fm) {
+        fm_modulator.reset(new fm_ofdm_modulator_sc16(
+            cfg.lsb_power_db, cfg.usb_power_db, full_scale));
+        symbols_per_frame = l1_fm_frame_encoder::SYMBOLS_PER_FRAME;
+        fft_size = fm_ofdm_modulator_sc16::FFT_SIZE;
+        symbol_size = fm_ofdm_modulator_sc16::SYMBOL_SIZE;
+    } else {
+        am_modulator.reset(new am_ofdm_modulator_sc16(full_scale, 1.0));
+        symbols_per_frame = l1_am_frame_encoder::SYMBOLS_PER_FRAME;
+        fft_size = am_ofdm_modulator_sc16::FFT_SIZE;
+        symbol_size = am_ofdm_modulator_sc16::SYMBOL_SIZE;
+    }
+
+    std::vector<sc16_t> symbols;
+    while (p.symbols_sc16.pop(symbols)) {
+        std::vector<sc16_t> samples(symbols.size() / fft_size * symbol_size);
+        {
+            stopwatch sw(busy);
+            if (fm) {
+                fm_modulator->modulate(symbols.data(), samples.data(), symbols_per_frame);
+            } else {
+                am_modulator->modulate(symbols.data(), samples.data(), symbols_per_frame);
+            }
+        }
+        if (!p.baseband_sc16.push(std::move(samples))) {
+            break;
+        }
+    }
+    p.baseband_sc16.close();
+}
+
+void analog_stage(const txd::config& cfg, pipeline& p, double& busy)
+{
+    std::unique_ptr<render::analog_modulator> modulator;
+    if (cfg.band == pids_mode::FM) {
+        modulator.reset(new render::fm_analog_modulator());
+    } else {
+        modulator.reset(new render::am_analog_modulator());
+    }
+
+    std::vector<float> audio;
+    while (p.audio.pop(audio)) {
+        std::vector<gr_complex> samples;
+        {
+            stopwatch sw(busy);
+            modulator->modulate(audio, samples);
+        }
+        if (!p.analog.push(std::move(samples))) {
+            break;
+        }
+    }
+    p.analog.close();
+}
+
+/*
+ * Adds the analog signal (or, for all-digital AM, the unmodulated carrier) to the
+ * digital one and converts to the output sample rate. Both signals are exactly one
+ * frame long: 65536 audio samples become 512 * 2160 samples for FM, or 256 * 270 for
+ * AM.
+ */
+void resample_stage(const txd::config& cfg,
+                    polyphase_resampler* resampler,
+                    pipeline& p,
+                    double& busy)
+{
+    std::vector<gr_complex> digital, analog;
+    while (p.digital.pop(digital)) {
+        if (cfg.analog) {
+            if (!p.analog.pop(analog) || (analog.size() != digital.size())) {
+                p.abort("analog and digital signals are misaligned");
+                break;
+            }
+        }
+
+        std::vector<gr_complex> out;
+        {
+            stopwatch sw(busy);
+            if (cfg.analog) {
+                for (size_t i = 0; i < digital.size(); i++) {
+                    digital[i] += analog[i];
+                }
+            } else if (cfg.band == pids_mode::AM) {
+                for (gr_complex& sample : digital) {
+                    sample += 1.0f;
+                }
+            }
+
+            if (resampler) {
+                resampler->process(digital.data(), digital.size(), out);
+            } else {
+                out.swap(digital);
+            }
+        }
+        if (!p.baseband.push(std::move(out))) {
+            break;
+        }
+    }
+    p.analog.close();
+    p.baseband.close();
+}
+
+void output_stage(const txd::config& cfg,
+                  uint64_t total_samples,
+                  pipeline& p,
+                  double& busy,
+                  uint64_t& written)
+{
+    FILE* file = stdout;
+    if (cfg.sink != txd::sink_type::STDOUT) {
+        file = fopen(cfg.path.c_str(), "wb");
+        if (!file) {
+            p.abort("cannot open " + cfg.path + ": " + strerror(errno));
+            return;
+        }
+    }
+
+    // the last frame is cut short at the requested duration
+    if (cfg.fixed_point) {
+        // already in cs16 format
+        std::vector<sc16_t> samples;
+        while (p.baseband_sc16.pop(samples)) {
+            stopwatch sw(busy);
+            size_t n = std::min<uint64_t>(samples.size(), total_samples - written);
+            if (fwrite(samples.data(), sizeof(sc16_t), n, file) != n) {
+                p.abort("write failed: " + std::string(strerror(errno)));
+                break;
+            }
+            written += n;
+        }
+    } else {
+        std::vector<gr_complex> samples;
+        std::vector<char> buf;
+        while (p.baseband.pop(samples)) {
+            stopwatch sw(busy);
+            size_t n = std::min<uint64_t>(samples.size(), total_samples - written);
+            txd::convert_samples(samples.data(), n, cfg.format, cfg.gain, buf);
+            if (fwrite(buf.data(), 1, buf.size(), file) != buf.size()) {
+                p.abort("write failed: " + std::string(strerror(errno)));
+                break;
+            }
+            written += n;
+        }
+    }
+
+    if (fflush(file) != 0) {
+        p.abort("write failed: " + std::string(strerror(errno)));
+    }
+    if (file != stdout) {
+        fclose(file);
+    }
+}
+
+/*
+ * Renders one frame of random bits through both the float and the fixed-point paths,
+ * and reports how far the fixed-point output is from the float output at the same
+ * scale, and how much of it was clipped.
+ */
+void check_fixed_point(const txd::config& cfg)
+{
+    bool fm = (cfg.band == pids_mode::FM);
+    std::vector<l1_channel> channels =
+        fm ? l1_fm_frame_encoder::channels(cfg.service_mode)
+           : l1_am_frame_encoder::channels(cfg.service_mode);
+
+    std::mt19937 rng(1);
+    std::vector<std::vector<unsigned char>> bits(channels.size());
+    std::vector<const unsigned char*> inputs;
+    for (size_t c = 0; c < channels.size(); c++) {
+        bits[c].resize(channels[c].bits * channels[c].pdus_per_frame);
+        for (unsigned char& bit : bits[c]) {
+            bit = rng() & 1;
+        }
+        inputs.push_back(bits[c].data());
+    }
+
+    double full_scale = 1.0 / cfg.gain;
+    std::vector<gr_complex> expected;
+    std::vector<sc16_t> actual;
+    if (fm) {
+        constexpr int symbols_per_frame = l1_fm_frame_encoder::SYMBOLS_PER_FRAME;
+        std::vector<gr_complex> symbols(symbols_per_frame * fm_ofdm_modulator::FFT_SIZE);
+        std::vector<sc16_t> symbols_sc16(symbols.size());
+        // each path starts from a fresh encoder, as the encoders keep state
+        std::unique_ptr<l1_fm_frame_encoder> encoder(
+            new l1_fm_frame_encoder(cfg.service_mode));
+        encoder->encode_frame(inputs.data(), symbols.data());
+        encoder.reset(new l1_fm_frame_encoder(cfg.service_mode));
+        encoder->encode_frame(inputs.data(), symbols_sc16.data());
+
+        expected.resize(symbols_per_frame * fm_ofdm_modulator::SYMBOL_SIZE);
+        actual.resize(expected.size());
+        fm_ofdm_modulator(cfg.lsb_power_db, cfg.usb_power_db)
+            .modulate(symbols.data(), expected.data(), symbols_per_frame);
+        fm_ofdm_modulator_sc16(cfg.lsb_power_db, cfg.usb_power_db, full_scale)
+            .modulate(symbols_sc16.data(), actual.data(), symbols_per_frame);
+    } else {
+        constexpr int symbols_per_frame = l1_am_frame_encoder::SYMBOLS_PER_FRAME;
+        std::vector<gr_complex> symbols(symbols_per_frame * am_ofdm_modulator::FFT_SIZE);
+        std::vector<sc16_t> symbols_sc16(symbols.size());
+        // each path starts from a fresh encoder, as the encoders keep state
+        std::unique_ptr<l1_am_frame_encoder> encoder(
+            new l1_am_frame_encoder(cfg.service_mode));
+        encoder->encode_frame(inputs.data(), symbols.data());
+        encoder.reset(new l1_am_frame_encoder(cfg.service_mode));
+        encoder->encode_frame(inputs.data(), symbols_sc16.data());
+
+        expected.resize(symbols_per_frame * am_ofdm_modulator::SYMBOL_SIZE);
+        actual.resize(expected.size());
+        am_ofdm_modulator().modulate(symbols.data(), expected.data(), symbols_per_frame);
+        am_ofdm_modulator_sc16(full_scale, 1.0)
+            .modulate(symbols_sc16.data(), actual.data(), symbols_per_frame);
+        for (gr_complex& sample : expected) {
+            sample += 1.0f;
+        }
+    }
+
+    double error = 0, power = 0;
+    size_t clipped = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        std::complex<double> x(expected[i]);
+        x *= INT16_MAX / full_scale;
+        std::complex<double> y(actual[i].real(), actual[i].imag());
+        error += std::norm(y - x);
+        power += std::norm(x);
+        if (std::max(std::abs(x.real()), std::abs(x.imag())) > INT16_MAX) {
+            clipped++;
+        }
+    }
+
+    char line[200];
+    snprintf(line,
+             sizeof(line),
+             "fixed point: EVM %.1f dB against the float path, %.4f%% of samples clipped",
+             10 * std::log10(error / power),
+             100.0 * clipped / expected.size());
+    std::cerr << "nrsc5-render: " << line << std::endl;
+}
+
+/* Total time spent in the work functions of the given blocks, from perf counters */
+double work_seconds(const std::vector<gr::block_sptr>& blocks)
+{
+    double ticks = 0;
+    for (const gr::block_sptr& block : blocks) {
+        ticks += block->pc_work_time_total();
+    }
+    return ticks / gr::high_res_timer_tps();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <config file>" << std::endl;
+        return 2;
+    }
+
+    // LOT headers carry an expiry time, which must not depend on when we run
+    setenv("SOURCE_DATE_EPOCH", DEFAULT_EPOCH, 0);
+    gr::prefs::singleton()->set_bool("PerfCounters", "on", true);
+
+    txd::config cfg;
+    std::unique_ptr<polyphase_resampler> resampler;
+    gr::top_block_sptr tb;
+    txd::upstream up;
+    render::frame_collector::sptr collector;
+    pipeline p;
+    uint64_t frames;
+    double ofdm_rate;
+    try {
+        cfg = txd::load_config(argv[1]);
+        if (cfg.duration <= 0) {
+            throw std::runtime_error("duration must be set");
+        }
+        if (!cfg.lot_spool.empty()) {
+            throw std::runtime_error("a LOT spool cannot be rendered; use file lines");
+        }
+        bool fm = (cfg.band == pids_mode::FM);
+        ofdm_rate = fm ? FM_OFDM_SAMPLE_RATE : AM_OFDM_SAMPLE_RATE;
+        if (cfg.sample_rate != 0) {
+            if (cfg.sample_rate != std::floor(cfg.sample_rate)) {
+                throw std::runtime_error("sample_rate must be a whole number of Hz");
+            }
+            resampler.reset(new polyphase_resampler(
+                ofdm_rate,
+                cfg.sample_rate,
+                fm ? FM_OFDM_BANDWIDTH : AM_OFDM_BANDWIDTH));
+        }
+        if (cfg.fixed_point) {
+            if ((cfg.format != txd::sample_format::CS16) || cfg.analog ||
+                (cfg.sample_rate != 0)) {
+                throw std::runtime_error(
+                    "fixed_point needs cs16 format, and no analog or sample_rate");
+            }
+            check_fixed_point(cfg);
+        }
+
+        std::vector<l1_channel> channels =
+            fm ? l1_fm_frame_encoder::channels(cfg.service_mode)
+               : l1_am_frame_encoder::channels(cfg.service_mode);
+        frames = (uint64_t)std::ceil(cfg.duration * AUDIO_RATE / render::AUDIO_PER_FRAME);
+
+        tb = gr::make_top_block("nrsc5-render");
+        up = txd::build_upstream(tb, cfg, channels);
+
+        // Wait for each AAS source to answer before building the next PDU, so that
+        // the data subchannel does not depend on message timing
+        std::vector<int> lockstep_ports = up.lot_ports;
+        lockstep_ports.push_back(0x20);
+        up.l2->set_lockstep_ports(lockstep_ports);
+
+        int audio_channels = 0;
+        if (cfg.analog) {
+            if (!up.first_wav) {
+                throw std::runtime_error("analog needs a WAV file for the first program");
+            }
+            audio_channels = std::min(up.first_wav->channels(), 2);
+        }
+        collector = gnuradio::make_block_sptr<render::frame_collector>(
+            channels.front(),
+            channels.back(),
+            audio_channels,
+            frames,
+            p.frames,
+            cfg.analog ? &p.audio : nullptr);
+
+        tb->connect(up.l2, 0, collector, 0);
+        tb->connect(up.sis, 0, collector, 1);
+        for (int c = 0; c < audio_channels; c++) {
+            tb->connect(up.first_wav, c, collector, 2 + c);
+        }
+        tb->msg_connect(collector, "clock", up.psd, "clock");
+        tb->msg_connect(collector, "clock", up.sis, "clock");
+    } catch (const std::exception& e) {
+        std::cerr << "nrsc5-render: " << e.what() << std::endl;
+        return 1;
+    }
+
+    double output_rate = resampler ? cfg.sample_rate : ofdm_rate;
+    uint64_t total_samples = (uint64_t)(cfg.duration * output_rate);
+    uint64_t written = 0;
+    stage_times times;
+
+    auto begin = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> stages;
+    stages.emplace_back(l1_stage, std::cref(cfg), std::ref(p), std::ref(times.l1));
+    if (cfg.fixed_point) {
+        stages.emplace_back(
+            ofdm_sc16_stage, std::cref(cfg), std::ref(p), std::ref(times.ofdm));
+    } else {
+        stages.emplace_back(
+            ofdm_stage, std::cref(cfg), std::ref(p), std::ref(times.ofdm));
+        if (cfg.analog) {
+            stages.emplace_back(
+                analog_stage, std::cref(cfg), std::ref(p), std::ref(times.analog));
+        }
+        stages.emplace_back(resample_stage,
+                            std::cref(cfg),
+                            resampler.get(),
+                            std::ref(p),
+                            std::ref(times.resample));
+    }
+    stages.emplace_back(output_stage,
+                        std::cref(cfg),
+                        total_samples,
+                        std::ref(p),
+                        std::ref(times.output),
+                        std::ref(written));
+
+    try {
+        tb->start();
+    } catch (const std::exception& e) {
+        p.abort(e.what());
+    }
+
+    // If the flowgraph stops early, let the pipeline drain so that we can report it
+    std::thread waiter([&tb, &p]() {
+        tb->wait();
+        p.frames.close();
+        p.audio.close();
+    });
+
+    for (std::thread& stage : stages) {
+        stage.join();
+    }
+    tb->stop();
+    waiter.join();
+
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if (!p.error.empty()) {
+        std::cerr << "nrsc5-render: " << p.error << std::endl;
+        return 1;
+    }
+    if (written < total_samples) {
+        std::cerr << "nrsc5-render: flowgraph stopped after " << written << " of "
+                  << total_samples << " samples" << std::endl;
+        return 1;
+    }
+
+    double seconds = written / output_rate;
+    char line[200];
+    snprintf(line,
+             sizeof(line),
+             "%llu frames (%.1f s at %.0f Hz) in %.2f s: %.2f frames/s, %.1fx real time",
+             (unsigned long long)frames,
+             seconds,
+             output_rate,
+             elapsed,
+             frames / elapsed,
+             seconds / elapsed);
+    std::cerr << "nrsc5-render: " << line << std::endl;
+    snprintf(line,
+             sizeof(line),
+             "busy seconds: aac %.2f l2 %.2f l1 %.2f ofdm %.2f analog %.2f "
+             "resample %.2f output %.2f",
+             work_seconds(up.audio_encoders),
+             work_seconds({ up.l2 }),
+             times.l1,
+             times.ofdm,
+             times.analog,
+             times.resample,
+             times.output);
+    std::cerr << "nrsc5-render: " << line << std::endl;
+    return 0;
+}
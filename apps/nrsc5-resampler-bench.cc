@@ -0,0 +1,153 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * nrsc5-resampler-bench: measures polyphase_resampler taking the FM and AM OFDM
+ * signals to common SDR sample rates. For each rate it prints the filter size, the
+ * image rejection measured with test tones, and the throughput on one core.
+ */
+
+#include <nrsc5/core/rational_resampler.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace gr::nrsc5;
+
+namespace {
+
+const double OUTPUT_RATES[] = { 2000000, 2400000, 10000000 };
+
+/* Seconds of measurement for each rate */
+constexpr double BENCH_SECONDS = 1.0;
+
+/*
+ * Resamples a tone and returns everything but the tone (images, aliases and filter
+ * error) relative to the tone, in dB
+ */
+double tone_error_db(double input_rate,
+                     double output_rate,
+                     double bandwidth,
+                     double rejection_db,
+                     double freq)
+{
+    polyphase_resampler resampler(input_rate, output_rate, bandwidth, rejection_db);
+    std::vector<gr_complex> in(20000), out;
+    for (size_t n = 0; n < in.size(); n++) {
+        in[n] = std::polar(1.0, 2 * M_PI * freq * n / input_rate);
+    }
+    resampler.process(in.data(), in.size(), out);
+
+    // skip the filter's start-up, then fit the tone's amplitude and phase
+    size_t start = out.size() / 10;
+    std::complex<double> gain = 0;
+    for (size_t n = start; n < out.size(); n++) {
+        gain += std::complex<double>(out[n]) *
+                std::polar(1.0, -2 * M_PI * freq * n / output_rate);
+    }
+    gain /= (double)(out.size() - start);
+
+    double error = 0, power = 0;
+    for (size_t n = start; n < out.size(); n++) {
+        std::complex<double> tone =
+            gain * std::polar(1.0, 2 * M_PI * freq * n / output_rate);
+        error += std::norm(std::complex<double>(out[n]) - tone);
+        power += std::norm(tone);
+    }
+    return 10 * std::log10(error / power);
+}
+
+void bench(const char* band,
+           double input_rate,
+           double bandwidth,
+           int frame_size,
+           double output_rate,
+           double rejection_db)
+{
+    polyphase_resampler resampler(input_rate, output_rate, bandwidth, rejection_db);
+
+    double worst = -INFINITY;
+    for (double f : { -0.95, -0.5, 0.1, 0.5, 0.95 }) {
+        worst = std::max(worst,
+                         tone_error_db(input_rate,
+                                       output_rate,
+                                       bandwidth,
+                                       rejection_db,
+                                       f * bandwidth));
+    }
+
+    // one frame of noise, resampled over and over
+    std::mt19937 rng(1);
+    std::normal_distribution<float> normal;
+    std::vector<gr_complex> in(frame_size);
+    for (gr_complex& x : in) {
+        x = gr_complex(normal(rng), normal(rng));
+    }
+
+    std::vector<gr_complex> out;
+    uint64_t produced = 0;
+    double elapsed = 0;
+    auto begin = std::chrono::steady_clock::now();
+    while (elapsed < BENCH_SECONDS) {
+        out.clear();
+        resampler.process(in.data(), in.size(), out);
+        produced += out.size();
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin)
+                      .count();
+    }
+
+    double msps = produced / elapsed / 1e6;
+    printf("%-4s %10.0f %9lld/%-6lld %4d x %-3d %7.1f dB %8.1f %9.1fx\n",
+           band,
+           output_rate,
+           (long long)resampler.interpolation(),
+           (long long)resampler.decimation(),
+           resampler.phases(),
+           resampler.taps_per_phase(),
+           -worst,
+           msps,
+           msps * 1e6 / output_rate);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [image rejection in dB]\n", argv[0]);
+        return 2;
+    }
+    double rejection_db = (argc == 2) ? atof(argv[1]) : 80;
+
+    printf("band  rate (Hz)  ratio            filter    rejection     MS/s  real time\n");
+    try {
+        for (double rate : OUTPUT_RATES) {
+            bench("FM",
+                  FM_OFDM_SAMPLE_RATE,
+                  FM_OFDM_BANDWIDTH,
+                  512 * 2160,
+                  rate,
+                  rejection_db);
+        }
+        for (double rate : OUTPUT_RATES) {
+            bench("AM",
+                  AM_OFDM_SAMPLE_RATE,
+                  AM_OFDM_BANDWIDTH,
+                  256 * 270,
+                  rate,
+                  rejection_db);
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "nrsc5-resampler-bench: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * nrsc5-txd: headless HD Radio transmitter. Builds the whole transmit chain from a
+ * configuration file and streams complex baseband to a file, stdout or a FIFO. See
+ * nrsc5-txd.conf for the available settings.
+ */
+
+#include "txd_config.h"
+#include "txd_ofdm.h"
+#include "txd_sink.h"
+#include "txd_upstream.h"
+#include <gnuradio/blocks/add_const_cc.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/fft/fft_v.h>
+#include <gnuradio/fft/window.h>
+#include <gnuradio/top_block.h>
+#include <nrsc5/am_pulse_shaper.h>
+#include <nrsc5/core/l1_am_frame_encoder.h>
+#include <nrsc5/core/l1_fm_frame_encoder.h>
+#include <nrsc5/l1_am_encoder.h>
+#include <nrsc5/l1_fm_encoder.h>
+#include <nrsc5/lot_carousel.h>
+#include <nrsc5/sis_encoder.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace gr::nrsc5;
+
+namespace {
+
+/* Sample rates of the OFDM stage: 2048-point FFT with 112 samples of cyclic prefix
+ * for FM, and the same symbol rate with a 256-point FFT for AM */
+constexpr double FM_SAMPLE_RATE = 744187.5;
+constexpr double AM_SAMPLE_RATE = FM_SAMPLE_RATE / 16;
+
+struct transmitter {
+    gr::top_block_sptr tb;
+    txd::output_sink::sptr sink;
+    sis_encoder::sptr sis;
+    lot_carousel::sptr carousel;
+    double sample_rate;
+};
+
+/* OFDM stage for FM, from the core library's modulator */
+gr::basic_block_sptr fm_ofdm(transmitter& tx, const txd::config& cfg, gr::block_sptr l1)
+{
+    auto modulator =
+        gnuradio::make_block_sptr<txd::fm_modulator>(cfg.lsb_power_db, cfg.usb_power_db);
+    tx.tb->connect(l1, 0, modulator, 0);
+    return modulator;
+}
+
+/* OFDM stage for AM: IFFT and pulse shaping, plus the unmodulated analog carrier */
+gr::basic_block_sptr am_ofdm(transmitter& tx, gr::block_sptr l1)
+{
+    constexpr int fft_size = l1_am_frame_encoder::FFT_SIZE;
+
+    auto ifft = gr::fft::fft_vcc::make(
+        fft_size, false, gr::fft::window::rectangular(fft_size), true, 1);
+    auto shaper = am_pulse_shaper::make();
+    auto carrier = gr::blocks::add_const_cc::make(1);
+
+    tx.tb->connect(l1, 0, ifft, 0);
+    tx.tb->connect(ifft, 0, shaper, 0);
+    tx.tb->connect(shaper, 0, carrier, 0);
+    return carrier;
+}
+
+transmitter build(const txd::config& cfg)
+{
+    if (cfg.analog || (cfg.sample_rate != 0) || cfg.fixed_point) {
+        throw std::runtime_error(
+            "analog, sample_rate and fixed_point are only supported by nrsc5-render");
+    }
+
+    transmitter tx;
+    tx.tb = gr::make_top_block("nrsc5-txd");
+
+    bool fm = (cfg.band == pids_mode::FM);
+    std::vector<l1_channel> channels =
+        fm ? l1_fm_frame_encoder::channels(cfg.service_mode)
+           : l1_am_frame_encoder::channels(cfg.service_mode);
+    txd::upstream up = txd::build_upstream(tx.tb, cfg, channels);
+    tx.sis = up.sis;
+
+    gr::block_sptr l1;
+    if (fm) {
+        l1 = l1_fm_encoder::make(cfg.service_mode);
+    } else {
+        l1 = l1_am_encoder::make(cfg.service_mode);
+    }
+    tx.tb->connect(up.l2, 0, l1, 0);
+    for (size_t c = 1; c + 1 < channels.size(); c++) {
+        tx.tb->connect(gr::blocks::null_source::make(channels[c].bits), 0, l1, c);
+    }
+    tx.tb->connect(tx.sis, 0, l1, channels.size() - 1);
+
+    tx.tb->msg_connect(l1, "clock", up.psd, "clock");
+    tx.tb->msg_connect(l1, "clock", tx.sis, "clock");
+
+    if (!cfg.lot_spool.empty()) {
+        tx.carousel = lot_carousel::make(cfg.lot_spool, cfg.lot_port);
+        tx.tb->msg_connect(up.l2, "ready", tx.carousel, "ready");
+        tx.tb->msg_connect(tx.carousel, "aas", up.l2, "aas");
+    }
+
+    gr::basic_block_sptr baseband = fm ? fm_ofdm(tx, cfg, l1) : am_ofdm(tx, l1);
+    tx.sample_rate = fm ? FM_SAMPLE_RATE : AM_SAMPLE_RATE;
+
+    tx.sink = gnuradio::make_block_sptr<txd::output_sink>(
+        cfg.sink, cfg.path, cfg.format, cfg.gain);
+    if (cfg.duration > 0) {
+        auto head = gr::blocks::head::make(sizeof(gr_complex),
+                                           (uint64_t)(cfg.duration * tx.sample_rate));
+        tx.tb->connect(baseband, 0, head, 0);
+        tx.tb->connect(head, 0, tx.sink, 0);
+    } else {
+        tx.tb->connect(baseband, 0, tx.sink, 0);
+    }
+    return tx;
+}
+
+/* Real-time policy and CPU affinity are set on the main thread before the flowgraph
+ * starts, so that every scheduler thread inherits them */
+void setup_realtime(const txd::config& cfg)
+{
+    if (cfg.priority > 0) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            std::cerr << "nrsc5-txd: warning: mlockall failed: " << strerror(errno)
+                      << std::endl;
+        }
+        struct sched_param param = {};
+        param.sched_priority = cfg.priority;
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            std::cerr << "nrsc5-txd: warning: cannot enable real-time scheduling: "
+                      << strerror(errno) << std::endl;
+        }
+    }
+
+    if (!cfg.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cfg.cpus) {
+            CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "nrsc5-txd: warning: cannot set CPU affinity: "
+                      << strerror(errno) << std::endl;
+        }
+    }
+}
+
+/*
+ * Prints the real-time factor (seconds of signal produced per second) and the
+ * headroom (the fraction of each second of signal not spent producing it) over the
+ * last interval. Time spent blocked on the consumer counts as idle, so with a paced
+ * consumer the real-time factor settles at 1 and the headroom shows the spare
+ * capacity; a negative headroom means the transmitter is falling behind.
+ */
+class reporter
+{
+private:
+    const transmitter& tx;
+    std::chrono::steady_clock::time_point last_time;
+    uint64_t last_items;
+    uint64_t last_blocked;
+
+public:
+    reporter(const transmitter& tx) : tx(tx)
+    {
+        last_time = std::chrono::steady_clock::now();
+        last_items = tx.sink->items();
+        last_blocked = tx.sink->blocked_ns();
+    }
+
+    void report()
+    {
+        auto now = std::chrono::steady_clock::now();
+        uint64_t items = tx.sink->items();
+        uint64_t blocked = tx.sink->blocked_ns();
+
+        double wall = std::chrono::duration<double>(now - last_time).count();
+        double signal = (items - last_items) / tx.sample_rate;
+        double busy = wall - (blocked - last_blocked) * 1e-9;
+
+        char line[160];
+        if (signal > 0) {
+            snprintf(line,
+                     sizeof(line),
+                     "rtf %.3f headroom %.1f%% sis underruns %llu",
+                     signal / wall,
+                     100 * (1 - busy / signal),
+                     (unsigned long long)tx.sis->underruns());
+        } else {
+            snprintf(line, sizeof(line), "rtf 0.000 (no output)");
+        }
+        std::cerr << "nrsc5-txd: " << line;
+        if (tx.carousel) {
+            std::cerr << " lot files " << tx.carousel->num_files();
+        }
+        std::cerr << std::endl;
+
+        last_time = now;
+        last_items = items;
+        last_blocked = blocked;
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <config file>" << std::endl;
+        return 2;
+    }
+
+    txd::config cfg;
+    transmitter tx;
+    try {
+        cfg = txd::load_config(argv[1]);
+        tx = build(cfg);
+    } catch (const std::exception& e) {
+        std::cerr << "nrsc5-txd: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Signals are handled synchronously below, so block them before any threads exist
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    setup_realtime(cfg);
+
+    try {
+        tx.tb->start();
+    } catch (const std::exception& e) {
+        std::cerr << "nrsc5-txd: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Wakes the main thread when the flowgraph finishes on its own
+    std::thread waiter([&tx]() {
+        tx.tb->wait();
+        kill(getpid(), SIGUSR1);
+    });
+
+    reporter rep(tx);
+    struct timespec interval;
+    interval.tv_sec = (time_t)cfg.report_interval;
+    interval.tv_nsec = (long)((cfg.report_interval - interval.tv_sec) * 1e9);
+    while (true) {
+        int sig = sigtimedwait(&signals, nullptr, &interval);
+        if (sig < 0) {
+            rep.report();
+            continue;
+        }
+        if (sig != SIGUSR1) {
+            std::cerr << "nrsc5-txd: stopping" << std::endl;
+            tx.tb->stop();
+        }
+        break;
+    }
+    waiter.join();
+    rep.report();
+    return 0;
+}
@@ -0,0 +1,106 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "render_analog.h"
+#include <cmath>
+
+namespace render {
+
+namespace {
+
+constexpr double AUDIO_RATE = 44100;
+constexpr double FM_SAMPLE_RATE = 744187.5;
+
+/* Diversity delays used by the hd_tx_* flowgraphs */
+constexpr double FM_DELAY = 4.458;
+constexpr double AM_DELAY = 5.5;
+
+constexpr double FM_TAU = 75e-6;
+constexpr double FM_DEVIATION = 75e3;
+
+} // namespace
+
+analog_modulator::analog_modulator(double delay_seconds)
+    : line((size_t)(AUDIO_RATE * delay_seconds), 0)
+{
+}
+
+const std::vector<float>& analog_modulator::delay(const std::vector<float>& audio)
+{
+    line.insert(line.end(), audio.begin(), audio.end());
+    delayed.assign(line.begin(), line.begin() + audio.size());
+    line.erase(line.begin(), line.begin() + audio.size());
+    return delayed;
+}
+
+/*
+ * The pre-emphasis filter is the bilinear transform of (1 + s * tau) / (1 + s * tau_h),
+ * where the high-frequency corner sits just below the audio Nyquist frequency, as in
+ * fm_preemph. The audio is then interpolated by 135/8 to the OFDM sample rate.
+ */
+fm_analog_modulator::fm_analog_modulator()
+    : analog_modulator(FM_DELAY),
+      x1(0),
+      y1(0),
+      sensitivity(2 * M_PI * FM_DEVIATION / FM_SAMPLE_RATE),
+      phase(0),
+      resampler(135, 8, gr::nrsc5::design_resampler_taps(135, 8))
+{
+    double k = 2 * AUDIO_RATE;
+    double tau_h = 1 / (2 * M_PI * 0.925 * AUDIO_RATE / 2);
+    b0 = (1 + FM_TAU * k) / (1 + tau_h * k);
+    b1 = (1 - FM_TAU * k) / (1 + tau_h * k);
+    a1 = (1 - tau_h * k) / (1 + tau_h * k);
+}
+
+void fm_analog_modulator::modulate(const std::vector<float>& audio,
+                                   std::vector<gr_complex>& out)
+{
+    const std::vector<float>& in = delay(audio);
+
+    emphasized.resize(in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        float y = b0 * in[i] + b1 * x1 - a1 * y1;
+        x1 = in[i];
+        y1 = y;
+        emphasized[i] = y;
+    }
+
+    resampled.clear();
+    resampler.process(emphasized.data(), emphasized.size(), resampled);
+
+    for (float sample : resampled) {
+        phase = std::fmod(phase + sensitivity * sample, 2 * M_PI);
+        out.push_back(std::polar(1.0f, (float)phase));
+    }
+}
+
+/* The audio is low-pass filtered at 44.1 kHz, then interpolated by 135/128 */
+am_analog_modulator::am_analog_modulator()
+    : analog_modulator(AM_DELAY),
+      low_pass(1, 1, gr::nrsc5::design_low_pass(1, AUDIO_RATE, 4500, 1000)),
+      resampler(135, 128, gr::nrsc5::design_resampler_taps(135, 128))
+{
+}
+
+void am_analog_modulator::modulate(const std::vector<float>& audio,
+                                   std::vector<gr_complex>& out)
+{
+    const std::vector<float>& in = delay(audio);
+
+    filtered.clear();
+    low_pass.process(in.data(), in.size(), filtered);
+    resampled.clear();
+    resampler.process(filtered.data(), filtered.size(), resampled);
+
+    // the unmodulated carrier has an amplitude of 1
+    for (float sample : resampled) {
+        out.push_back(1.0f + sample);
+    }
+}
+
+} // namespace render
@@ -0,0 +1,80 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_RENDER_ANALOG_H
+#define INCLUDED_NRSC5_RENDER_ANALOG_H
+
+#include <nrsc5/core/rational_resampler.h>
+#include <vector>
+
+namespace render {
+
+using gr::nrsc5::gr_complex;
+
+/*
+ * The analog half of a hybrid signal, from 44.1 kHz mono audio to complex baseband
+ * at the OFDM sample rate. The audio is held back by the diversity delay, as in the
+ * hd_tx_* flowgraphs, so that it lines up with the digital audio at the receiver.
+ */
+class analog_modulator
+{
+public:
+    virtual ~analog_modulator() = default;
+
+    /* Modulates a block of audio, appending the baseband samples to out */
+    virtual void modulate(const std::vector<float>& audio,
+                          std::vector<gr_complex>& out) = 0;
+
+protected:
+    analog_modulator(double delay_seconds);
+
+    /* Returns the audio that leaves the delay line as this block goes in */
+    const std::vector<float>& delay(const std::vector<float>& audio);
+
+private:
+    std::vector<float> line;
+    std::vector<float> delayed;
+};
+
+/* FM with 75 us pre-emphasis and 75 kHz deviation, at 744187.5 samples per second */
+class fm_analog_modulator : public analog_modulator
+{
+public:
+    fm_analog_modulator();
+
+    void modulate(const std::vector<float>& audio,
+                  std::vector<gr_complex>& out) override;
+
+private:
+    float b0, b1, a1;
+    float x1, y1;
+    double sensitivity;
+    double phase;
+    gr::nrsc5::rational_resampler<float> resampler;
+    std::vector<float> emphasized;
+    std::vector<float> resampled;
+};
+
+/* AM limited to 4.5 kHz of audio bandwidth, at 46511.71875 samples per second */
+class am_analog_modulator : public analog_modulator
+{
+public:
+    am_analog_modulator();
+
+    void modulate(const std::vector<float>& audio,
+                  std::vector<gr_complex>& out) override;
+
+private:
+    gr::nrsc5::rational_resampler<float> low_pass;
+    gr::nrsc5::rational_resampler<float> resampler;
+    std::vector<float> filtered;
+    std::vector<float> resampled;
+};
+
+} // namespace render
+
+#endif /* INCLUDED_NRSC5_RENDER_ANALOG_H */
@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "render_collector.h"
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+
+namespace render {
+
+namespace {
+
+std::vector<int> input_sizes(const gr::nrsc5::l1_channel& audio_channel,
+                             const gr::nrsc5::l1_channel& pids_channel,
+                             int audio_channels)
+{
+    std::vector<int> sizes = { audio_channel.bits, pids_channel.bits };
+    sizes.resize(2 + audio_channels, sizeof(float));
+    return sizes;
+}
+
+} // namespace
+
+frame_collector::frame_collector(const gr::nrsc5::l1_channel& audio_channel,
+                                 const gr::nrsc5::l1_channel& pids_channel,
+                                 int audio_channels,
+                                 uint64_t total_frames,
+                                 queue<frame>& frames,
+                                 queue<std::vector<float>>* audio)
+    : gr::block("frame_collector",
+                gr::io_signature::makev(
+                    2 + audio_channels,
+                    2 + audio_channels,
+                    input_sizes(audio_channel, pids_channel, audio_channels)),
+                gr::io_signature::make(0, 0, 0)),
+      audio_channels(audio_channels),
+      total_frames(total_frames),
+      collected(0),
+      frames(frames),
+      audio(audio)
+{
+    items_per_frame = { audio_channel.pdus_per_frame, pids_channel.pdus_per_frame };
+    items_per_frame.resize(2 + audio_channels, AUDIO_PER_FRAME);
+    bits_len = audio_channel.bits * audio_channel.pdus_per_frame;
+    pids_len = pids_channel.bits * pids_channel.pdus_per_frame;
+
+    message_port_register_out(pmt::intern("clock"));
+}
+
+void frame_collector::forecast(int noutput_items, gr_vector_int& ninput_items_required)
+{
+    for (size_t port = 0; port < items_per_frame.size(); port++) {
+        ninput_items_required[port] = items_per_frame[port];
+    }
+}
+
+int frame_collector::general_work(int noutput_items,
+                                  gr_vector_int& ninput_items,
+                                  gr_vector_const_void_star& input_items,
+                                  gr_vector_void_star& output_items)
+{
+    uint64_t available = total_frames - collected;
+    for (size_t port = 0; port < items_per_frame.size(); port++) {
+        uint64_t frames_in = ninput_items[port] / items_per_frame[port];
+        available = std::min(available, frames_in);
+    }
+    int nframes = available;
+
+    auto bits = static_cast<const unsigned char*>(input_items[0]);
+    auto pids = static_cast<const unsigned char*>(input_items[1]);
+
+    for (int f = 0; f < nframes; f++) {
+        frame fr;
+        fr.audio_channel.assign(bits + f * bits_len, bits + (f + 1) * bits_len);
+        fr.pids.assign(pids + f * pids_len, pids + (f + 1) * pids_len);
+
+        // the analog audio is mixed down to mono
+        std::vector<float> mono;
+        if (audio_channels > 0) {
+            mono.assign(AUDIO_PER_FRAME, 0);
+            for (int c = 0; c < audio_channels; c++) {
+                auto in = static_cast<const float*>(input_items[2 + c]) +
+                          f * AUDIO_PER_FRAME;
+                for (int i = 0; i < AUDIO_PER_FRAME; i++) {
+                    mono[i] += in[i] / audio_channels;
+                }
+            }
+        }
+
+        if (!frames.push(std::move(fr)) || (audio && !audio->push(std::move(mono)))) {
+            return WORK_DONE;
+        }
+
+        collected++;
+        message_port_pub(pmt::intern("clock"), pmt::from_long(collected));
+    }
+
+    for (size_t port = 0; port < items_per_frame.size(); port++) {
+        consume(port, nframes * items_per_frame[port]);
+    }
+
+    if (collected == total_frames) {
+        frames.close();
+        if (audio) {
+            audio->close();
+        }
+        return WORK_DONE;
+    }
+    return 0;
+}
+
+} // namespace render
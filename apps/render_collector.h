@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_RENDER_COLLECTOR_H
+#define INCLUDED_NRSC5_RENDER_COLLECTOR_H
+
+#include "render_queue.h"
+#include <gnuradio/block.h>
+#include <nrsc5/core/l1_channel.h>
+#include <vector>
+
+namespace render {
+
+/* Audio samples per L1 frame, at 44.1 kHz */
+constexpr int AUDIO_PER_FRAME = 65536;
+
+/* Layer 1 input for one frame: the first logical channel and PIDS */
+struct frame {
+    std::vector<unsigned char> audio_channel;
+    std::vector<unsigned char> pids;
+};
+
+/*
+ * Hands frames from the GNU Radio part of the renderer to the pipeline threads.
+ * Takes the first logical channel and PIDS (and, for hybrid output, one or two
+ * channels of analog audio) and publishes "clock" messages as a Layer 1 encoder
+ * would. Stops after the given number of frames, closing its output queues.
+ */
+class frame_collector : public gr::block
+{
+private:
+    std::vector<int> items_per_frame;
+    int bits_len;
+    int pids_len;
+    int audio_channels;
+    uint64_t total_frames;
+    uint64_t collected;
+    queue<frame>& frames;
+    queue<std::vector<float>>* audio;
+
+public:
+    typedef std::shared_ptr<frame_collector> sptr;
+
+    frame_collector(const gr::nrsc5::l1_channel& audio_channel,
+                    const gr::nrsc5::l1_channel& pids_channel,
+                    int audio_channels,
+                    uint64_t total_frames,
+                    queue<frame>& frames,
+                    queue<std::vector<float>>* audio);
+
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required) override;
+
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items) override;
+};
+
+} // namespace render
+
+#endif /* INCLUDED_NRSC5_RENDER_COLLECTOR_H */
@@ -0,0 +1,74 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_RENDER_QUEUE_H
+#define INCLUDED_NRSC5_RENDER_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace render {
+
+/*
+ * Bounded FIFO between two pipeline stages. The producer blocks while the queue is
+ * full, which limits how far ahead of the slowest stage the others can run.
+ */
+template <class T>
+class queue
+{
+public:
+    queue(size_t capacity) : capacity(capacity), closed(false) {}
+
+    /* Returns false if the queue was closed, in which case the item is dropped */
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this] { return closed || (items.size() < capacity); });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    /* Returns false once the queue is closed and empty */
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    /* Wakes both sides. Items already queued can still be popped. */
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+
+private:
+    size_t capacity;
+    bool closed;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+};
+
+} // namespace render
+
+#endif /* INCLUDED_NRSC5_RENDER_QUEUE_H */
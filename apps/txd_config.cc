@@ -0,0 +1,382 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "txd_config.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace txd {
+
+namespace {
+
+using gr::nrsc5::program_type;
+
+const std::map<std::string, program_type> PROGRAM_TYPES = {
+    { "undefined", program_type::UNDEFINED },
+    { "news", program_type::NEWS },
+    { "information", program_type::INFORMATION },
+    { "sports", program_type::SPORTS },
+    { "talk", program_type::TALK },
+    { "rock", program_type::ROCK },
+    { "classic_rock", program_type::CLASSIC_ROCK },
+    { "adult_hits", program_type::ADULT_HITS },
+    { "soft_rock", program_type::SOFT_ROCK },
+    { "top_40", program_type::TOP_40 },
+    { "country", program_type::COUNTRY },
+    { "oldies", program_type::OLDIES },
+    { "soft", program_type::SOFT },
+    { "nostalgia", program_type::NOSTALGIA },
+    { "jazz", program_type::JAZZ },
+    { "classical", program_type::CLASSICAL },
+    { "rhythm_and_blues", program_type::RHYTHM_AND_BLUES },
+    { "soft_rhythm_and_blues", program_type::SOFT_RHYTHM_AND_BLUES },
+    { "foreign_language", program_type::FOREIGN_LANGUAGE },
+    { "religious_music", program_type::RELIGIOUS_MUSIC },
+    { "religious_talk", program_type::RELIGIOUS_TALK },
+    { "personality", program_type::PERSONALITY },
+    { "public", program_type::PUBLIC },
+    { "college", program_type::COLLEGE },
+    { "spanish_talk", program_type::SPANISH_TALK },
+    { "spanish_music", program_type::SPANISH_MUSIC },
+    { "hip_hop", program_type::HIP_HOP },
+    { "weather", program_type::WEATHER },
+    { "emergency_test", program_type::EMERGENCY_TEST },
+    { "emergency", program_type::EMERGENCY },
+    { "traffic", program_type::TRAFFIC },
+    { "special_reading_services", program_type::SPECIAL_READING_SERVICES },
+};
+
+std::string trim(const std::string& s)
+{
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+std::string lower(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) {
+        return std::tolower(c);
+    });
+    return s;
+}
+
+int parse_int(const std::string& value)
+{
+    size_t pos;
+    int result = std::stoi(value, &pos, 0);
+    if (pos != value.size()) {
+        throw std::invalid_argument(value);
+    }
+    return result;
+}
+
+bool parse_bool(const std::string& value)
+{
+    std::string v = lower(value);
+    if ((v == "true") || (v == "yes") || (v == "1")) {
+        return true;
+    }
+    if ((v == "false") || (v == "no") || (v == "0")) {
+        return false;
+    }
+    throw std::invalid_argument(value);
+}
+
+double parse_double(const std::string& value)
+{
+    size_t pos;
+    double result = std::stod(value, &pos);
+    if (pos != value.size()) {
+        throw std::invalid_argument(value);
+    }
+    return result;
+}
+
+std::vector<int> parse_cpus(const std::string& value)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t dash = item.find('-');
+        if (dash == std::string::npos) {
+            cpus.push_back(parse_int(trim(item)));
+        } else {
+            int first = parse_int(trim(item.substr(0, dash)));
+            int last = parse_int(trim(item.substr(dash + 1)));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+/* "<port> <lot_id> <path>", where the path may contain spaces */
+lot_file parse_lot_file(const std::string& value)
+{
+    std::stringstream ss(value);
+    std::string port, lot_id;
+    ss >> port >> lot_id;
+
+    lot_file file;
+    file.port = parse_int(port);
+    file.lot_id = parse_int(lot_id);
+    std::getline(ss, file.path);
+    file.path = trim(file.path);
+    if (file.path.empty()) {
+        throw std::runtime_error("expected file = <port> <lot_id> <path>");
+    }
+    return file;
+}
+
+program_type parse_program_type(const std::string& value)
+{
+    auto it = PROGRAM_TYPES.find(lower(value));
+    if (it != PROGRAM_TYPES.end()) {
+        return it->second;
+    }
+    return static_cast<program_type>(parse_int(value));
+}
+
+void set_station(config& cfg, const std::string& key, const std::string& value)
+{
+    if (key == "band") {
+        if (lower(value) == "fm") {
+            cfg.band = gr::nrsc5::pids_mode::FM;
+        } else if (lower(value) == "am") {
+            cfg.band = gr::nrsc5::pids_mode::AM;
+        } else {
+            throw std::runtime_error("band must be fm or am");
+        }
+    } else if (key == "service_mode") {
+        cfg.service_mode = parse_int(value);
+    } else if (key == "short_name") {
+        cfg.short_name = value;
+    } else if (key == "slogan") {
+        cfg.slogan = value;
+    } else if (key == "message") {
+        cfg.message = value;
+    } else if (key == "latitude") {
+        cfg.latitude = parse_double(value);
+    } else if (key == "longitude") {
+        cfg.longitude = parse_double(value);
+    } else if (key == "altitude") {
+        cfg.altitude = parse_double(value);
+    } else if (key == "country_code") {
+        cfg.country_code = value;
+    } else if (key == "fcc_facility_id") {
+        cfg.fcc_facility_id = parse_int(value);
+    } else if (key == "lsb_power_db") {
+        cfg.lsb_power_db = parse_double(value);
+    } else if (key == "usb_power_db") {
+        cfg.usb_power_db = parse_double(value);
+    } else if (key == "analog") {
+        cfg.analog = parse_bool(value);
+    } else {
+        throw std::runtime_error("unknown key " + key);
+    }
+}
+
+void set_program(program_config& prog, const std::string& key, const std::string& value)
+{
+    if (key == "name") {
+        prog.name = value;
+    } else if (key == "type") {
+        prog.type = parse_program_type(value);
+    } else if (key == "audio") {
+        prog.audio = value;
+    } else if (key == "bitrate") {
+        prog.bitrate = parse_int(value);
+    } else if (key == "title") {
+        prog.title = value;
+    } else if (key == "artist") {
+        prog.artist = value;
+    } else {
+        throw std::runtime_error("unknown key " + key);
+    }
+}
+
+void set_lot(config& cfg, const std::string& key, const std::string& value)
+{
+    if (key == "spool") {
+        cfg.lot_spool = value;
+    } else if (key == "port") {
+        cfg.lot_port = parse_int(value);
+    } else if (key == "data_bytes") {
+        cfg.data_bytes = parse_int(value);
+    } else if (key == "file") {
+        cfg.lot_files.push_back(parse_lot_file(value));
+    } else {
+        throw std::runtime_error("unknown key " + key);
+    }
+}
+
+void set_output(config& cfg, const std::string& key, const std::string& value)
+{
+    if (key == "sink") {
+        if (lower(value) == "file") {
+            cfg.sink = sink_type::FILE;
+        } else if (lower(value) == "stdout") {
+            cfg.sink = sink_type::STDOUT;
+        } else if (lower(value) == "fifo") {
+            cfg.sink = sink_type::FIFO;
+        } else {
+            throw std::runtime_error("sink must be file, stdout or fifo");
+        }
+    } else if (key == "path") {
+        cfg.path = value;
+    } else if (key == "format") {
+        if (lower(value) == "cf32") {
+            cfg.format = sample_format::CF32;
+        } else if (lower(value) == "cs16") {
+            cfg.format = sample_format::CS16;
+        } else if (lower(value) == "cs8") {
+            cfg.format = sample_format::CS8;
+        } else if (lower(value) == "cu8") {
+            cfg.format = sample_format::CU8;
+        } else {
+            throw std::runtime_error("format must be cf32, cs16, cs8 or cu8");
+        }
+    } else if (key == "gain") {
+        cfg.gain = parse_double(value);
+    } else if (key == "duration") {
+        cfg.duration = parse_double(value);
+    } else if (key == "sample_rate") {
+        cfg.sample_rate = parse_double(value);
+    } else if (key == "fixed_point") {
+        cfg.fixed_point = parse_bool(value);
+    } else {
+        throw std::runtime_error("unknown key " + key);
+    }
+}
+
+void set_realtime(config& cfg, const std::string& key, const std::string& value)
+{
+    if (key == "priority") {
+        cfg.priority = parse_int(value);
+    } else if (key == "cpus") {
+        cfg.cpus = parse_cpus(value);
+    } else if (key == "report_interval") {
+        cfg.report_interval = parse_double(value);
+    } else {
+        throw std::runtime_error("unknown key " + key);
+    }
+}
+
+void validate(config& cfg)
+{
+    if (cfg.programs.empty()) {
+        cfg.programs.emplace_back();
+    }
+    if (cfg.programs.size() > 8) {
+        throw std::runtime_error("at most 8 programs are supported");
+    }
+    for (size_t p = 0; p < cfg.programs.size(); p++) {
+        program_config& prog = cfg.programs[p];
+        if (prog.audio.empty()) {
+            throw std::runtime_error("program " + std::to_string(p) + " has no audio");
+        }
+        if (prog.bitrate == 0) {
+            prog.bitrate = (cfg.band == gr::nrsc5::pids_mode::FM) ? 64000 : 17900;
+        }
+    }
+    if ((!cfg.lot_spool.empty() || !cfg.lot_files.empty()) && (cfg.data_bytes <= 0)) {
+        throw std::runtime_error("LOT files need data_bytes to be set");
+    }
+    if (cfg.sample_rate < 0) {
+        throw std::runtime_error("sample_rate must not be negative");
+    }
+    if ((cfg.sink != sink_type::STDOUT) && cfg.path.empty()) {
+        throw std::runtime_error("file and fifo sinks need a path");
+    }
+    if ((cfg.priority < 0) || (cfg.priority > 99)) {
+        throw std::runtime_error("priority must be between 0 and 99");
+    }
+    if (cfg.report_interval <= 0) {
+        throw std::runtime_error("report_interval must be positive");
+    }
+}
+
+} // namespace
+
+config load_config(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file) {
+        throw std::runtime_error("cannot open " + filename);
+    }
+
+    config cfg;
+    std::string section;
+    std::string line;
+    int line_num = 0;
+    while (std::getline(file, line)) {
+        line_num++;
+        std::string where = filename + ":" + std::to_string(line_num) + ": ";
+
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line = line.substr(0, comment);
+        }
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+
+        if ((line.front() == '[') && (line.back() == ']')) {
+            section = lower(trim(line.substr(1, line.size() - 2)));
+            if (section == "program") {
+                cfg.programs.emplace_back();
+            } else if ((section != "station") && (section != "lot") &&
+                       (section != "output") && (section != "realtime")) {
+                throw std::runtime_error(where + "unknown section " + section);
+            }
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error(where + "expected key = value");
+        }
+        std::string key = lower(trim(line.substr(0, equals)));
+        std::string value = trim(line.substr(equals + 1));
+
+        try {
+            if (section == "station") {
+                set_station(cfg, key, value);
+            } else if (section == "program") {
+                set_program(cfg.programs.back(), key, value);
+            } else if (section == "lot") {
+                set_lot(cfg, key, value);
+            } else if (section == "output") {
+                set_output(cfg, key, value);
+            } else if (section == "realtime") {
+                set_realtime(cfg, key, value);
+            } else {
+                throw std::runtime_error("key outside of a section");
+            }
+        } catch (const std::logic_error&) {
+            throw std::runtime_error(where + "invalid value for " + key);
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error(where + e.what());
+        }
+    }
+
+    validate(cfg);
+    return cfg;
+}
+
+} // namespace txd
@@ -0,0 +1,84 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_TXD_CONFIG_H
+#define INCLUDED_NRSC5_TXD_CONFIG_H
+
+#include <nrsc5/sis_encoder.h>
+#include <string>
+#include <vector>
+
+namespace txd {
+
+enum class sink_type { FILE, STDOUT, FIFO };
+
+/* Interleaved I/Q sample formats. Full scale corresponds to an amplitude of 1.0
+ * after the output gain is applied. */
+enum class sample_format { CF32, CS16, CS8, CU8 };
+
+struct program_config {
+    std::string name = "HD1";
+    gr::nrsc5::program_type type = gr::nrsc5::program_type::UNDEFINED;
+    std::string audio; // WAV file, or a pre-encoded ADTS file
+    int bitrate = 0;   // 0 selects the default for the band
+    std::string title;
+    std::string artist;
+};
+
+/* A file sent with lot_encoder, from a "file" line in [lot] */
+struct lot_file {
+    int port;
+    int lot_id;
+    std::string path;
+};
+
+struct config {
+    /* [station] */
+    gr::nrsc5::pids_mode band = gr::nrsc5::pids_mode::FM;
+    int service_mode = 1;
+    std::string short_name = "ABCD";
+    std::string slogan;
+    std::string message;
+    float latitude = 40.6892;
+    float longitude = -74.0445;
+    float altitude = 93.0;
+    std::string country_code = "US";
+    unsigned int fcc_facility_id = 0;
+    double lsb_power_db = -13;
+    double usb_power_db = -13;
+    bool analog = false; // hybrid: add the analog signal, carrying the first program
+
+    /* [program], one section per program */
+    std::vector<program_config> programs;
+
+    /* [lot] */
+    std::string lot_spool;
+    int lot_port = 0x1001;
+    int data_bytes = 0;
+    std::vector<lot_file> lot_files;
+
+    /* [output] */
+    sink_type sink = sink_type::STDOUT;
+    std::string path;
+    sample_format format = sample_format::CF32;
+    double gain = 1.0;
+    double duration = 0;      // seconds, 0 to run until stopped
+    double sample_rate = 0;   // Hz, 0 for the native OFDM sample rate
+    bool fixed_point = false; // int16 Layer 1 and OFDM, for cs16 output
+
+    /* [realtime] */
+    int priority = 0; // SCHED_FIFO priority, 0 to leave the default policy
+    std::vector<int> cpus;
+    double report_interval = 1.0;
+};
+
+/* Reads and validates a configuration file, throwing std::runtime_error on error */
+config load_config(const std::string& filename);
+
+} // namespace txd
+
+#endif /* INCLUDED_NRSC5_TXD_CONFIG_H */
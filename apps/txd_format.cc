@@ -0,0 +1,50 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "txd_format.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+
+namespace txd {
+
+void convert_samples(const gr_complex* in,
+                     int nitems,
+                     sample_format format,
+                     float gain,
+                     std::vector<char>& out)
+{
+    const float* samples = reinterpret_cast<const float*>(in);
+    unsigned int n = nitems * 2;
+
+    switch (format) {
+    case sample_format::CF32:
+        out.resize(n * sizeof(float));
+        volk_32f_s32f_multiply_32f(
+            reinterpret_cast<float*>(out.data()), samples, gain, n);
+        break;
+    case sample_format::CS16:
+        out.resize(n * sizeof(int16_t));
+        volk_32f_s32f_convert_16i(
+            reinterpret_cast<int16_t*>(out.data()), samples, gain * 32767.0f, n);
+        break;
+    case sample_format::CS8:
+        out.resize(n * sizeof(int8_t));
+        volk_32f_s32f_convert_8i(
+            reinterpret_cast<int8_t*>(out.data()), samples, gain * 127.0f, n);
+        break;
+    case sample_format::CU8:
+        out.resize(n);
+        for (unsigned int i = 0; i < n; i++) {
+            float value = std::round(samples[i] * gain * 127.5f + 127.5f);
+            out[i] = (char)(unsigned char)std::min(std::max(value, 0.0f), 255.0f);
+        }
+        break;
+    }
+}
+
+} // namespace txd
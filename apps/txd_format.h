@@ -0,0 +1,26 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_TXD_FORMAT_H
+#define INCLUDED_NRSC5_TXD_FORMAT_H
+
+#include "txd_config.h"
+#include <gnuradio/gr_complex.h>
+#include <vector>
+
+namespace txd {
+
+/* Converts nitems complex samples, scaled by gain, to the given format in out */
+void convert_samples(const gr_complex* in,
+                     int nitems,
+                     sample_format format,
+                     float gain,
+                     std::vector<char>& out);
+
+} // namespace txd
+
+#endif /* INCLUDED_NRSC5_TXD_FORMAT_H */
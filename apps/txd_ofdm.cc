@@ -0,0 +1,37 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "txd_ofdm.h"
+#include <gnuradio/io_signature.h>
+
+namespace txd {
+
+using gr::nrsc5::fm_ofdm_modulator;
+
+fm_modulator::fm_modulator(double lsb_power_db, double usb_power_db)
+    : gr::sync_interpolator(
+          "fm_modulator",
+          gr::io_signature::make(1, 1, sizeof(gr_complex) * fm_ofdm_modulator::FFT_SIZE),
+          gr::io_signature::make(1, 1, sizeof(gr_complex)),
+          fm_ofdm_modulator::SYMBOL_SIZE),
+      modulator(lsb_power_db, usb_power_db)
+{
+}
+
+int fm_modulator::work(int noutput_items,
+                       gr_vector_const_void_star& input_items,
+                       gr_vector_void_star& output_items)
+{
+    auto in = static_cast<const gr_complex*>(input_items[0]);
+    auto out = static_cast<gr_complex*>(output_items[0]);
+
+    int nsymbols = noutput_items / fm_ofdm_modulator::SYMBOL_SIZE;
+    modulator.modulate(in, out, nsymbols);
+    return nsymbols * fm_ofdm_modulator::SYMBOL_SIZE;
+}
+
+} // namespace txd
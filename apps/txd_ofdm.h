@@ -0,0 +1,39 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_TXD_OFDM_H
+#define INCLUDED_NRSC5_TXD_OFDM_H
+
+#include <gnuradio/sync_interpolator.h>
+#include <nrsc5/core/ofdm_modulator.h>
+
+namespace txd {
+
+/*
+ * FM OFDM stage: takes OFDM symbols of fm_ofdm_modulator::FFT_SIZE subcarriers from
+ * l1_fm_encoder and produces complex baseband at 744187.5 samples per second, using
+ * the modulator from the core library.
+ */
+class fm_modulator : public gr::sync_interpolator
+{
+private:
+    gr::nrsc5::fm_ofdm_modulator modulator;
+
+public:
+    typedef std::shared_ptr<fm_modulator> sptr;
+
+    /* Sideband levels are in dB relative to an unmodulated analog carrier */
+    fm_modulator(double lsb_power_db, double usb_power_db);
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace txd
+
+#endif /* INCLUDED_NRSC5_TXD_OFDM_H */
@@ -0,0 +1,136 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "txd_format.h"
+#include "txd_sink.h"
+#include <gnuradio/io_signature.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace txd {
+
+output_sink::output_sink(sink_type type,
+                         const std::string& path,
+                         sample_format format,
+                         float gain)
+    : gr::sync_block("output_sink",
+                     gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                     gr::io_signature::make(0, 0, 0))
+{
+    this->type = type;
+    this->path = path;
+    this->format = format;
+    this->gain = gain;
+    fd = -1;
+    items_written = 0;
+    write_nanoseconds = 0;
+
+    if (type == sink_type::FIFO) {
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            if (!S_ISFIFO(st.st_mode)) {
+                throw std::runtime_error(path + " exists and is not a FIFO");
+            }
+        } else if (mkfifo(path.c_str(), 0644) != 0) {
+            throw std::runtime_error("cannot create FIFO " + path + ": " +
+                                     strerror(errno));
+        }
+    }
+}
+
+output_sink::~output_sink() { close_output(); }
+
+void output_sink::open_output()
+{
+    switch (type) {
+    case sink_type::STDOUT:
+        fd = STDOUT_FILENO;
+        break;
+    case sink_type::FILE:
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        break;
+    case sink_type::FIFO:
+        d_logger->info("Waiting for a reader on " + path);
+        fd = open(path.c_str(), O_WRONLY);
+        break;
+    }
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + ": " + strerror(errno));
+    }
+}
+
+void output_sink::close_output()
+{
+    if ((fd >= 0) && (fd != STDOUT_FILENO)) {
+        close(fd);
+    }
+    fd = -1;
+}
+
+bool output_sink::start()
+{
+    open_output();
+    return true;
+}
+
+bool output_sink::stop()
+{
+    close_output();
+    return true;
+}
+
+bool output_sink::write_all(const char* data, size_t len)
+{
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EPIPE) && (type == sink_type::FIFO)) {
+                d_logger->warn("Reader closed " + path);
+                close_output();
+                open_output();
+                return true;
+            }
+            d_logger->error("Write to " + (path.empty() ? "stdout" : path) +
+                            " failed: " + strerror(errno));
+            return false;
+        }
+        data += written;
+        len -= written;
+    }
+    return true;
+}
+
+int output_sink::work(int noutput_items,
+                      gr_vector_const_void_star& input_items,
+                      gr_vector_void_star& output_items)
+{
+    auto in = static_cast<const gr_complex*>(input_items[0]);
+
+    convert_samples(in, noutput_items, format, gain, buf);
+
+    auto begin = std::chrono::steady_clock::now();
+    bool ok = write_all(buf.data(), buf.size());
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    write_nanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    if (!ok) {
+        return WORK_DONE;
+    }
+    items_written += noutput_items;
+    return noutput_items;
+}
+
+} // namespace txd
@@ -0,0 +1,65 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_TXD_SINK_H
+#define INCLUDED_NRSC5_TXD_SINK_H
+
+#include "txd_config.h"
+#include <gnuradio/sync_block.h>
+#include <atomic>
+#include <vector>
+
+namespace txd {
+
+/*
+ * Writes complex baseband to a file, stdout or a FIFO in one of the interleaved I/Q
+ * formats, and keeps the counters used for real-time reporting. When the reader of a
+ * FIFO goes away, the FIFO is reopened and the sink waits for the next reader.
+ */
+class output_sink : public gr::sync_block
+{
+private:
+    sink_type type;
+    std::string path;
+    sample_format format;
+    float gain;
+    int fd;
+    std::vector<char> buf;
+
+    std::atomic<uint64_t> items_written;
+    std::atomic<uint64_t> write_nanoseconds;
+
+    void open_output();
+    void close_output();
+    bool write_all(const char* data, size_t len);
+
+public:
+    typedef std::shared_ptr<output_sink> sptr;
+
+    output_sink(sink_type type,
+                const std::string& path,
+                sample_format format,
+                float gain);
+    ~output_sink();
+
+    /* Total samples written */
+    uint64_t items() const { return items_written; }
+
+    /* Total time spent blocked writing, i.e. waiting for the consumer */
+    uint64_t blocked_ns() const { return write_nanoseconds; }
+
+    bool start() override;
+    bool stop() override;
+
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace txd
+
+#endif /* INCLUDED_NRSC5_TXD_SINK_H */
@@ -0,0 +1,109 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "txd_upstream.h"
+#include <nrsc5/adts_file_source.h>
+#include <nrsc5/hdc_encoder.h>
+#include <nrsc5/lot_encoder.h>
+#include <algorithm>
+#include <cctype>
+
+namespace txd {
+
+namespace {
+
+using namespace gr::nrsc5;
+
+bool is_wav(const std::string& filename)
+{
+    std::string ext = filename.substr(filename.find_last_of('.') + 1);
+    for (char& c : ext) {
+        c = std::tolower((unsigned char)c);
+    }
+    return ext == "wav";
+}
+
+/* Audio program sources: a WAV file through hdc_encoder, or a pre-encoded ADTS file */
+gr::block_sptr audio_source(gr::top_block_sptr tb,
+                            upstream& up,
+                            const program_config& prog,
+                            bool fm)
+{
+    if (!is_wav(prog.audio)) {
+        return adts_file_source::make(prog.audio, false, true);
+    }
+
+    auto wav = gr::blocks::wavfile_source::make(prog.audio.c_str(), true);
+    int channels = std::min(wav->channels(), fm ? 2 : 1);
+    auto hdc = hdc_encoder::make(channels, prog.bitrate);
+    for (int c = 0; c < channels; c++) {
+        tb->connect(wav, c, hdc, c);
+    }
+    if (up.audio_encoders.empty()) {
+        up.first_wav = wav;
+    }
+    return hdc;
+}
+
+} // namespace
+
+upstream build_upstream(gr::top_block_sptr tb,
+                        const config& cfg,
+                        const std::vector<l1_channel>& channels)
+{
+    upstream up;
+    bool fm = (cfg.band == pids_mode::FM);
+    int num_progs = cfg.programs.size();
+
+    const l1_channel& audio_channel = channels[0];
+    int psd_bytes = (audio_channel.bits >= 24000) ? 128 : 8;
+    up.l2 = l2_encoder::make(num_progs, 0, audio_channel.bits, cfg.data_bytes);
+
+    std::vector<std::string> names, titles, artists;
+    std::vector<program_type> types;
+    for (const program_config& prog : cfg.programs) {
+        names.push_back(prog.name);
+        types.push_back(prog.type);
+        titles.push_back(prog.title);
+        artists.push_back(prog.artist);
+    }
+    up.psd = psd_multi_encoder::make(
+        num_progs, 0, titles, artists, psd_bytes * audio_channel.pdus_per_frame);
+
+    for (int p = 0; p < num_progs; p++) {
+        gr::block_sptr audio = audio_source(tb, up, cfg.programs[p], fm);
+        up.audio_encoders.push_back(audio);
+        tb->connect(audio, 0, up.l2, p);
+        tb->connect(up.psd, p, up.l2, num_progs + p);
+    }
+
+    up.sis = sis_encoder::make(cfg.band,
+                               cfg.short_name,
+                               cfg.slogan,
+                               cfg.message,
+                               names,
+                               types,
+                               {},
+                               {},
+                               cfg.latitude,
+                               cfg.longitude,
+                               cfg.altitude,
+                               cfg.country_code,
+                               cfg.fcc_facility_id);
+    tb->msg_connect(up.l2, "ready", up.sis, "ready");
+    tb->msg_connect(up.sis, "aas", up.l2, "aas");
+
+    for (const lot_file& file : cfg.lot_files) {
+        auto lot = lot_encoder::make(file.path, file.lot_id, file.port);
+        tb->msg_connect(up.l2, "ready", lot, "ready");
+        tb->msg_connect(lot, "aas", up.l2, "aas");
+        up.lot_ports.push_back(file.port);
+    }
+    return up;
+}
+
+} // namespace txd
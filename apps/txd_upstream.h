@@ -0,0 +1,44 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_TXD_UPSTREAM_H
+#define INCLUDED_NRSC5_TXD_UPSTREAM_H
+
+#include "txd_config.h"
+#include <gnuradio/blocks/wavfile_source.h>
+#include <gnuradio/top_block.h>
+#include <nrsc5/core/l1_channel.h>
+#include <nrsc5/l2_encoder.h>
+#include <nrsc5/psd_multi_encoder.h>
+#include <nrsc5/sis_encoder.h>
+#include <vector>
+
+namespace txd {
+
+/* The blocks feeding Layer 1: audio, PSD, Layer 2, SIS and LOT files */
+struct upstream {
+    std::vector<gr::block_sptr> audio_encoders; // hdc_encoder or adts_file_source
+    gr::blocks::wavfile_source::sptr first_wav; // audio of the first program, if WAV
+    gr::nrsc5::psd_multi_encoder::sptr psd;
+    gr::nrsc5::l2_encoder::sptr l2;
+    gr::nrsc5::sis_encoder::sptr sis;
+    std::vector<int> lot_ports; // AAS ports of the [lot] files
+};
+
+/*
+ * Builds the part of the transmitter that is common to nrsc5-txd and nrsc5-render.
+ * The caller connects l2 to the first logical channel and sis to the last one, and
+ * sends clock messages to psd and sis. All programs share the first logical channel,
+ * as in the sample flowgraphs.
+ */
+upstream build_upstream(gr::top_block_sptr tb,
+                        const config& cfg,
+                        const std::vector<gr::nrsc5::l1_channel>& channels);
+
+} // namespace txd
+
+#endif /* INCLUDED_NRSC5_TXD_UPSTREAM_H */
@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_ADTS_FILE_SOURCE_H
+#define INCLUDED_NRSC5_ADTS_FILE_SOURCE_H
+
+#include <gnuradio/sync_block.h>
+#include <nrsc5/api.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*!
+ * \brief Streams a pre-encoded HDC (ADTS) file, as recorded by hdc_encoder
+ * \ingroup nrsc5
+ *
+ * The file is memory-mapped and its frames indexed once. The output is tagged in
+ * the same way as the output of hdc_encoder, so it can feed l2_encoder directly.
+ */
+class NRSC5_API adts_file_source : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<adts_file_source> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of nrsc5::adts_file_source.
+     *
+     * To avoid accidental use of raw pointers, nrsc5::adts_file_source's
+     * constructor is in a private implementation
+     * class. nrsc5::adts_file_source::make is the public interface for
+     * creating new instances.
+     */
+    static sptr
+    make(const std::string& filename, bool realtime = true, bool repeat = true);
+
+    /*!
+     * \brief Continue from the given frame once the current frame has been output.
+     */
+    virtual void seek(uint64_t frame) = 0;
+
+    /*!
+     * \brief Number of frames in the file.
+     */
+    virtual uint64_t num_frames() const = 0;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_ADTS_FILE_SOURCE_H */
@@ -0,0 +1,97 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_CORE_L1_AM_FRAME_ENCODER_H
+#define INCLUDED_NRSC5_CORE_L1_AM_FRAME_ENCODER_H
+
+#include <nrsc5/core/l1_channel.h>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * Layer 1 AM encoder (1012s.pdf), one L1 frame at a time: scrambling, convolutional
+ * coding, interleaving and subcarrier mapping. Independent of GNU Radio, so it can be
+ * embedded in other programs; nrsc5::l1_am_encoder is a wrapper around it.
+ *
+ * The encoder state is about 1 MB, so instances should be allocated on the heap.
+ */
+class l1_am_frame_encoder
+{
+public:
+    static constexpr int BLOCKS_PER_FRAME = 8;
+    static constexpr int SYMBOLS_PER_BLOCK = 32;
+    static constexpr int SYMBOLS_PER_FRAME = BLOCKS_PER_FRAME * SYMBOLS_PER_BLOCK;
+    static constexpr int FFT_SIZE = 256;
+
+    /* Logical channels used by a service mode, in the order encode_frame expects */
+    static std::vector<l1_channel> channels(int sm);
+
+    l1_am_frame_encoder(int sm);
+    l1_am_frame_encoder(const l1_am_frame_encoder&) = delete;
+    l1_am_frame_encoder& operator=(const l1_am_frame_encoder&) = delete;
+
+    /*
+     * Encodes one frame. inputs[i] holds one frame's worth of channel i (pdus_per_frame
+     * PDUs of bits bytes each, one bit per byte), and out receives SYMBOLS_PER_FRAME
+     * OFDM symbols of FFT_SIZE subcarriers each.
+     */
+    void encode_frame(const unsigned char* const* inputs, gr_complex* out);
+
+    /* As above, with subcarriers in Q14 fixed point (L1_SC16_ONE is 1.0) */
+    void encode_frame(const unsigned char* const* inputs, sc16_t* out);
+
+private:
+    static constexpr int DIVERSITY_DELAY = 18000 * 3;
+
+    enum class conv_mode { CONV_E1, CONV_E2, CONV_E3 };
+
+    int sm;
+    int p1_bits, p1_mod;
+    int p3_bits, p3_mod;
+
+    unsigned char buf[30000];
+    unsigned char pids_g[L1_PIDS_BITS * 3];
+    unsigned char p1_g[72000];
+    unsigned char p3_g[72000];
+    unsigned char bl[18000 + DIVERSITY_DELAY], ml[18000];
+    unsigned char bu[18000 + DIVERSITY_DELAY], mu[18000];
+    unsigned char el[12000], eu[24000];
+    unsigned char ebl[18000 + DIVERSITY_DELAY], eml[18000];
+    unsigned char ebu[18000 + DIVERSITY_DELAY], emu[18000];
+    unsigned char parity[512];
+    unsigned char sc_symbols[SYMBOLS_PER_FRAME];
+    unsigned char pu_matrix[25][SYMBOLS_PER_FRAME];
+    unsigned char pl_matrix[25][SYMBOLS_PER_FRAME];
+    unsigned char s_matrix[25][SYMBOLS_PER_FRAME];
+    unsigned char t_matrix[25][SYMBOLS_PER_FRAME];
+    unsigned char pids_matrix[2][SYMBOLS_PER_FRAME];
+    float channel_power[FFT_SIZE];
+
+    void encode_bits(const unsigned char* const* inputs);
+    void map_symbol(int symbol, gr_complex* out);
+    void reverse_bytes(const unsigned char* in, unsigned char* out, int len);
+    void scramble(unsigned char* buf, int len);
+    void conv_enc(conv_mode mode, const unsigned char* in, unsigned char* out, int len);
+    void
+    encode_l2_pdu(conv_mode mode, const unsigned char* in, unsigned char* out, int len);
+    void bit_map(unsigned char matrix[25][SYMBOLS_PER_FRAME], int b, int k, int bits);
+    void interleaver_ma1();
+    void interleaver_ma3();
+    void interleaver_pids(unsigned char* in,
+                          unsigned char matrix[2][SYMBOLS_PER_FRAME],
+                          int block);
+    void sc_data_seq(
+        unsigned char* out, int pli, int hppi, int abbi, int rdbi, int bc, int smi);
+    void set_channel_power();
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_CORE_L1_AM_FRAME_ENCODER_H */
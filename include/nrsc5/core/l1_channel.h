@@ -0,0 +1,42 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_CORE_L1_CHANNEL_H
+#define INCLUDED_NRSC5_CORE_L1_CHANNEL_H
+
+#include <complex>
+#include <cstdint>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * The same type as GNU Radio's global gr_complex, which the core library does not
+ * depend on. Kept in this namespace so that programs using the core library alongside
+ * other DSP code do not get it in the global namespace.
+ */
+typedef std::complex<float> gr_complex;
+
+/* Fixed-point complex sample, as used by the int16 transmit path */
+typedef std::complex<int16_t> sc16_t;
+
+/* Size of a PIDS PDU, which carries one SIS block */
+constexpr int L1_PIDS_BITS = 80;
+
+/* Subcarrier amplitude of 1.0 in the fixed-point (Q14) output of the L1 encoders */
+constexpr int L1_SC16_ONE = 1 << 14;
+
+/* A logical channel input to Layer 1, such as P1 or PIDS */
+struct l1_channel {
+    int bits;           // size of each PDU, one bit per byte
+    int pdus_per_frame; // number of PDUs consumed per L1 frame
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_CORE_L1_CHANNEL_H */
@@ -0,0 +1,129 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_CORE_L1_FM_FRAME_ENCODER_H
+#define INCLUDED_NRSC5_CORE_L1_FM_FRAME_ENCODER_H
+
+#include <nrsc5/core/l1_channel.h>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * Layer 1 FM encoder (1011s.pdf), one L1 frame at a time: scrambling, convolutional
+ * coding, interleaving and subcarrier mapping. Independent of GNU Radio, so it can be
+ * embedded in other programs; nrsc5::l1_fm_encoder is a wrapper around it.
+ *
+ * The encoder state is about 1 MB, so instances should be allocated on the heap.
+ */
+class l1_fm_frame_encoder
+{
+public:
+    static constexpr int BLOCKS_PER_FRAME = 16;
+    static constexpr int SYMBOLS_PER_BLOCK = 32;
+    static constexpr int SYMBOLS_PER_FRAME = BLOCKS_PER_FRAME * SYMBOLS_PER_BLOCK;
+    static constexpr int FFT_SIZE = 2048;
+
+    /* Logical channels used by a service mode, in the order encode_frame expects */
+    static std::vector<l1_channel> channels(int psm);
+
+    l1_fm_frame_encoder(int psm, int ssm = 0);
+    ~l1_fm_frame_encoder();
+    l1_fm_frame_encoder(const l1_fm_frame_encoder&) = delete;
+    l1_fm_frame_encoder& operator=(const l1_fm_frame_encoder&) = delete;
+
+    /*
+     * Encodes one frame. inputs[i] holds one frame's worth of channel i (pdus_per_frame
+     * PDUs of bits bytes each, one bit per byte), and out receives SYMBOLS_PER_FRAME
+     * OFDM symbols of FFT_SIZE subcarriers each.
+     */
+    void encode_frame(const unsigned char* const* inputs, gr_complex* out);
+
+    /* As above, with subcarriers in Q14 fixed point (L1_SC16_ONE is 1.0) */
+    void encode_frame(const unsigned char* const* inputs, sc16_t* out);
+
+private:
+    static constexpr int P1_BITS = 146176;
+
+    enum class conv_mode { CONV_2_5, CONV_1_2 };
+
+    int psm;
+    int p1_bits, p1_mod;
+    int p2_bits, p2_mod;
+    int p3_bits, p3_mod;
+    int p4_bits, p4_mod;
+
+    int ssm;
+
+    unsigned char buf[P1_BITS];
+    unsigned char pids_g[L1_PIDS_BITS * 5 / 2 * BLOCKS_PER_FRAME];
+    unsigned char p1_g[P1_BITS * 5 / 2];
+    unsigned char* p3_p4_g;
+    int p1_prime_off;
+    unsigned char* p1_prime;
+    unsigned char* p1_prime_g;
+    unsigned char pm_matrix[SYMBOLS_PER_FRAME * 20 * 36];
+    unsigned char* px1_matrix;
+    unsigned char* px2_matrix;
+    unsigned char* px1_internal;
+    unsigned char* px2_internal;
+    int internal_half;
+    unsigned char parity[128];
+    unsigned char primary_sc_symbols[4][SYMBOLS_PER_FRAME];
+    unsigned char secondary_sc_symbols[4][SYMBOLS_PER_FRAME];
+
+    void encode_bits(const unsigned char* const* inputs);
+    template <class T>
+    void map_symbols(T* out);
+    void reverse_bytes(const unsigned char* in, unsigned char* out, int len);
+    void scramble(unsigned char* buf, int len);
+    void conv_enc(conv_mode mode, const unsigned char* in, unsigned char* out, int len);
+    void
+    encode_l2_pdu(conv_mode mode, const unsigned char* in, unsigned char* out, int len);
+    void interleaver_i(unsigned char* in,
+                       unsigned char* matrix,
+                       int J,
+                       int B,
+                       int C,
+                       int M,
+                       unsigned char* V,
+                       int N);
+    void interleaver_ii(unsigned char* in,
+                        unsigned char* matrix,
+                        int J,
+                        int B,
+                        int C,
+                        int M,
+                        unsigned char* V,
+                        int b,
+                        int I0,
+                        int N);
+    void interleaver_iii(unsigned char* in,
+                         unsigned char* matrix,
+                         int J,
+                         int B,
+                         int C,
+                         int M,
+                         unsigned char* V,
+                         int N);
+    void interleaver_iv(unsigned char* matrix, unsigned char* internal, int half);
+    template <class T>
+    void write_symbol(unsigned char* matrix_row,
+                      T* out_row,
+                      int* channels,
+                      int num_channels);
+    void primary_sc_data_seq(unsigned char* out, int scid, int sci, int bc, int psmi);
+    void secondary_sc_data_seq(unsigned char* out, int scid, int bc, int ssmi);
+    void differential_encode(unsigned char* buf);
+    int partitions_per_band();
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_CORE_L1_FM_FRAME_ENCODER_H */
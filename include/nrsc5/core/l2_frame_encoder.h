@@ -0,0 +1,169 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017, 2023, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_CORE_L2_FRAME_ENCODER_H
+#define INCLUDED_NRSC5_CORE_L2_FRAME_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <vector>
+
+class hdlc_framer;
+class rs_encoder;
+
+namespace gr {
+namespace nrsc5 {
+
+enum class blend { DISABLE, SELECT, ENABLE };
+
+/* A complete ADTS frame in a program's audio input */
+struct adts_frame {
+    int offset;  // position of the ADTS header within the input buffer
+    int length;  // payload length, excluding the ADTS header
+    int64_t seq; // sequence number from hdc_encoder's frame tag, or -1 if untagged
+};
+
+/* One program's input to l2_frame_encoder::encode_frame */
+struct l2_program_input {
+    const unsigned char* audio;            // ADTS audio stream
+    int audio_offset;                      // first byte not yet used
+    const std::vector<adts_frame>* frames; // complete frames in audio, by offset
+    const unsigned char* psd;              // PSD stream
+    int psd_offset;                        // first byte not yet used
+};
+
+/*
+ * Layer 2 encoder (1014s.pdf, 1017s.pdf), one L2 PDU at a time: packs the audio
+ * frames and PSD of each program into audio transport PDUs with their Reed-Solomon
+ * parity, frames AAS PDUs into the fixed data subchannel, and spreads the PCI
+ * header. Independent of GNU Radio, so it can be embedded in other programs;
+ * nrsc5::l2_encoder is a wrapper around it.
+ */
+class l2_frame_encoder
+{
+public:
+    static constexpr int MAX_PROGRAMS = 8;
+
+    /* size is the L2 PDU size in bits, which also sets the codec mode */
+    l2_frame_encoder(int num_progs,
+                     int first_prog,
+                     int size,
+                     int data_bytes = 0,
+                     blend blend_control = blend::ENABLE);
+    ~l2_frame_encoder();
+    l2_frame_encoder(const l2_frame_encoder&) = delete;
+    l2_frame_encoder& operator=(const l2_frame_encoder&) = delete;
+
+    /* Size of an L2 PDU in bits, and of the PSD it carries for each program */
+    int pdu_size() const { return size; }
+    int psd_size() const { return psd_bytes; }
+
+    /* Bytes at the start of a program's audio input that finish a split frame */
+    int partial_frame_bytes(int p) const { return partial_bytes[p]; }
+
+    /* Number of whole audio frames the next PDU carries for a program */
+    int frames_needed(int p) const;
+
+    /*
+     * Encodes one PDU of pdu_size() bits, one bit per byte. inputs[p] must hold the
+     * frames needed by program p and psd_size() bytes of PSD, and its offsets are
+     * advanced past the data used.
+     */
+    void encode_frame(l2_program_input* inputs, unsigned char* out);
+
+    /*
+     * Queues an AAS PDU for the data subchannel. It is framed in place, so owner must
+     * keep the bytes valid until the PDU has been sent. SIG PDUs also set the
+     * program types announced in the audio headers.
+     */
+    void push_aas_pdu(const uint8_t* pdu, size_t len, std::shared_ptr<const void> owner);
+
+    /* Called with the port whose AAS queue has just been emptied */
+    void set_ready_callback(std::function<void(int port)> callback);
+
+    /* Number of breaks seen in the sequence numbers of tagged audio frames */
+    uint64_t discontinuities() const { return discontinuity_count; }
+
+    /*
+     * Number of times a program's audio fell more than eight frames behind, because
+     * its bitrate is too high for the space left in the logical channel
+     */
+    uint64_t audio_overruns() const { return audio_overrun_count; }
+
+private:
+    struct aas_pdu {
+        const uint8_t* data;
+        size_t len;
+        std::shared_ptr<const void> owner;
+    };
+
+    int num_progs;
+    int first_prog;
+    int program_type[MAX_PROGRAMS];
+    int size;
+    int data_bytes;
+    blend blend_control;
+    int payload_bytes;
+    unsigned char rs_buf[255];
+    std::unique_ptr<rs_encoder> rs_enc;
+    int target_nop;
+    int lc_bits;
+    int psd_bytes;
+    int pdu_seq_no;
+    int pdu_seq_len;
+    int codec_mode;
+    int start_seq_no[MAX_PROGRAMS];
+    int target_seq_no;
+    int partial_bytes[MAX_PROGRAMS];
+    int64_t next_frame_seq[MAX_PROGRAMS];
+    uint64_t discontinuity_count;
+    uint64_t audio_overrun_count;
+    int ccc_width;
+    unsigned char ccc_count;
+    std::vector<unsigned char> ccc;
+    int ccc_offset;
+    int total_data_width;
+    std::map<int, std::queue<aas_pdu>> aas_queues;
+    std::unique_ptr<hdlc_framer> aas_framer;
+    int aas_current_port;
+    int aas_block_offset;
+    std::function<void(int port)> ready_callback;
+
+    unsigned char* out_buf;
+
+    void write_control_word(unsigned char* out,
+                            int codec_mode,
+                            int stream_id,
+                            int pdu_seq_no,
+                            int blend_control,
+                            int digital_gain_or_per_stream_delay,
+                            int common_delay,
+                            int latency,
+                            int p_first,
+                            int p_last,
+                            int start_seq_no,
+                            int nop,
+                            int hef,
+                            int la_loc);
+    void write_hef(unsigned char* out, int program_number, int access, int program_type);
+    void write_locator(unsigned char* out, int i, int locator);
+    void
+    header_spread(const unsigned char* in, unsigned char* out, const unsigned char* pci);
+    int len_locators(int nop);
+    bool next_aas_pdu();
+    void fill_data_subchannel(unsigned char* out, int len);
+    void decode_sig(const uint8_t* pdu_bytes, size_t len);
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_CORE_L2_FRAME_ENCODER_H */
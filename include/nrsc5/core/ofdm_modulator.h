@@ -0,0 +1,188 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_CORE_OFDM_MODULATOR_H
+#define INCLUDED_NRSC5_CORE_OFDM_MODULATOR_H
+
+#include <nrsc5/core/l1_channel.h>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * Unnormalized inverse FFT of a power-of-two size, with the input in centred order
+ * (as fft_vcc with shift enabled expects it). The plan is fixed when the object is
+ * constructed, so identical input always gives bit-identical output, unlike an FFTW
+ * plan chosen by measurement.
+ */
+class inverse_fft
+{
+public:
+    inverse_fft(int size);
+
+    int size() const { return n; }
+
+    /* out[t] = sum over k of in[(k + size/2) % size] * exp(2j * pi * k * t / size) */
+    void execute(const gr_complex* in, gr_complex* out) const;
+
+private:
+    int n;
+    std::vector<int> order;
+    std::vector<gr_complex> twiddle;
+};
+
+/*
+ * FM OFDM modulator (1011s.pdf): sideband levels, IFFT, cyclic extension and
+ * raised-cosine windowing, producing the same waveform as the hd_tx_* flowgraphs at
+ * 744187.5 samples per second.
+ */
+class fm_ofdm_modulator
+{
+public:
+    static constexpr int FFT_SIZE = 2048;
+    static constexpr int CP_SIZE = 112;
+    static constexpr int SYMBOL_SIZE = FFT_SIZE + CP_SIZE;
+
+    /* Sideband levels are in dB relative to an unmodulated analog carrier */
+    fm_ofdm_modulator(double lsb_power_db, double usb_power_db);
+
+    /* Modulates nsymbols symbols of FFT_SIZE subcarriers into nsymbols * SYMBOL_SIZE */
+    void modulate(const gr_complex* in, gr_complex* out, int nsymbols);
+
+private:
+    inverse_fft ifft;
+    std::vector<float> levels;
+    std::vector<float> window;
+    std::vector<gr_complex> scaled;
+    std::vector<gr_complex> symbol;
+};
+
+/*
+ * AM OFDM modulator (1012s.pdf): IFFT and pulse shaping, producing the same waveform
+ * as fft_vcc followed by am_pulse_shaper at 46511.71875 samples per second. The
+ * unmodulated analog carrier is not included.
+ */
+class am_ofdm_modulator
+{
+public:
+    static constexpr int FFT_SIZE = 256;
+    static constexpr int CP_SIZE = 14;
+    static constexpr int SYMBOL_SIZE = FFT_SIZE + CP_SIZE;
+
+    am_ofdm_modulator();
+
+    /* Modulates nsymbols symbols of FFT_SIZE subcarriers into nsymbols * SYMBOL_SIZE */
+    void modulate(const gr_complex* in, gr_complex* out, int nsymbols);
+
+    /*
+     * Shapes one symbol period from the time-domain samples of the previous and
+     * current symbols, FFT_SIZE each, writing SYMBOL_SIZE samples to out.
+     */
+    static void shape(const gr_complex* prev, const gr_complex* cur, gr_complex* out);
+
+private:
+    inverse_fft ifft;
+    std::vector<gr_complex> prev;
+    std::vector<gr_complex> cur;
+};
+
+/*
+ * Fixed-point counterpart of inverse_fft, for exciters without a fast FPU. Data is
+ * 32-bit, twiddle factors are Q15, and each butterfly rounds its product back to the
+ * input scale, so there is no scaling between stages: the caller leaves enough
+ * headroom for the output to grow by up to a factor of size.
+ */
+class inverse_fft_q15
+{
+public:
+    typedef std::complex<int32_t> sample;
+
+    inverse_fft_q15(int size);
+
+    int size() const { return n; }
+
+    /* Same transform as inverse_fft::execute */
+    void execute(const sample* in, sample* out) const;
+
+private:
+    int n;
+    std::vector<int> order;
+    std::vector<std::complex<int32_t>> twiddle;
+};
+
+/*
+ * Fixed-point FM OFDM modulator, taking the Q14 output of l1_fm_frame_encoder and
+ * producing the waveform of fm_ofdm_modulator as sc16_t, where 32767 represents an
+ * amplitude of full_scale (relative to an unmodulated analog carrier of amplitude 1).
+ * Samples beyond full scale are clipped.
+ *
+ * OFDM peaks reach about 13 dB (MP1, MP2) to 15 dB (MP3) above the RMS level. With
+ * full_scale at five times the RMS amplitude of the sidebands, MP1 and MP2 are not
+ * clipped and the error vector magnitude against fm_ofdm_modulator is about -82 dB;
+ * six times covers the extended modes at the same EVM. Most of what remains is the
+ * rounding of the output.
+ */
+class fm_ofdm_modulator_sc16
+{
+public:
+    static constexpr int FFT_SIZE = 2048;
+    static constexpr int CP_SIZE = 112;
+    static constexpr int SYMBOL_SIZE = FFT_SIZE + CP_SIZE;
+
+    /* Throws std::invalid_argument if full_scale is too small for the 32-bit IFFT */
+    fm_ofdm_modulator_sc16(double lsb_power_db, double usb_power_db, double full_scale);
+
+    /* Modulates nsymbols symbols of FFT_SIZE subcarriers into nsymbols * SYMBOL_SIZE */
+    void modulate(const sc16_t* in, sc16_t* out, int nsymbols);
+
+private:
+    inverse_fft_q15 ifft;
+    std::vector<int32_t> gains;
+    std::vector<int32_t> window;
+    std::vector<inverse_fft_q15::sample> scaled;
+    std::vector<inverse_fft_q15::sample> symbol;
+};
+
+/*
+ * Fixed-point AM OFDM modulator, taking the Q14 output of l1_am_frame_encoder and
+ * producing the waveform of am_ofdm_modulator as sc16_t, where 32767 represents an
+ * amplitude of full_scale. An unmodulated carrier of the given amplitude can be added
+ * before the output is clipped to full scale.
+ *
+ * With the carrier at 1, MA1 needs no more than full_scale = 2 for an error vector
+ * magnitude of about -71 dB against am_ofdm_modulator. Without it, the digital signal
+ * alone peaks about 17 dB above its RMS level and needs eight times the RMS amplitude.
+ */
+class am_ofdm_modulator_sc16
+{
+public:
+    static constexpr int FFT_SIZE = 256;
+    static constexpr int CP_SIZE = 14;
+    static constexpr int SYMBOL_SIZE = FFT_SIZE + CP_SIZE;
+
+    /* Throws std::invalid_argument if full_scale is too small for the 32-bit IFFT */
+    am_ofdm_modulator_sc16(double full_scale, double carrier = 0);
+
+    /* Modulates nsymbols symbols of FFT_SIZE subcarriers into nsymbols * SYMBOL_SIZE */
+    void modulate(const sc16_t* in, sc16_t* out, int nsymbols);
+
+private:
+    inverse_fft_q15 ifft;
+    int32_t gain;
+    int64_t carrier;
+    std::vector<int32_t> pulse_q15;
+    std::vector<inverse_fft_q15::sample> scaled;
+    std::vector<inverse_fft_q15::sample> prev;
+    std::vector<inverse_fft_q15::sample> cur;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_CORE_OFDM_MODULATOR_H */
@@ -0,0 +1,165 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_CORE_RATIONAL_RESAMPLER_H
+#define INCLUDED_NRSC5_CORE_RATIONAL_RESAMPLER_H
+
+#include <nrsc5/core/l1_channel.h>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * Kaiser-windowed low-pass filter, designed as firdes::low_pass does it. Frequencies
+ * are in the same units as sample_rate, and the taps are scaled for a DC gain of gain.
+ */
+std::vector<float> design_low_pass(
+    double gain, double sample_rate, double cutoff, double transition, double beta = 7.0);
+
+/*
+ * Taps for a rational_resampler, as rational_resampler_xxx designs them: unity gain,
+ * with the passband extending to fractional_bw of the lower Nyquist frequency.
+ */
+std::vector<float>
+design_resampler_taps(int interpolation, int decimation, double fractional_bw = 0.4);
+
+/*
+ * Polyphase rational resampler, changing the sample rate by interpolation /
+ * decimation. Output depends only on the input, not on how it is split into calls.
+ */
+template <class T>
+class rational_resampler
+{
+public:
+    rational_resampler(int interpolation,
+                       int decimation,
+                       const std::vector<float>& taps)
+        : interp(interpolation), decim(decimation), phase(0), skip(0)
+    {
+        if ((interpolation < 1) || (decimation < 1) || taps.empty()) {
+            throw std::invalid_argument("invalid resampler parameters");
+        }
+
+        // branch p holds taps p, p + interp, ... in reverse, so that it can be applied
+        // to the oldest sample first
+        branch_len = (taps.size() + interp - 1) / interp;
+        branches.assign(interp, std::vector<float>(branch_len, 0));
+        for (size_t i = 0; i < taps.size(); i++) {
+            branches[i % interp][branch_len - 1 - i / interp] = taps[i];
+        }
+        history.assign(branch_len - 1, T(0));
+    }
+
+    int interpolation() const { return interp; }
+    int decimation() const { return decim; }
+
+    /* Resamples nitems input samples, appending the results to out */
+    void process(const T* in, size_t nitems, std::vector<T>& out)
+    {
+        history.insert(history.end(), in, in + nitems);
+
+        size_t pos = skip;
+        while (pos + branch_len <= history.size()) {
+            const float* taps = branches[phase].data();
+            const T* samples = history.data() + pos;
+            T acc = T(0);
+            for (int j = 0; j < branch_len; j++) {
+                acc += samples[j] * taps[j];
+            }
+            out.push_back(acc);
+
+            phase += decim;
+            pos += phase / interp;
+            phase %= interp;
+        }
+
+        // when decimating, the next output may start beyond the samples we have
+        size_t consumed = std::min(pos, history.size());
+        skip = pos - consumed;
+        history.erase(history.begin(), history.begin() + consumed);
+    }
+
+private:
+    int interp;
+    int decim;
+    int phase;
+    int branch_len;
+    size_t skip;
+    std::vector<std::vector<float>> branches;
+    std::vector<T> history;
+};
+
+/* Sample rates and one-sided bandwidths of the OFDM signals */
+constexpr double FM_OFDM_SAMPLE_RATE = 744187.5;
+constexpr double AM_OFDM_SAMPLE_RATE = FM_OFDM_SAMPLE_RATE / 16;
+constexpr double FM_OFDM_BANDWIDTH = FM_OFDM_SAMPLE_RATE * 546 / 2048;
+constexpr double AM_OFDM_BANDWIDTH = AM_OFDM_SAMPLE_RATE * 81 / 256;
+
+/*
+ * Single-stage polyphase resampler for complex signals, taking an OFDM signal to an
+ * SDR's sample rate (for example 744187.5 Hz to 2 MHz, a ratio of 32000 / 11907) in
+ * one pass. Sample rates must be multiples of 1/1024 Hz, and the ratio between them is
+ * exact.
+ *
+ * The filter passes frequencies up to passband, and attenuates the images of that
+ * band (and, when decimating, anything that would alias onto it) by rejection_db.
+ * When the interpolation is larger than MAX_PHASES, the filter is stored as
+ * MAX_PHASES phases and the ones in between are interpolated linearly, which adds
+ * error more than 120 dB below the signal.
+ */
+class polyphase_resampler
+{
+public:
+    static constexpr int MAX_PHASES = 512;
+
+    /* Throws std::invalid_argument for impossible rates or filter specifications */
+    polyphase_resampler(double input_rate,
+                        double output_rate,
+                        double passband,
+                        double rejection_db = 80);
+
+    int64_t interpolation() const { return interp; }
+    int64_t decimation() const { return decim; }
+    int phases() const { return nphases; }
+    int taps_per_phase() const { return branch_len; }
+
+    /* Group delay of the filter, in input samples */
+    double delay() const { return branch_len / 2.0; }
+
+    /*
+     * Takes the first output the given number of input samples (rounded to a multiple
+     * of 1 / interpolation) further into the input, which shortens the delay through
+     * the resampler by that much. Must be called before the first process().
+     */
+    void advance(double input_samples);
+
+    /* Resamples nitems input samples, appending the results to out */
+    void process(const gr_complex* in, size_t nitems, std::vector<gr_complex>& out);
+
+private:
+    int64_t interp;
+    int64_t decim;
+    int nphases;
+    int branch_len;
+    int64_t step;
+    int64_t fraction_step;
+    int64_t phase;
+    int64_t fraction;
+    size_t skip;
+    std::vector<float> bank;
+    std::vector<float> slope;
+    std::vector<gr_complex> history;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_CORE_RATIONAL_RESAMPLER_H */
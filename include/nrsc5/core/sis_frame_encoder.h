@@ -0,0 +1,224 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017, 2023, 2026 Clayton Smith.
+ * Copyright 2023 Vladislav Fomitchev.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_CORE_SIS_FRAME_ENCODER_H
+#define INCLUDED_NRSC5_CORE_SIS_FRAME_ENCODER_H
+
+#include <nrsc5/core/service_types.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * Station Information Service encoder (1020s.pdf), one L1 frame at a time: builds the
+ * PIDS PDUs from the station configuration following the standard schedules, and the
+ * SIG packet announcing its services on the data subchannel. Independent of GNU
+ * Radio, so it can be embedded in other programs; nrsc5::sis_encoder is a wrapper
+ * around it.
+ */
+class sis_frame_encoder
+{
+public:
+    static constexpr int PDU_BITS = 80;
+    static constexpr int BLOCKS_PER_FRAME_FM = 16;
+    static constexpr int BLOCKS_PER_FRAME_AM = 8;
+    static constexpr unsigned int MAX_AUDIO_PROGRAMS = 8;
+
+    /* Data subchannel port of the SIG PDUs */
+    static constexpr uint16_t SIG_PORT = 0x20;
+
+    sis_frame_encoder(pids_mode mode,
+                      const std::string& short_name,
+                      const std::string& slogan,
+                      const std::string& message,
+                      const std::vector<std::string>& program_names,
+                      const std::vector<program_type>& program_types,
+                      const std::vector<service_data_type>& data_types,
+                      const std::vector<unsigned int>& data_mime_types,
+                      float latitude,
+                      float longitude,
+                      float altitude,
+                      const std::string& country_code,
+                      unsigned int fcc_facility_id,
+                      bool time_locked);
+
+    int blocks_per_frame() const { return blocks; }
+
+    /*
+     * Encodes the PIDS PDUs of one frame, blocks_per_frame() PDUs of PDU_BITS bits
+     * each, one bit per byte, and moves on to the next ALFN.
+     */
+    void encode_frame(unsigned char* out);
+
+    /* Absolute L1 frame number of the next frame */
+    unsigned int current_alfn() const { return alfn; }
+    void set_alfn(unsigned int alfn) { this->alfn = alfn; }
+
+    /* GPS to UTC offset in seconds, as announced in the SIS parameter message */
+    unsigned int leap_second_offset() const { return current_leap_second_offset; }
+
+    /*
+     * Changes to the station. These take effect from the next frame encoded, and
+     * throw std::invalid_argument if the new value cannot be sent.
+     */
+    unsigned int num_programs() const { return program_names.size(); }
+    void set_program(unsigned int program_id, program_type type, const std::string& name);
+    void remove_program(unsigned int program_id);
+    void set_message(const std::string& message);
+    void set_slogan(const std::string& slogan);
+    void set_alert(const std::string& control_data, const std::string& message);
+    void clear_alert();
+
+    /* The SIG AAS PDU, with the next sequence number */
+    const std::vector<uint8_t>& next_sig_pdu();
+
+private:
+    enum class sched_item {
+        STATION_ID,
+        SHORT_STATION_NAME,
+        LONG_STATION_NAME,
+        STATION_LOCATION,
+        STATION_MESSAGE,
+        SERVICE_INFO_MESSAGE,
+        SIS_PARAMETER_MESSAGE,
+        UNIVERSAL_SHORT_STATION_NAME,
+        STATION_SLOGAN,
+        EA_MESSAGE
+    };
+
+    static constexpr int NUM_SCHED_ITEMS = 10;
+
+    typedef std::vector<std::vector<sched_item>> schedule_t;
+
+    static const schedule_t schedule_fm_short_no_ea;
+    static const schedule_t schedule_fm_short_ea;
+    static const schedule_t schedule_fm_long_no_ea;
+    static const schedule_t schedule_fm_long_ea;
+    static const schedule_t schedule_am_short_no_ea;
+    static const schedule_t schedule_am_short_ea;
+    static const schedule_t schedule_am_long_no_ea;
+    static const schedule_t schedule_am_long_ea;
+
+    enum class dst_schedule { NONE, US_CANADA, EUROPE };
+
+    /* Payload bits of one schedule item, right-aligned */
+    struct packed_bits {
+        uint64_t bits;
+        int len;
+    };
+
+    pids_mode mode;
+    int blocks;
+    unsigned int alfn;
+    bool time_locked;
+    std::string country_code;
+    unsigned int fcc_facility_id;
+    std::string short_name;
+    bool fm_suffix;
+    bool use_standard_short_station_name;
+    std::string slogan;
+    std::string message;
+    std::string emergency_alert;
+    unsigned int emergency_alert_cnt_len;
+    float latitude;
+    float longitude;
+    float altitude;
+    unsigned int pending_leap_second_offset;
+    unsigned int current_leap_second_offset;
+    unsigned int leap_second_alfn;
+    int utc_offset;
+    dst_schedule dst_sched;
+    bool dst_local;
+    bool dst_regional;
+    std::string exciter_manufacturer_id;
+    std::vector<unsigned int> exciter_core_version;
+    unsigned int exciter_core_status;
+    std::vector<unsigned int> exciter_manufacturer_version;
+    unsigned int exciter_manufacturer_status;
+    std::string importer_manufacturer_id;
+    std::vector<unsigned int> importer_core_version;
+    unsigned int importer_core_status;
+    std::vector<unsigned int> importer_manufacturer_version;
+    unsigned int importer_manufacturer_status;
+    unsigned int importer_configuration_number;
+
+    uint64_t acc;
+    int acc_len;
+    std::vector<packed_bits> item_cache[NUM_SCHED_ITEMS];
+    schedule_t schedule;
+    bool schedule_dirty;
+    unsigned int fresh_segments[NUM_SCHED_ITEMS];
+    uint16_t tail_crc[16];
+
+    unsigned int long_name_current_frame;
+    unsigned int long_name_seq;
+
+    unsigned int ussn_current_frame;
+    unsigned int slogan_current_frame;
+
+    unsigned int message_current_frame;
+    unsigned int message_seq;
+
+    unsigned int emergency_alert_current_frame;
+    unsigned int emergency_alert_seq;
+
+    std::vector<std::string> program_names;
+    std::vector<program_type> program_types;
+    std::vector<service_data_type> data_types;
+    std::vector<unsigned int> data_mime_types;
+    unsigned int current_service;
+
+    unsigned int current_parameter;
+
+    bool location_high;
+
+    uint16_t d_seq;
+    std::vector<std::string> sig_programs;
+    std::vector<uint8_t> sig_packet;
+    bool sig_valid;
+
+    int crc12(uint64_t payload, int tail);
+    int crc7(const std::string alert);
+    void update_control_data_crc(std::string& control_data);
+    void write_bit(int b);
+    void write_int(int n, int len);
+    void write_char5(char c);
+    void write_station_id();
+    void write_station_name_short();
+    void write_station_name_long();
+    void write_station_location();
+    void write_station_message();
+    void write_service_information_message();
+    void write_sis_parameter_message();
+    void write_universal_short_station_name();
+    void write_station_slogan();
+    void write_emergency_alert();
+    const schedule_t& current_schedule();
+    unsigned int item_state(sched_item item);
+    unsigned int item_segments(sched_item item);
+    void advance_item(sched_item item);
+    packed_bits item_bits(sched_item item);
+    void invalidate_item(sched_item item);
+    void mark_fresh(sched_item item);
+    void compile_schedule();
+    void
+    write_pdu(unsigned char* out, const std::vector<sched_item>& payloads, int block);
+    bool can_use_standard_short_station_name();
+    std::string generate_sig_program(unsigned int program_id);
+    void encode_sig();
+    void update_sig_program(unsigned int program_id);
+    void services_changed();
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_CORE_SIS_FRAME_ENCODER_H */
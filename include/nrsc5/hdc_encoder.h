@@ -32,7 +32,11 @@ public:
      * class. nrsc5::hdc_encoder::make is the public interface for
      * creating new instances.
      */
-    static sptr make(int channels = 2, int bitrate = 64000);
+    static sptr make(int channels = 2,
+                     int bitrate = 64000,
+                     bool short_input = false,
+                     int lookahead_frames = 0,
+                     const std::string& record_file = "");
 };
 
 } // namespace nrsc5
@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_HYBRID_FM_EXCITER_H
+#define INCLUDED_NRSC5_HYBRID_FM_EXCITER_H
+
+#include <gnuradio/block.h>
+#include <nrsc5/api.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*!
+ * \brief Hybrid FM exciter: analog FM plus digital sidebands, at an SDR's sample rate
+ * \ingroup nrsc5
+ *
+ * Takes OFDM symbols from the layer 1 FM encoder on its first input, and 44.1 kHz
+ * audio on one (mono) or two (left and right) more. The digital sidebands are
+ * modulated at the given levels and resampled to sample_rate. The audio is held back
+ * by the 4.458 second diversity delay, measured exactly from the symbol input to the
+ * output, then pre-emphasized, limited to 15 kHz, and frequency modulated (75 kHz
+ * deviation, with a 19 kHz pilot for stereo) directly at sample_rate. The sum is
+ * scaled by gain, relative to an unmodulated analog carrier of amplitude 1.
+ *
+ * This replaces the OFDM, analog FM, resampling and mixing blocks of the hd_tx_*
+ * flowgraphs.
+ */
+class NRSC5_API hybrid_fm_exciter : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<hybrid_fm_exciter> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of nrsc5::hybrid_fm_exciter.
+     *
+     * To avoid accidental use of raw pointers, nrsc5::hybrid_fm_exciter's
+     * constructor is in a private implementation
+     * class. nrsc5::hybrid_fm_exciter::make is the public interface for
+     * creating new instances.
+     */
+    static sptr make(double sample_rate = 2000000,
+                     double lsb_power_db = -13,
+                     double usb_power_db = -13,
+                     double gain = 1);
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_HYBRID_FM_EXCITER_H */
@@ -0,0 +1,53 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_IQ_FILE_SINK_H
+#define INCLUDED_NRSC5_IQ_FILE_SINK_H
+
+#include <gnuradio/sync_block.h>
+#include <nrsc5/api.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*!
+ * \brief Records complex samples as 8- or 16-bit interleaved IQ, with SigMF metadata
+ * \ingroup nrsc5
+ *
+ * Writes <filename>.sigmf-data and <filename>.sigmf-meta. Samples are scaled so that
+ * full_scale maps to the largest integer value, and clipped beyond it. The metadata
+ * records the sample rate, service mode and sideband power levels given here, along
+ * with the first ALFN tag seen (as placed by the layer 1 encoders), so the recording
+ * can be replayed with iq_file_source.
+ */
+class NRSC5_API iq_file_sink : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<iq_file_sink> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of nrsc5::iq_file_sink.
+     *
+     * To avoid accidental use of raw pointers, nrsc5::iq_file_sink's
+     * constructor is in a private implementation
+     * class. nrsc5::iq_file_sink::make is the public interface for
+     * creating new instances.
+     */
+    static sptr make(const std::string& filename,
+                     int bits,
+                     double sample_rate,
+                     int vlen = 1,
+                     float full_scale = 1.0,
+                     const std::string& mode = "",
+                     double lsb_power_db = 0,
+                     double usb_power_db = 0);
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_IQ_FILE_SINK_H */
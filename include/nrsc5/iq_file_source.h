@@ -0,0 +1,60 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_IQ_FILE_SOURCE_H
+#define INCLUDED_NRSC5_IQ_FILE_SOURCE_H
+
+#include <gnuradio/sync_block.h>
+#include <nrsc5/api.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*!
+ * \brief Replays a recording made by iq_file_sink
+ * \ingroup nrsc5
+ *
+ * The data file is memory-mapped and converted back to complex samples with a single
+ * scale. Output is produced as fast as downstream blocks accept it; pacing is left to
+ * the hardware sink. The ALFN recorded in the metadata is tagged on the sample where
+ * it was seen, on the first pass through the file.
+ */
+class NRSC5_API iq_file_source : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<iq_file_source> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of nrsc5::iq_file_source.
+     *
+     * To avoid accidental use of raw pointers, nrsc5::iq_file_source's
+     * constructor is in a private implementation
+     * class. nrsc5::iq_file_source::make is the public interface for
+     * creating new instances.
+     */
+    static sptr make(const std::string& filename, bool repeat = true);
+
+    /*!
+     * \brief Sample rate from the recording's metadata.
+     */
+    virtual double sample_rate() const = 0;
+
+    /*!
+     * \brief Vector length of the output, from the recording's metadata.
+     */
+    virtual int vlen() const = 0;
+
+    /*!
+     * \brief Service mode from the recording's metadata.
+     */
+    virtual std::string mode() const = 0;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_IQ_FILE_SOURCE_H */
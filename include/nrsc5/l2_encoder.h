@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2017 Clayton Smith.
+ * Copyright 2017, 2026 Clayton Smith.
  *
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
@@ -10,12 +10,12 @@
 
 #include <gnuradio/block.h>
 #include <nrsc5/api.h>
+#include <nrsc5/core/l2_frame_encoder.h>
+#include <vector>
 
 namespace gr {
 namespace nrsc5 {
 
-enum class blend { DISABLE, SELECT, ENABLE };
-
 /*!
  * \brief <+description of block+>
  * \ingroup nrsc5
@@ -39,6 +39,16 @@ public:
                      const int size,
                      const int data_bytes = 0,
                      const blend blend_control = blend::ENABLE);
+
+    /*!
+     * \brief Makes output independent of message timing for the given AAS ports.
+     *
+     * "ready" messages for these ports ask the source to mark the end of its
+     * reply, and the encoder produces no further PDUs until the marker arrives.
+     * The SIS, LOT encoder and LOT carousel blocks all answer such requests. Used
+     * for offline rendering, where identical inputs must give identical output.
+     */
+    virtual void set_lockstep_ports(const std::vector<int>& ports) = 0;
 };
 
 } // namespace nrsc5
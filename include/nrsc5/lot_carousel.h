@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_LOT_CAROUSEL_H
+#define INCLUDED_NRSC5_LOT_CAROUSEL_H
+
+#include <gnuradio/block.h>
+#include <nrsc5/api.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*!
+ * \brief Sends a set of files as LOT packets, sharing the AAS capacity between them
+ * \ingroup nrsc5
+ *
+ * Each file is sent on its own AAS port. The parts of all files are interleaved so as
+ * to minimize the expected time for a receiver to acquire them, weighted by priority,
+ * while meeting any delivery deadlines.
+ *
+ * Files can also be picked up from a spool directory, which is watched for changes.
+ * A file named <lot_id>_<name> is sent as <name> with the given LOT ID, and replaces
+ * the previous version once that has been sent in full. Deleting the file withdraws
+ * it.
+ */
+class NRSC5_API lot_carousel : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<lot_carousel> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of nrsc5::lot_carousel.
+     *
+     * To avoid accidental use of raw pointers, nrsc5::lot_carousel's
+     * constructor is in a private implementation
+     * class. nrsc5::lot_carousel::make is the public interface for
+     * creating new instances.
+     */
+    static sptr make(const std::string& spool_dir = "", int spool_port = 0x1001);
+
+    /*!
+     * \brief Add a file to the carousel, or replace the file with the same LOT ID.
+     *
+     * \param filename Path of the file to send.
+     * \param lot_id LOT ID of the file.
+     * \param port AAS port to send the file on.
+     * \param priority Relative importance of the file.
+     * \param repeat Number of times to send the file, or 0 to send it indefinitely.
+     * \param expiry Seconds after which the file is withdrawn, or 0 for no expiry.
+     * \param deadline Seconds within which the whole file should be sent, or 0.
+     */
+    virtual void add_file(const std::string& filename,
+                          int lot_id,
+                          int port = 0x1001,
+                          double priority = 1.0,
+                          int repeat = 0,
+                          double expiry = 0.0,
+                          double deadline = 0.0) = 0;
+
+    /*!
+     * \brief Withdraw the file with the given LOT ID.
+     */
+    virtual void remove_file(int lot_id) = 0;
+
+    /*!
+     * \brief Number of files currently in the carousel.
+     */
+    virtual int num_files() const = 0;
+
+    /*!
+     * \brief Number of files picked up from the spool directory.
+     */
+    virtual uint64_t files_ingested() const = 0;
+
+    /*!
+     * \brief Mean time in seconds from a file being written to the spool directory to
+     * the file being added to the carousel.
+     */
+    virtual double ingest_latency() const = 0;
+
+    /*!
+     * \brief Mean time in seconds from a file being written to the spool directory to
+     * its first part being sent.
+     */
+    virtual double air_latency() const = 0;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_LOT_CAROUSEL_H */
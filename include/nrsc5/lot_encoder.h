@@ -0,0 +1,43 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_LOT_ENCODER_H
+#define INCLUDED_NRSC5_LOT_ENCODER_H
+
+#include <gnuradio/block.h>
+#include <nrsc5/api.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*!
+ * \brief Reads a file and encodes it as LOT packets
+ * \ingroup nrsc5
+ *
+ * The file is sent repeatedly on the given AAS port. Packets are generated a few at
+ * a time, as the Layer 2 encoder signals on its "ready" port that it needs more.
+ */
+class NRSC5_API lot_encoder : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<lot_encoder> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of nrsc5::lot_encoder.
+     *
+     * To avoid accidental use of raw pointers, nrsc5::lot_encoder's
+     * constructor is in a private implementation
+     * class. nrsc5::lot_encoder::make is the public interface for
+     * creating new instances.
+     */
+    static sptr make(const std::string& filename = "", int lot_id = 0, int port = 0x1001);
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_LOT_ENCODER_H */
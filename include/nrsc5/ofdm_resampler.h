@@ -0,0 +1,48 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_OFDM_RESAMPLER_H
+#define INCLUDED_NRSC5_OFDM_RESAMPLER_H
+
+#include <gnuradio/block.h>
+#include <nrsc5/api.h>
+#include <nrsc5/sis_encoder.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*!
+ * \brief Resamples the OFDM signal to an SDR's sample rate in a single stage
+ * \ingroup nrsc5
+ *
+ * Takes the FM (744187.5 Hz) or AM (46511.71875 Hz) OFDM signal to any sample rate
+ * that is a whole number of Hz, such as 2, 2.4 or 10 MHz, with one polyphase filter in
+ * place of a chain of rational resamplers. The filter passes the digital sidebands
+ * and attenuates their images by rejection_db.
+ */
+class NRSC5_API ofdm_resampler : virtual public gr::block
+{
+public:
+    typedef std::shared_ptr<ofdm_resampler> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of nrsc5::ofdm_resampler.
+     *
+     * To avoid accidental use of raw pointers, nrsc5::ofdm_resampler's
+     * constructor is in a private implementation
+     * class. nrsc5::ofdm_resampler::make is the public interface for
+     * creating new instances.
+     */
+    static sptr make(pids_mode band = pids_mode::FM,
+                     double sample_rate = 2000000,
+                     double rejection_db = 80);
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_OFDM_RESAMPLER_H */
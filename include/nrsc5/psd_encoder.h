@@ -35,7 +35,20 @@ public:
     static sptr make(const int prog_num,
                      const std::string& title,
                      const std::string& artist,
-                     const int bytes_per_frame = 0);
+                     const int bytes_per_frame = 0,
+                     const bool preempt = false,
+                     const int lookahead_frames = 1);
+
+    /*!
+     * \brief Number of times the Layer 1 encoder caught up with this block and had
+     * to wait for it to generate PSD.
+     *
+     * This is counted when a clock message arrives before the PSD for the frame the
+     * Layer 1 encoder needs next has been generated, although earlier clocks had
+     * already allowed it. PSD that the clock itself allows, as with lookahead_frames
+     * set to 0 (or preempt on) or a clock that skips frames, is not counted.
+     */
+    virtual uint64_t underruns() const = 0;
 };
 
 } // namespace nrsc5
@@ -0,0 +1,60 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_PSD_MULTI_ENCODER_H
+#define INCLUDED_NRSC5_PSD_MULTI_ENCODER_H
+
+#include <gnuradio/sync_block.h>
+#include <nrsc5/api.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*!
+ * \brief Encodes the PSD streams of several programs from a single block
+ * \ingroup nrsc5
+ *
+ * Output n carries the PSD of program first_prog + n. Metadata lines are accepted
+ * on a single set_meta port, optionally prefixed with "N|" to select program N.
+ */
+class NRSC5_API psd_multi_encoder : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<psd_multi_encoder> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of nrsc5::psd_multi_encoder.
+     *
+     * To avoid accidental use of raw pointers, nrsc5::psd_multi_encoder's
+     * constructor is in a private implementation
+     * class. nrsc5::psd_multi_encoder::make is the public interface for
+     * creating new instances.
+     */
+    static sptr make(const int num_progs,
+                     const int first_prog,
+                     const std::vector<std::string> titles,
+                     const std::vector<std::string> artists,
+                     const int bytes_per_frame = 0,
+                     const bool preempt = false,
+                     const int lookahead_frames = 1);
+
+    /*!
+     * \brief Number of times the Layer 1 encoder caught up with this block and had
+     * to wait for it to generate PSD.
+     *
+     * This is counted when a clock message arrives before the PSD for the frame the
+     * Layer 1 encoder needs next has been generated, although earlier clocks had
+     * already allowed it. PSD that the clock itself allows, as with lookahead_frames
+     * set to 0 (or preempt on) or a clock that skips frames, is not counted.
+     */
+    virtual uint64_t underruns() const = 0;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_PSD_MULTI_ENCODER_H */
@@ -10,68 +10,11 @@
 
 #include <gnuradio/sync_block.h>
 #include <nrsc5/api.h>
+#include <nrsc5/core/service_types.h>
 
 namespace gr {
 namespace nrsc5 {
 
-enum class pids_mode { FM, AM };
-
-enum class program_type {
-    UNDEFINED = 0,
-    NEWS = 1,
-    INFORMATION = 2,
-    SPORTS = 3,
-    TALK = 4,
-    ROCK = 5,
-    CLASSIC_ROCK = 6,
-    ADULT_HITS = 7,
-    SOFT_ROCK = 8,
-    TOP_40 = 9,
-    COUNTRY = 10,
-    OLDIES = 11,
-    SOFT = 12,
-    NOSTALGIA = 13,
-    JAZZ = 14,
-    CLASSICAL = 15,
-    RHYTHM_AND_BLUES = 16,
-    SOFT_RHYTHM_AND_BLUES = 17,
-    FOREIGN_LANGUAGE = 18,
-    RELIGIOUS_MUSIC = 19,
-    RELIGIOUS_TALK = 20,
-    PERSONALITY = 21,
-    PUBLIC = 22,
-    COLLEGE = 23,
-    SPANISH_TALK = 24,
-    SPANISH_MUSIC = 25,
-    HIP_HOP = 26,
-    WEATHER = 29,
-    EMERGENCY_TEST = 30,
-    EMERGENCY = 31,
-    TRAFFIC = 65,
-    SPECIAL_READING_SERVICES = 76
-};
-
-enum class service_data_type {
-    NON_SPECIFIC = 0,
-    NEWS = 1,
-    SPORTS = 3,
-    WEATHER = 29,
-    EMERGENCY = 31,
-    TRAFFIC = 65,
-    IMAGE_MAPS = 66,
-    TEXT = 80,
-    ADVERTISING = 256,
-    FINANCIAL = 257,
-    STOCK_TICKER = 258,
-    NAVIGATION = 259,
-    ELECTRONIC_PROGRAM_GUIDE = 260,
-    AUDIO = 261,
-    PRIVATE_DATA_NETWORK = 262,
-    SERVICE_MAINTENANCE = 263,
-    HD_RADIO_SYSTEM_SERVICES = 264,
-    AUDIO_RELATED_DATA = 265
-};
-
 /*!
  * \brief <+description of block+>
  * \ingroup nrsc5
@@ -103,7 +46,20 @@ public:
          const float longitude = -74.0445,
          const float altitude = 93.0,
          const std::string& country_code = "US",
-         const unsigned int fcc_facility_id = 0);
+         const unsigned int fcc_facility_id = 0,
+         const int lookahead_frames = 1,
+         const bool time_locked = false);
+
+    /*!
+     * \brief Number of times the Layer 1 encoder caught up with this block and had
+     * to wait for it to generate the next frame.
+     *
+     * This is counted when a clock message arrives before the frame the Layer 1
+     * encoder needs next has been generated, although earlier clocks had already
+     * allowed it. A frame that the clock itself allows, as with lookahead_frames set
+     * to 0 or a clock that skips frames, is not counted.
+     */
+    virtual uint64_t underruns() const = 0;
 };
 
 } // namespace nrsc5
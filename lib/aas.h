@@ -0,0 +1,66 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_AAS_H
+#define INCLUDED_NRSC5_AAS_H
+
+#include <pmt/pmt.h>
+
+namespace gr {
+namespace nrsc5 {
+
+inline const pmt::pmt_t& reply_end_key()
+{
+    static const pmt::pmt_t key = pmt::intern("reply_end");
+    return key;
+}
+
+/*
+ * Sent on an "aas" port after the AAS PDUs that a source queues in reply to a
+ * lockstep "ready" message for its port. A Layer 2 encoder in lockstep mode waits for
+ * it, so that its output does not depend on how quickly messages are delivered.
+ */
+inline pmt::pmt_t aas_reply_end(int port)
+{
+    pmt::pmt_t meta = pmt::make_dict();
+    meta = pmt::dict_add(meta, reply_end_key(), pmt::from_long(port));
+    return pmt::cons(meta, pmt::PMT_NIL);
+}
+
+/* Returns the port of a reply_end message, or -1 for an AAS PDU */
+inline int aas_reply_end_port(const pmt::pmt_t& msg)
+{
+    pmt::pmt_t meta = pmt::car(msg);
+    if (!pmt::is_dict(meta)) {
+        return -1;
+    }
+    pmt::pmt_t port = pmt::dict_ref(meta, reply_end_key(), pmt::PMT_NIL);
+    return pmt::is_null(port) ? -1 : pmt::to_long(port);
+}
+
+/*
+ * "ready" messages carry the AAS port whose queue has emptied. For ports in lockstep,
+ * the Layer 2 encoder sends (port . reply_end) instead, asking the source to follow
+ * its reply with aas_reply_end(port). Sources never send the marker otherwise.
+ */
+inline pmt::pmt_t aas_ready(int port, bool lockstep)
+{
+    pmt::pmt_t msg = pmt::from_long(port);
+    return lockstep ? pmt::cons(msg, reply_end_key()) : msg;
+}
+
+/* Returns the port of a "ready" message, and whether it wants a reply_end */
+inline long aas_ready_port(const pmt::pmt_t& msg, bool& lockstep)
+{
+    lockstep = pmt::is_pair(msg);
+    return pmt::to_long(lockstep ? pmt::car(msg) : msg);
+}
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_AAS_H */
@@ -0,0 +1,34 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_ADTS_H
+#define INCLUDED_NRSC5_ADTS_H
+
+namespace gr {
+namespace nrsc5 {
+
+constexpr int ADTS_HEADER_LEN = 7;
+constexpr int HDC_SAMPLE_RATE = 44100;
+constexpr int SAMPLES_PER_FRAME = 2048;
+
+/* Checks for the ADTS sync word and MPEG layer 0 */
+inline bool adts_sync(const unsigned char* header)
+{
+    return (header[0] == 0xff) && ((header[1] & 0xf6) == 0xf0);
+}
+
+/* Payload length of an ADTS frame, excluding its header */
+inline int adts_length(const unsigned char* header)
+{
+    return ((header[3] & 0x03) << 11 | (header[4] << 3) | (header[5] >> 5)) -
+           ADTS_HEADER_LEN;
+}
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_ADTS_H */
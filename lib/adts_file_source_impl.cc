@@ -0,0 +1,210 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "adts.h"
+#include "adts_file_source_impl.h"
+#include "hdc_tag.h"
+#include <gnuradio/io_signature.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <thread>
+
+namespace gr {
+namespace nrsc5 {
+
+adts_file_source::sptr
+adts_file_source::make(const std::string& filename, bool realtime, bool repeat)
+{
+    return gnuradio::get_initial_sptr(
+        new adts_file_source_impl(filename, realtime, repeat));
+}
+
+
+/*
+ * The private constructor
+ */
+adts_file_source_impl::adts_file_source_impl(const std::string& filename,
+                                             bool realtime,
+                                             bool repeat)
+    : gr::sync_block("adts_file_source",
+                     gr::io_signature::make(0, 0, 0),
+                     gr::io_signature::make(1, 1, sizeof(unsigned char)))
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("adts_file_source: Unable to open " + filename);
+    }
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        close(fd);
+        throw std::runtime_error("adts_file_source: Unable to read " + filename);
+    }
+    size = st.st_size;
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("adts_file_source: Unable to map " + filename);
+    }
+    data = (const unsigned char*)map;
+
+    try {
+        index_frames(filename);
+    } catch (...) {
+        munmap(map, size);
+        throw;
+    }
+
+    this->realtime = realtime;
+    this->repeat = repeat;
+    frame = 0;
+    frame_off = 0;
+    frame_seq = 0;
+    pending_seek = -1;
+
+    message_port_register_in(pmt::mp("seek"));
+    set_msg_handler(pmt::mp("seek"), [this](pmt::pmt_t msg) { this->handle_seek(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+adts_file_source_impl::~adts_file_source_impl() { munmap((void*)data, size); }
+
+/*
+ * Validates the file and records where each frame starts, so that the stream can be
+ * replayed and seeked without parsing it again.
+ */
+void adts_file_source_impl::index_frames(const std::string& filename)
+{
+    size_t off = 0;
+    while (off + ADTS_HEADER_LEN <= size) {
+        if (!adts_sync(data + off)) {
+            throw std::runtime_error("adts_file_source: Lost ADTS sync at byte " +
+                                     std::to_string(off) + " of " + filename);
+        }
+        int length = ADTS_HEADER_LEN + adts_length(data + off);
+        if (length <= ADTS_HEADER_LEN) {
+            throw std::runtime_error("adts_file_source: Invalid ADTS frame at byte " +
+                                     std::to_string(off) + " of " + filename);
+        }
+        if (off + length > size) {
+            break;
+        }
+        frames.push_back({ off, length });
+        off += length;
+    }
+
+    if (frames.empty()) {
+        throw std::runtime_error("adts_file_source: No complete frames in " + filename);
+    }
+    if (off != size) {
+        d_logger->warn("Ignoring truncated frame at the end of " + filename);
+    }
+}
+
+bool adts_file_source_impl::start()
+{
+    start_time = std::chrono::steady_clock::now();
+    return block::start();
+}
+
+int adts_file_source_impl::work(int noutput_items,
+                                gr_vector_const_void_star& input_items,
+                                gr_vector_void_star& output_items)
+{
+    unsigned char* out = (unsigned char*)output_items[0];
+
+    // In real time, a frame is not started until its due time, as if it had just
+    // been encoded from a live audio source.
+    uint64_t frames_due = UINT64_MAX;
+    if (realtime) {
+        std::chrono::duration<double> frame_time((double)SAMPLES_PER_FRAME /
+                                                 HDC_SAMPLE_RATE);
+        auto elapsed = std::chrono::steady_clock::now() - start_time;
+        frames_due = (uint64_t)(elapsed / frame_time) + 1;
+        if ((frame_off == 0) && (frame_seq >= frames_due)) {
+            std::this_thread::sleep_until(
+                start_time + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 frame_time * frame_seq));
+            frames_due = frame_seq + 1;
+        }
+    }
+
+    int out_off = 0;
+    while (out_off < noutput_items) {
+        if (frame_off == 0) {
+            if (frame_seq >= frames_due) {
+                break;
+            }
+
+            // Seeks take effect at a frame boundary, so the output stays aligned
+            int64_t target = pending_seek.exchange(-1);
+            if (target >= 0) {
+                frame = target;
+            }
+            if (frame == frames.size()) {
+                if (!repeat) {
+                    break;
+                }
+                frame = 0;
+            }
+
+            add_item_tag(0,
+                         nitems_written(0) + out_off,
+                         hdc_frame_tag(),
+                         pmt::cons(pmt::from_long(frames[frame].length - ADTS_HEADER_LEN),
+                                   pmt::from_uint64(frame_seq)));
+        }
+
+        const frame_ref& ref = frames[frame];
+        int n = std::min(noutput_items - out_off, ref.length - frame_off);
+        memcpy(out + out_off, data + ref.offset + frame_off, n);
+        out_off += n;
+        frame_off += n;
+
+        if (frame_off == ref.length) {
+            frame_off = 0;
+            frame++;
+            frame_seq++;
+        }
+    }
+
+    if ((out_off == 0) && !repeat && (frame == frames.size())) {
+        return WORK_DONE;
+    }
+    return out_off;
+}
+
+void adts_file_source_impl::seek(uint64_t frame)
+{
+    if (frame >= frames.size()) {
+        throw std::invalid_argument("adts_file_source: frame out of range");
+    }
+    pending_seek = frame;
+}
+
+uint64_t adts_file_source_impl::num_frames() const { return frames.size(); }
+
+void adts_file_source_impl::handle_seek(pmt::pmt_t msg)
+{
+    uint64_t target = pmt::to_long(msg);
+    if (target >= frames.size()) {
+        d_logger->warn("Ignoring seek to frame " + std::to_string(target));
+        return;
+    }
+    seek(target);
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
@@ -0,0 +1,59 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_ADTS_FILE_SOURCE_IMPL_H
+#define INCLUDED_NRSC5_ADTS_FILE_SOURCE_IMPL_H
+
+#include <nrsc5/adts_file_source.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+class adts_file_source_impl : public adts_file_source
+{
+private:
+    struct frame_ref {
+        size_t offset;
+        int length;
+    };
+
+    const unsigned char* data;
+    size_t size;
+    std::vector<frame_ref> frames;
+    bool realtime;
+    bool repeat;
+
+    uint64_t frame;
+    int frame_off;
+    uint64_t frame_seq;
+    std::atomic<int64_t> pending_seek;
+    std::chrono::steady_clock::time_point start_time;
+
+    void index_frames(const std::string& filename);
+    void handle_seek(pmt::pmt_t msg);
+
+public:
+    adts_file_source_impl(const std::string& filename, bool realtime, bool repeat);
+    ~adts_file_source_impl();
+
+    void seek(uint64_t frame) override;
+    uint64_t num_frames() const override;
+
+    // Where all the action really happens
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+    bool start() override;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_ADTS_FILE_SOURCE_IMPL_H */
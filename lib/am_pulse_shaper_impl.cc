@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2025 Clayton Smith.
+ * Copyright 2025, 2026 Clayton Smith.
  *
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
@@ -44,16 +44,8 @@ int am_pulse_shaper_impl::work(int noutput_items,
 
     int in_offset = 0, out_offset = 0;
     while (out_offset < noutput_items) {
-        for (int i = 0; i < AM_FFT_SIZE; i++) {
-            out[out_offset + i] = in[in_offset + i] * pulse[AM_FFT_SIZE + i];
-        }
-        for (int i = AM_FFT_SIZE; i < AM_FFTCP_SIZE; i++) {
-            out[out_offset + i] = 0;
-        }
-        for (int i = 0; i < AM_FFT_SIZE; i++) {
-            out[out_offset + AM_CP_SIZE + i] +=
-                in[in_offset + AM_FFT_SIZE + i] * pulse[i];
-        }
+        am_ofdm_modulator::shape(
+            in + in_offset, in + in_offset + AM_FFT_SIZE, out + out_offset);
 
         in_offset += AM_FFT_SIZE;
         out_offset += AM_FFTCP_SIZE;
@@ -0,0 +1,44 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_CRC_H
+#define INCLUDED_NRSC5_CRC_H
+
+#include <cstddef>
+#include <cstdint>
+
+/* HDLC frame check sequence register update (CRC-16/X.25) */
+uint16_t fcs16_update(uint16_t crc, const unsigned char* buf, size_t len);
+
+/* HDLC frame check sequence, as transmitted after the frame contents */
+inline uint16_t fcs16(const unsigned char* buf, size_t len)
+{
+    return fcs16_update(0xffff, buf, len) ^ 0xffff;
+}
+
+/* 1017s.pdf section 5.2.1.4: CRC-8 appended to each audio frame */
+uint8_t crc8_update(uint8_t crc, const unsigned char* buf, size_t len);
+
+inline uint8_t crc8(const unsigned char* buf, size_t len)
+{
+    return crc8_update(0xff, buf, len);
+}
+
+/*
+ * 1020s.pdf section 4.10: 16-bit CRC with g(x) = X^16 + X^11 + X^3 + X + 1, used for
+ * the SIS PDU CRC and the emergency alert control data CRC. Bytes are consumed least
+ * significant bit first.
+ */
+uint16_t sis_crc16_update(uint16_t crc, const unsigned char* buf, size_t len);
+
+/*
+ * Emergency alert message CRC with g(x) = X^7 + X^3 + 1. Each input byte holds one
+ * 7-bit symbol, which is consumed most significant bit first.
+ */
+uint8_t crc7_update(uint8_t crc, const unsigned char* symbols, size_t len);
+
+#endif /* INCLUDED_NRSC5_CRC_H */
@@ -0,0 +1,66 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "encoder_pool.h"
+#include <algorithm>
+
+namespace gr {
+namespace nrsc5 {
+
+encoder_pool& encoder_pool::get()
+{
+    static encoder_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+encoder_pool::encoder_pool(unsigned int threads) : stopping(false)
+{
+    for (unsigned int i = 0; i < threads; i++) {
+        workers.emplace_back([this] { run(); });
+    }
+}
+
+encoder_pool::~encoder_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void encoder_pool::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    cv.notify_one();
+}
+
+void encoder_pool::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            return;
+        }
+        auto job = std::move(jobs.front());
+        jobs.pop_front();
+
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+} // namespace nrsc5
+} // namespace gr
@@ -0,0 +1,49 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_ENCODER_POOL_H
+#define INCLUDED_NRSC5_ENCODER_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * Worker threads shared by every encoder in the process, one per hardware thread.
+ * Jobs are run in submission order, but may complete in any order.
+ */
+class encoder_pool
+{
+public:
+    static encoder_pool& get();
+
+    void submit(std::function<void()> job);
+    unsigned int size() const { return workers.size(); }
+
+    ~encoder_pool();
+
+private:
+    encoder_pool(unsigned int threads);
+    void run();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_ENCODER_POOL_H */
@@ -9,27 +9,39 @@
 #include "config.h"
 #endif
 
+#include "encoder_pool.h"
 #include "hdc_encoder_impl.h"
 #include <gnuradio/io_signature.h>
 
 namespace gr {
 namespace nrsc5 {
 
-hdc_encoder::sptr hdc_encoder::make(int channels, int bitrate)
+hdc_encoder::sptr hdc_encoder::make(int channels,
+                                    int bitrate,
+                                    bool short_input,
+                                    int lookahead_frames,
+                                    const std::string& record_file)
 {
-    return gnuradio::get_initial_sptr(new hdc_encoder_impl(channels, bitrate));
+    return gnuradio::get_initial_sptr(new hdc_encoder_impl(
+        channels, bitrate, short_input, lookahead_frames, record_file));
 }
 
 
 /*
  * The private constructor
  */
-hdc_encoder_impl::hdc_encoder_impl(int channels, int bitrate)
+hdc_encoder_impl::hdc_encoder_impl(int channels,
+                                   int bitrate,
+                                   bool short_input,
+                                   int lookahead_frames,
+                                   const std::string& record_file)
     : gr::block("hdc_encoder",
-                gr::io_signature::make(1, 2, sizeof(float)),
+                short_input ? gr::io_signature::make(1, 1, channels * sizeof(short))
+                            : gr::io_signature::make(1, 2, sizeof(float)),
                 gr::io_signature::make(1, 1, sizeof(unsigned char)))
 {
     this->channels = channels;
+    this->short_input = short_input;
     bytes_per_frame = bitrate * SAMPLES_PER_FRAME / HDC_SAMPLE_RATE / 8;
     set_relative_rate((double)bytes_per_frame / SAMPLES_PER_FRAME);
 
@@ -47,6 +59,9 @@ hdc_encoder_impl::hdc_encoder_impl(int channels, int bitrate)
     default:
         throw std::runtime_error("hdc_encoder: channels must be 1 or 2");
     }
+    if (lookahead_frames < 0) {
+        throw std::runtime_error("hdc_encoder: lookahead must not be negative");
+    }
     if (aacEncOpen(&handle, 0, channels) != AACENC_OK) {
         throw std::runtime_error("hdc_encoder: Unable to open decoder");
     }
@@ -86,10 +101,35 @@ hdc_encoder_impl::hdc_encoder_impl(int channels, int bitrate)
 
     frame_length = info.frameLength;
     max_out_buf_bytes = info.maxOutBufBytes;
-    convert_buf = (short*)malloc(channels * sizeof(short) * frame_length);
+    size_t alignment = volk_get_alignment();
+    convert_buf = (short*)volk_malloc(channels * sizeof(short) * frame_length, alignment);
+    interleave_buf = (lv_32fc_t*)volk_malloc(sizeof(lv_32fc_t) * frame_length, alignment);
     outbuf = (unsigned char*)malloc(max_out_buf_bytes);
     outbuf_off = 0;
     outbuf_len = 0;
+    frame_seq = 0;
+
+    // With a lookahead, frames are encoded on the shared worker pool while the
+    // scheduler thread moves on, at the cost of lookahead_frames frames of latency.
+    this->lookahead_frames = lookahead_frames;
+    slots.resize(lookahead_frames);
+    for (auto& slot : slots) {
+        slot.pcm.resize(channels * frame_length);
+        slot.adts.resize(max_out_buf_bytes);
+    }
+    frames_filled = 0;
+    frames_encoded = 0;
+    frames_emitted = 0;
+    draining = false;
+
+    // Encoded frames can also be saved, for replay with adts_file_source
+    record = nullptr;
+    if (!record_file.empty()) {
+        record = fopen(record_file.c_str(), "wb");
+        if (record == nullptr) {
+            throw std::runtime_error("hdc_encoder: Unable to open " + record_file);
+        }
+    }
 }
 
 /*
@@ -97,18 +137,29 @@ hdc_encoder_impl::hdc_encoder_impl(int channels, int bitrate)
  */
 hdc_encoder_impl::~hdc_encoder_impl()
 {
+    {
+        std::unique_lock<std::mutex> lock(slot_mutex);
+        slot_cv.wait(lock, [this] { return !draining; });
+    }
     aacEncClose(&handle);
-    free(convert_buf);
+    if (record) {
+        fclose(record);
+    }
+    volk_free(convert_buf);
+    volk_free(interleave_buf);
     free(outbuf);
 }
 
 void hdc_encoder_impl::forecast(int noutput_items, gr_vector_int& ninput_items_required)
 {
-    for (int channel = 0; channel < channels; channel++) {
-        if (noutput_items <= outbuf_len) {
-            ninput_items_required[channel] = 0;
+    // Frames already queued for encoding can be emitted without further input
+    bool queued = (frames_filled > frames_emitted);
+
+    for (size_t port = 0; port < ninput_items_required.size(); port++) {
+        if ((noutput_items <= outbuf_len) || queued) {
+            ninput_items_required[port] = 0;
         } else {
-            ninput_items_required[channel] =
+            ninput_items_required[port] =
                 (((noutput_items - outbuf_len) / bytes_per_frame) + 1) *
                 SAMPLES_PER_FRAME;
         }
@@ -120,20 +171,55 @@ int hdc_encoder_impl::general_work(int noutput_items,
                                    gr_vector_const_void_star& input_items,
                                    gr_vector_void_star& output_items)
 {
-    const float** in = (const float**)&input_items[0];
     unsigned char* out = (unsigned char*)output_items[0];
 
     int in_off = 0;
     int out_off = 0;
 
     int min_input_items = INT_MAX;
-    for (int channel = 0; channel < channels; channel++) {
-        if (ninput_items[channel] < min_input_items) {
-            min_input_items = ninput_items[channel];
+    for (size_t port = 0; port < ninput_items.size(); port++) {
+        if (ninput_items[port] < min_input_items) {
+            min_input_items = ninput_items[port];
+        }
+    }
+
+    if (lookahead_frames > 0) {
+        // Queue as many frames as there are free slots, then hand them to the pool
+        bool submit = false;
+        while ((frames_filled - frames_emitted < slots.size()) &&
+               (in_off + frame_length <= min_input_items)) {
+            short* pcm = slots[frames_filled % slots.size()].pcm.data();
+            if (short_input) {
+                memcpy(pcm,
+                       (const short*)input_items[0] + in_off * channels,
+                       channels * sizeof(short) * frame_length);
+            } else {
+                convert_audio((const float* const*)&input_items[0], in_off, pcm);
+            }
+            in_off += frame_length;
+
+            std::lock_guard<std::mutex> lock(slot_mutex);
+            frames_filled++;
+            if (!draining) {
+                draining = true;
+                submit = true;
+            }
+        }
+        if (submit) {
+            encoder_pool::get().submit([this] { drain_slots(); });
         }
     }
 
     while (out_off < noutput_items) {
+        // Mark the start of each ADTS frame so that l2_encoder need not parse headers
+        if ((outbuf_off == 0) && (outbuf_len > 0)) {
+            add_item_tag(0,
+                         nitems_written(0) + out_off,
+                         hdc_frame_tag(),
+                         pmt::cons(pmt::from_long(outbuf_len - ADTS_HEADER_LEN),
+                                   pmt::from_uint64(frame_seq++)));
+        }
+
         if (out_off + outbuf_len > noutput_items) {
             int space = noutput_items - out_off;
             memcpy(out + out_off, outbuf + outbuf_off, space);
@@ -148,57 +234,147 @@ int hdc_encoder_impl::general_work(int noutput_items,
         outbuf_off = 0;
         outbuf_len = 0;
 
+        if (lookahead_frames > 0) {
+            // Only wait for the pool if there is nothing else to return
+            if (!next_encoded_frame(out_off == 0))
+                break;
+            continue;
+        }
+
         if (in_off + frame_length > min_input_items)
             break;
 
-        AACENC_BufDesc in_buf = { 0 }, out_buf = { 0 };
-        AACENC_InArgs in_args = { 0 };
-        AACENC_OutArgs out_args = { 0 };
-        int in_identifier = IN_AUDIO_DATA;
-        int in_size, in_elem_size;
-        int out_identifier = OUT_BITSTREAM_DATA;
-        int out_size, out_elem_size;
-        void *in_ptr, *out_ptr;
-        AACENC_ERROR err;
-
-        int convert_off = 0;
-        for (int i = 0; i < frame_length; i++) {
-            for (int channel = 0; channel < channels; channel++) {
-                convert_buf[convert_off++] = (short)(in[channel][in_off] * 32768);
-            }
-            in_off++;
+        // Interleaved PCM is handed to the encoder straight from the input buffer
+        void* pcm;
+        if (short_input) {
+            pcm = (short*)input_items[0] + in_off * channels;
+        } else {
+            convert_audio((const float* const*)&input_items[0], in_off, convert_buf);
+            pcm = convert_buf;
         }
+        in_off += frame_length;
 
-        in_ptr = convert_buf;
-        in_size = channels * sizeof(short) * frame_length;
-        in_elem_size = sizeof(short);
-
-        in_args.numInSamples = channels * frame_length;
-        in_buf.numBufs = 1;
-        in_buf.bufs = &in_ptr;
-        in_buf.bufferIdentifiers = &in_identifier;
-        in_buf.bufSizes = &in_size;
-        in_buf.bufElSizes = &in_elem_size;
-
-        out_ptr = outbuf;
-        out_size = max_out_buf_bytes;
-        out_elem_size = 1;
-        out_buf.numBufs = 1;
-        out_buf.bufs = &out_ptr;
-        out_buf.bufferIdentifiers = &out_identifier;
-        out_buf.bufSizes = &out_size;
-        out_buf.bufElSizes = &out_elem_size;
-
-        if ((err = aacEncEncode(handle, &in_buf, &out_buf, &in_args, &out_args)) !=
-            AACENC_OK) {
+        outbuf_len = encode_frame(pcm, outbuf);
+        if (outbuf_len < 0) {
             throw std::runtime_error("hdc_encoder: Encoding failed");
         }
-        outbuf_len = out_args.numOutBytes;
+        if (record) {
+            fwrite(outbuf, 1, outbuf_len, record);
+        }
     }
 
     consume_each(in_off);
     return out_off;
 }
 
+/*
+ * Encodes one frame of interleaved PCM, returning the length of the ADTS frame or -1
+ * on failure.
+ */
+int hdc_encoder_impl::encode_frame(void* pcm, unsigned char* adts)
+{
+    AACENC_BufDesc in_buf = { 0 }, out_buf = { 0 };
+    AACENC_InArgs in_args = { 0 };
+    AACENC_OutArgs out_args = { 0 };
+    int in_identifier = IN_AUDIO_DATA;
+    int in_size, in_elem_size;
+    int out_identifier = OUT_BITSTREAM_DATA;
+    int out_size, out_elem_size;
+    void *in_ptr, *out_ptr;
+
+    in_ptr = pcm;
+    in_size = channels * sizeof(short) * frame_length;
+    in_elem_size = sizeof(short);
+
+    in_args.numInSamples = channels * frame_length;
+    in_buf.numBufs = 1;
+    in_buf.bufs = &in_ptr;
+    in_buf.bufferIdentifiers = &in_identifier;
+    in_buf.bufSizes = &in_size;
+    in_buf.bufElSizes = &in_elem_size;
+
+    out_ptr = adts;
+    out_size = max_out_buf_bytes;
+    out_elem_size = 1;
+    out_buf.numBufs = 1;
+    out_buf.bufs = &out_ptr;
+    out_buf.bufferIdentifiers = &out_identifier;
+    out_buf.bufSizes = &out_size;
+    out_buf.bufElSizes = &out_elem_size;
+
+    if (aacEncEncode(handle, &in_buf, &out_buf, &in_args, &out_args) != AACENC_OK) {
+        return -1;
+    }
+    return out_args.numOutBytes;
+}
+
+/*
+ * Runs on the worker pool, encoding queued frames in order until none are left.
+ * At most one drain is in flight per encoder, since fdk-aac handles are stateful.
+ */
+void hdc_encoder_impl::drain_slots()
+{
+    std::unique_lock<std::mutex> lock(slot_mutex);
+    while (frames_encoded < frames_filled) {
+        hdc_frame_slot& slot = slots[frames_encoded % slots.size()];
+        lock.unlock();
+        slot.len = encode_frame(slot.pcm.data(), slot.adts.data());
+        lock.lock();
+        frames_encoded++;
+        slot_cv.notify_all();
+    }
+    draining = false;
+    slot_cv.notify_all();
+}
+
+/*
+ * Moves the oldest encoded frame into the output buffer, optionally waiting for the
+ * pool to finish it. Returns false if no frame is available.
+ */
+bool hdc_encoder_impl::next_encoded_frame(bool wait)
+{
+    if (frames_emitted == frames_filled) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(slot_mutex);
+    if (wait) {
+        slot_cv.wait(lock, [this] { return frames_encoded > frames_emitted; });
+    } else if (frames_encoded == frames_emitted) {
+        return false;
+    }
+    lock.unlock();
+
+    hdc_frame_slot& slot = slots[frames_emitted % slots.size()];
+    if (slot.len < 0) {
+        throw std::runtime_error("hdc_encoder: Encoding failed");
+    }
+    memcpy(outbuf, slot.adts.data(), slot.len);
+    outbuf_off = 0;
+    outbuf_len = slot.len;
+    if (record) {
+        fwrite(outbuf, 1, outbuf_len, record);
+    }
+    frames_emitted++;
+    return true;
+}
+
+/*
+ * Converts one frame of float audio (full scale +/-1.0) to interleaved 16-bit PCM,
+ * rounding and clipping out-of-range samples.
+ */
+void hdc_encoder_impl::convert_audio(const float* const* in, int in_off, short* pcm)
+{
+    if (channels == 1) {
+        volk_32f_s32f_convert_16i(pcm, in[0] + in_off, 32768, frame_length);
+    } else {
+        // Interleaving two float channels is the same as building a complex vector
+        volk_32f_x2_interleave_32fc(
+            interleave_buf, in[0] + in_off, in[1] + in_off, frame_length);
+        volk_32f_s32f_convert_16i(
+            pcm, (const float*)interleave_buf, 32768, 2 * frame_length);
+    }
+}
+
 } /* namespace nrsc5 */
 } /* namespace gr */
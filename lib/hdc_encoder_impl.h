@@ -8,7 +8,14 @@
 #ifndef INCLUDED_NRSC5_HDC_ENCODER_IMPL_H
 #define INCLUDED_NRSC5_HDC_ENCODER_IMPL_H
 
+#include "adts.h"
+#include "hdc_tag.h"
 #include <nrsc5/hdc_encoder.h>
+#include <volk/volk.h>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <vector>
 
 extern "C" {
 #include "fdk-aac/aacenc_lib.h"
@@ -17,24 +24,51 @@ extern "C" {
 namespace gr {
 namespace nrsc5 {
 
-constexpr int HDC_SAMPLE_RATE = 44100;
-constexpr int SAMPLES_PER_FRAME = 2048;
+/* One frame of audio queued for encoding on the worker pool, and its result */
+struct hdc_frame_slot {
+    std::vector<short> pcm;
+    std::vector<unsigned char> adts;
+    int len;
+};
 
 class hdc_encoder_impl : public hdc_encoder
 {
 private:
     int channels;
+    bool short_input;
     int bytes_per_frame;
     HANDLE_AACENCODER handle;
     int frame_length;
     int max_out_buf_bytes;
     short* convert_buf;
+    lv_32fc_t* interleave_buf;
     unsigned char* outbuf;
     int outbuf_off;
     int outbuf_len;
+    uint64_t frame_seq;
+    FILE* record;
+
+    // Asynchronous encoding: slots are filled, encoded and emitted in ring order
+    int lookahead_frames;
+    std::vector<hdc_frame_slot> slots;
+    uint64_t frames_filled;
+    uint64_t frames_encoded;
+    uint64_t frames_emitted;
+    bool draining;
+    std::mutex slot_mutex;
+    std::condition_variable slot_cv;
+
+    void convert_audio(const float* const* in, int in_off, short* pcm);
+    int encode_frame(void* pcm, unsigned char* adts);
+    void drain_slots();
+    bool next_encoded_frame(bool wait);
 
 public:
-    hdc_encoder_impl(int channels, int bitrate);
+    hdc_encoder_impl(int channels,
+                     int bitrate,
+                     bool short_input,
+                     int lookahead_frames,
+                     const std::string& record_file);
     ~hdc_encoder_impl();
 
     // Where all the action really happens
@@ -0,0 +1,29 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_HDC_TAG_H
+#define INCLUDED_NRSC5_HDC_TAG_H
+
+#include <pmt/pmt.h>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * Stream tag placed by hdc_encoder on the first byte of every ADTS frame.
+ * The value is a pair of (payload length excluding header, frame sequence number).
+ */
+inline const pmt::pmt_t& hdc_frame_tag()
+{
+    static const pmt::pmt_t key = pmt::intern("hdc_frame");
+    return key;
+}
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_HDC_TAG_H */
@@ -6,62 +6,140 @@
  */
 
 #include "hdlc.h"
-#include <cstdint>
+#include "crc.h"
+#include <algorithm>
+#include <cstring>
 
-static constexpr uint16_t FCS16_TABLE[] = {
-    0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf, 0x8c48, 0x9dc1,
-    0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7, 0x1081, 0x0108, 0x3393, 0x221a,
-    0x56a5, 0x472c, 0x75b7, 0x643e, 0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64,
-    0xf9ff, 0xe876, 0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
-    0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5, 0x3183, 0x200a,
-    0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c, 0xbdcb, 0xac42, 0x9ed9, 0x8f50,
-    0xfbef, 0xea66, 0xd8fd, 0xc974, 0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9,
-    0x2732, 0x36bb, 0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
-    0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a, 0xdecd, 0xcf44,
-    0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72, 0x6306, 0x728f, 0x4014, 0x519d,
-    0x2522, 0x34ab, 0x0630, 0x17b9, 0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3,
-    0x8a78, 0x9bf1, 0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
-    0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70, 0x8408, 0x9581,
-    0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7, 0x0840, 0x19c9, 0x2b52, 0x3adb,
-    0x4e64, 0x5fed, 0x6d76, 0x7cff, 0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324,
-    0xf1bf, 0xe036, 0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
-    0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5, 0x2942, 0x38cb,
-    0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd, 0xb58b, 0xa402, 0x9699, 0x8710,
-    0xf3af, 0xe226, 0xd0bd, 0xc134, 0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e,
-    0x5cf5, 0x4d7c, 0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
-    0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb, 0xd68d, 0xc704,
-    0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232, 0x5ac5, 0x4b4c, 0x79d7, 0x685e,
-    0x1ce1, 0x0d68, 0x3ff3, 0x2e7a, 0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3,
-    0x8238, 0x93b1, 0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
-    0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330, 0x7bc7, 0x6a4e,
-    0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78
-};
+static inline bool needs_escape(unsigned char c) { return (c == 0x7d) || (c == 0x7e); }
 
-static uint16_t fcs16(std::vector<unsigned char>& in)
+static inline bool has_zero_byte(uint64_t v)
 {
-    uint16_t crc = 0xffff;
-    for (auto c : in)
-        crc = (crc >> 8) ^ FCS16_TABLE[(crc ^ c) & 0xff];
-    return crc ^ 0xffff;
+    return ((v - 0x0101010101010101ULL) & ~v & 0x8080808080808080ULL) != 0;
 }
 
-std::vector<unsigned char> hdlc_encode(std::vector<unsigned char> in)
+/*
+ * Returns the number of leading bytes that can be copied without escaping. Whole
+ * 64-bit words are tested at once, and only a word containing 0x7d or 0x7e is
+ * scanned byte by byte.
+ */
+static size_t escape_free_run(const unsigned char* in, size_t len)
+{
+    size_t off = 0;
+    while (off + 8 <= len) {
+        uint64_t word;
+        memcpy(&word, in + off, sizeof(word));
+        if (has_zero_byte(word ^ 0x7d7d7d7d7d7d7d7dULL) ||
+            has_zero_byte(word ^ 0x7e7e7e7e7e7e7e7eULL))
+            break;
+        off += 8;
+    }
+    while ((off < len) && !needs_escape(in[off])) {
+        off++;
+    }
+    return off;
+}
+
+hdlc_framer::hdlc_framer()
+    : state(framer_state::IDLE),
+      in(nullptr),
+      in_len(0),
+      in_off(0),
+      fcs(0xffff),
+      fcs_off(0),
+      pending(-1)
+{
+}
+
+void hdlc_framer::begin(const unsigned char* pdu, size_t len)
+{
+    state = framer_state::PAYLOAD;
+    in = pdu;
+    in_len = len;
+    in_off = 0;
+    fcs = 0xffff;
+    fcs_off = 0;
+    pending = -1;
+}
+
+size_t hdlc_framer::encode(unsigned char* out, size_t len)
 {
-    std::vector<unsigned char> out;
-    out.reserve(in.size() + 3);
+    size_t n = 0;
+    while ((n < len) && (state != framer_state::IDLE)) {
+        // second byte of an escape sequence that did not fit last time
+        if (pending >= 0) {
+            out[n++] = pending;
+            pending = -1;
+            continue;
+        }
+
+        switch (state) {
+        case framer_state::PAYLOAD: {
+            size_t run = escape_free_run(in + in_off, std::min(in_len - in_off, len - n));
+            memcpy(out + n, in + in_off, run);
+            fcs = fcs16_update(fcs, in + in_off, run);
+            n += run;
+            in_off += run;
 
-    uint16_t crc = fcs16(in);
-    in.push_back(crc & 0xff);
-    in.push_back(crc >> 8);
+            if (in_off == in_len) {
+                fcs ^= 0xffff;
+                fcs_bytes[0] = fcs & 0xff;
+                fcs_bytes[1] = fcs >> 8;
+                state = framer_state::FCS;
+            } else if (n < len) {
+                unsigned char c = in[in_off];
+                fcs = fcs16_update(fcs, &c, 1);
+                in_off++;
+                out[n++] = 0x7d;
+                pending = c ^ 0x20;
+            }
+            break;
+        }
+        case framer_state::FCS: {
+            unsigned char c = fcs_bytes[fcs_off++];
+            if (needs_escape(c)) {
+                out[n++] = 0x7d;
+                pending = c ^ 0x20;
+            } else {
+                out[n++] = c;
+            }
+            if (fcs_off == 2) {
+                state = framer_state::FLAG;
+            }
+            break;
+        }
+        case framer_state::FLAG:
+            out[n++] = 0x7e;
+            state = framer_state::IDLE;
+            break;
+        default:
+            break;
+        }
+    }
+    return n;
+}
 
-    for (auto c : in) {
-        if ((c == 0x7d) || (c == 0x7e)) {
-            out.push_back(0x7d);
-            out.push_back(c ^ 0x20);
-        } else {
-            out.push_back(c);
+size_t hdlc_escape(const unsigned char* in, size_t len, unsigned char* out)
+{
+    size_t n = 0;
+    size_t off = 0;
+    while (off < len) {
+        size_t run = escape_free_run(in + off, len - off);
+        memcpy(out + n, in + off, run);
+        n += run;
+        off += run;
+        if (off < len) {
+            out[n++] = 0x7d;
+            out[n++] = in[off++] ^ 0x20;
         }
     }
-    out.push_back(0x7e);
+    return n;
+}
+
+std::vector<unsigned char> hdlc_encode(const std::vector<unsigned char>& in)
+{
+    std::vector<unsigned char> out(2 * in.size() + 5);
+    hdlc_framer framer;
+    framer.begin(in.data(), in.size());
+    out.resize(framer.encode(out.data(), out.size()));
     return out;
 }
@@ -8,8 +8,44 @@
 #ifndef INCLUDED_NRSC5_FCS_H
 #define INCLUDED_NRSC5_FCS_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
-std::vector<unsigned char> hdlc_encode(std::vector<unsigned char> in);
+/*
+ * Streaming HDLC framer. Escapes a PDU and appends its FCS and closing flag directly
+ * into a caller-supplied output span. If the span fills up, the next call to encode()
+ * resumes where the previous one left off. The PDU passed to begin() is not copied,
+ * so it must remain valid until done() returns true.
+ */
+class hdlc_framer
+{
+public:
+    hdlc_framer();
+
+    void begin(const unsigned char* pdu, size_t len);
+    size_t encode(unsigned char* out, size_t len);
+    bool done() const { return state == framer_state::IDLE; }
+
+private:
+    enum class framer_state { IDLE, PAYLOAD, FCS, FLAG };
+
+    framer_state state;
+    const unsigned char* in;
+    size_t in_len;
+    size_t in_off;
+    uint16_t fcs;
+    unsigned char fcs_bytes[2];
+    int fcs_off;
+    int pending;
+};
+
+/*
+ * Escapes 0x7d and 0x7e bytes without framing. The output buffer must hold up to
+ * twice the input length. Returns the number of bytes written.
+ */
+size_t hdlc_escape(const unsigned char* in, size_t len, unsigned char* out);
+
+std::vector<unsigned char> hdlc_encode(const std::vector<unsigned char>& in);
 
 #endif
@@ -0,0 +1,221 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "hybrid_fm_exciter_impl.h"
+#include <gnuradio/io_signature.h>
+#include <cmath>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+constexpr double AUDIO_RATE = 44100;
+
+/* Audio samples per OFDM symbol: 2160 / 744187.5 seconds is exactly 128 / 44100 */
+constexpr int AUDIO_PER_SYMBOL = 128;
+
+/* Diversity delay used by the hd_tx_* flowgraphs */
+constexpr double FM_DELAY = 4.458;
+
+constexpr double FM_TAU = 75e-6;
+constexpr double FM_DEVIATION = 75e3;
+constexpr double PILOT_FREQUENCY = 19000;
+
+/*
+ * The audio filter passes 15 kHz and stops at 18 kHz, clear of the pilot. The audio
+ * resampler then passes all 18 kHz, so that only the filter shapes the audio.
+ */
+constexpr double AUDIO_CUTOFF = 16500;
+constexpr double AUDIO_TRANSITION = 3000;
+constexpr double AUDIO_BANDWIDTH = AUDIO_CUTOFF + AUDIO_TRANSITION / 2;
+
+} // namespace
+
+hybrid_fm_exciter::sptr hybrid_fm_exciter::make(double sample_rate,
+                                                double lsb_power_db,
+                                                double usb_power_db,
+                                                double gain)
+{
+    return gnuradio::make_block_sptr<hybrid_fm_exciter_impl>(
+        sample_rate, lsb_power_db, usb_power_db, gain);
+}
+
+
+/*
+ * The private constructor
+ *
+ * Pre-emphasis is the bilinear transform of (1 + s * tau) / (1 + s * tau_h), as in
+ * fm_preemph. The delay line makes up the diversity delay less the group delay of the
+ * audio filters, plus that of the digital resampler; the fraction of a sample left
+ * over is taken out by starting the audio resampler part way into its input.
+ */
+hybrid_fm_exciter_impl::hybrid_fm_exciter_impl(double sample_rate,
+                                               double lsb_power_db,
+                                               double usb_power_db,
+                                               double gain)
+    : gr::block("hybrid_fm_exciter",
+                gr::io_signature::makev(
+                    2,
+                    3,
+                    { (int)(sizeof(gr_complex) * fm_ofdm_modulator::FFT_SIZE),
+                      (int)sizeof(float),
+                      (int)sizeof(float) }),
+                gr::io_signature::make(1, 1, sizeof(gr_complex))),
+      gain(gain),
+      stereo(false),
+      modulator(lsb_power_db, usb_power_db),
+      digital_resampler(FM_OFDM_SAMPLE_RATE, sample_rate, FM_OFDM_BANDWIDTH),
+      x1{ 0, 0 },
+      y1{ 0, 0 },
+      delay_pos(0),
+      audio_filter(1, 1, design_low_pass(1, AUDIO_RATE, AUDIO_CUTOFF, AUDIO_TRANSITION)),
+      audio_resampler(AUDIO_RATE, sample_rate, AUDIO_BANDWIDTH),
+      sensitivity(2 * M_PI * FM_DEVIATION / sample_rate),
+      phase(0),
+      pilot(1),
+      pilot_step(std::polar(1.0, 2 * M_PI * PILOT_FREQUENCY / sample_rate))
+{
+    double k = 2 * AUDIO_RATE;
+    double tau_h = 1 / (2 * M_PI * 0.925 * AUDIO_RATE / 2);
+    b0 = (1 + FM_TAU * k) / (1 + tau_h * k);
+    b1 = (1 - FM_TAU * k) / (1 + tau_h * k);
+    a1 = (1 - tau_h * k) / (1 + tau_h * k);
+
+    int filter_taps =
+        design_low_pass(1, AUDIO_RATE, AUDIO_CUTOFF, AUDIO_TRANSITION).size();
+    double delay = FM_DELAY * AUDIO_RATE - (filter_taps - 1) / 2.0 -
+                   audio_resampler.delay() +
+                   digital_resampler.delay() * AUDIO_RATE / FM_OFDM_SAMPLE_RATE;
+    delay_line.assign((size_t)std::ceil(delay), 0);
+    audio_resampler.advance(delay_line.size() - delay);
+
+    set_relative_rate((uint64_t)fm_ofdm_modulator::SYMBOL_SIZE *
+                          digital_resampler.interpolation(),
+                      (uint64_t)digital_resampler.decimation());
+    set_tag_propagation_policy(TPP_ONE_TO_ONE);
+}
+
+/*
+ * Our virtual destructor.
+ */
+hybrid_fm_exciter_impl::~hybrid_fm_exciter_impl() {}
+
+bool hybrid_fm_exciter_impl::check_topology(int ninputs, int noutputs)
+{
+    stereo = (ninputs == 3);
+    return true;
+}
+
+/* Symbols that produce at least the outputs still needed */
+int hybrid_fm_exciter_impl::symbols_needed(int noutput_items) const
+{
+    int64_t outputs =
+        noutput_items - (int64_t)std::min(digital.size(), analog.size());
+    if (outputs <= 0) {
+        return 0;
+    }
+    int64_t per_symbol =
+        (int64_t)fm_ofdm_modulator::SYMBOL_SIZE * digital_resampler.interpolation();
+    return (int)((outputs * digital_resampler.decimation() + per_symbol - 1) /
+                 per_symbol);
+}
+
+void hybrid_fm_exciter_impl::forecast(int noutput_items,
+                                      gr_vector_int& ninput_items_required)
+{
+    // ready output can always be delivered, even once the input has ended
+    bool ready = !digital.empty() && !analog.empty();
+    int nsymbols = ready ? 0 : symbols_needed(noutput_items);
+    ninput_items_required[0] = nsymbols;
+    for (size_t i = 1; i < ninput_items_required.size(); i++) {
+        ninput_items_required[i] = nsymbols * AUDIO_PER_SYMBOL;
+    }
+}
+
+int hybrid_fm_exciter_impl::general_work(int noutput_items,
+                                         gr_vector_int& ninput_items,
+                                         gr_vector_const_void_star& input_items,
+                                         gr_vector_void_star& output_items)
+{
+    auto symbols = static_cast<const gr_complex*>(input_items[0]);
+    auto left = static_cast<const float*>(input_items[1]);
+    auto right = static_cast<const float*>(input_items[stereo ? 2 : 1]);
+    auto out = static_cast<gr_complex*>(output_items[0]);
+
+    int nsymbols = std::min(ninput_items[0], symbols_needed(noutput_items));
+    for (size_t i = 1; i < ninput_items.size(); i++) {
+        nsymbols = std::min(nsymbols, ninput_items[i] / AUDIO_PER_SYMBOL);
+    }
+
+    if (nsymbols > 0) {
+        ofdm.resize(nsymbols * fm_ofdm_modulator::SYMBOL_SIZE);
+        modulator.modulate(symbols, ofdm.data(), nsymbols);
+        digital_resampler.process(ofdm.data(), ofdm.size(), digital);
+
+        auto emphasize = [this](int channel, float x) {
+            float y = b0 * x + b1 * x1[channel] - a1 * y1[channel];
+            x1[channel] = x;
+            y1[channel] = y;
+            return y;
+        };
+
+        audio.resize(nsymbols * AUDIO_PER_SYMBOL);
+        for (size_t i = 0; i < audio.size(); i++) {
+            gr_complex sample;
+            if (stereo) {
+                float l = emphasize(0, left[i]);
+                float r = emphasize(1, right[i]);
+                sample = gr_complex(0.5f * (l + r), 0.5f * (l - r));
+            } else {
+                sample = gr_complex(emphasize(0, left[i]), 0);
+            }
+            audio[i] = delay_line[delay_pos];
+            delay_line[delay_pos] = sample;
+            if (++delay_pos == delay_line.size()) {
+                delay_pos = 0;
+            }
+        }
+
+        filtered.clear();
+        audio_filter.process(audio.data(), audio.size(), filtered);
+        audio_resampler.process(filtered.data(), filtered.size(), analog);
+
+        consume(0, nsymbols);
+        for (size_t i = 1; i < ninput_items.size(); i++) {
+            consume(i, nsymbols * AUDIO_PER_SYMBOL);
+        }
+    }
+
+    int n = std::min<size_t>({ (size_t)noutput_items, digital.size(), analog.size() });
+    for (int i = 0; i < n; i++) {
+        // stereo multiplex: 90% audio, with L-R on a 38 kHz subcarrier, and 10% pilot
+        float mpx = analog[i].real();
+        if (stereo) {
+            pilot *= pilot_step;
+            float s = pilot.imag();
+            float c = pilot.real();
+            mpx = 0.9f * (mpx + analog[i].imag() * 2 * s * c) + 0.1f * s;
+        }
+
+        phase += sensitivity * mpx;
+        if (phase > M_PI) {
+            phase -= 2 * M_PI;
+        } else if (phase < -M_PI) {
+            phase += 2 * M_PI;
+        }
+        out[i] = gain * (std::polar(1.0f, (float)phase) + digital[i]);
+    }
+    pilot /= std::abs(pilot);
+
+    digital.erase(digital.begin(), digital.begin() + n);
+    analog.erase(analog.begin(), analog.begin() + n);
+    return n;
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
@@ -0,0 +1,72 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_HYBRID_FM_EXCITER_IMPL_H
+#define INCLUDED_NRSC5_HYBRID_FM_EXCITER_IMPL_H
+
+#include <nrsc5/core/ofdm_modulator.h>
+#include <nrsc5/core/rational_resampler.h>
+#include <nrsc5/hybrid_fm_exciter.h>
+
+namespace gr {
+namespace nrsc5 {
+
+class hybrid_fm_exciter_impl : public hybrid_fm_exciter
+{
+private:
+    float gain;
+    bool stereo;
+
+    fm_ofdm_modulator modulator;
+    polyphase_resampler digital_resampler;
+
+    // pre-emphasis, one state per channel
+    float b0, b1, a1;
+    float x1[2], y1[2];
+
+    // (L+R)/2 and (L-R)/2, or mono audio and zero, packed into one complex sample
+    std::vector<gr_complex> delay_line;
+    size_t delay_pos;
+    rational_resampler<gr_complex> audio_filter;
+    polyphase_resampler audio_resampler;
+
+    double sensitivity;
+    double phase;
+    std::complex<double> pilot;
+    std::complex<double> pilot_step;
+
+    std::vector<gr_complex> ofdm;
+    std::vector<gr_complex> audio;
+    std::vector<gr_complex> filtered;
+
+    // both halves of the signal at the output rate, computed beyond what the last
+    // call had room for
+    std::vector<gr_complex> digital;
+    std::vector<gr_complex> analog;
+
+    int symbols_needed(int noutput_items) const;
+
+public:
+    hybrid_fm_exciter_impl(double sample_rate,
+                           double lsb_power_db,
+                           double usb_power_db,
+                           double gain);
+    ~hybrid_fm_exciter_impl();
+
+    bool check_topology(int ninputs, int noutputs);
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required);
+
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items);
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_HYBRID_FM_EXCITER_IMPL_H */
@@ -0,0 +1,158 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "iq_file_sink_impl.h"
+#include "timing.h"
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <algorithm>
+
+namespace gr {
+namespace nrsc5 {
+
+iq_file_sink::sptr iq_file_sink::make(const std::string& filename,
+                                      int bits,
+                                      double sample_rate,
+                                      int vlen,
+                                      float full_scale,
+                                      const std::string& mode,
+                                      double lsb_power_db,
+                                      double usb_power_db)
+{
+    return gnuradio::get_initial_sptr(new iq_file_sink_impl(filename,
+                                                            bits,
+                                                            sample_rate,
+                                                            vlen,
+                                                            full_scale,
+                                                            mode,
+                                                            lsb_power_db,
+                                                            usb_power_db));
+}
+
+
+/*
+ * The private constructor
+ */
+iq_file_sink_impl::iq_file_sink_impl(const std::string& filename,
+                                     int bits,
+                                     double sample_rate,
+                                     int vlen,
+                                     float full_scale,
+                                     const std::string& mode,
+                                     double lsb_power_db,
+                                     double usb_power_db)
+    : gr::sync_block("iq_file_sink",
+                     gr::io_signature::make(1, 1, sizeof(gr_complex) * vlen),
+                     gr::io_signature::make(0, 0, 0))
+{
+    if ((bits != 8) && (bits != 16)) {
+        throw std::invalid_argument("iq_file_sink: bits must be 8 or 16");
+    }
+    if ((vlen < 1) || !(full_scale > 0) || !(sample_rate > 0)) {
+        throw std::invalid_argument(
+            "iq_file_sink: vlen, full_scale and sample_rate must be positive");
+    }
+
+    meta.bits = bits;
+    meta.sample_rate = sample_rate;
+    meta.full_scale = full_scale;
+    meta.vlen = vlen;
+    meta.mode = mode;
+    meta.lsb_power_db = lsb_power_db;
+    meta.usb_power_db = usb_power_db;
+    scale = ((bits == 8) ? INT8_MAX : INT16_MAX) / full_scale;
+
+    std::string base = sigmf_base(filename);
+    data_path = base + ".sigmf-data";
+    meta_path = base + ".sigmf-meta";
+    data_file = fopen(data_path.c_str(), "wb");
+    if (data_file == nullptr) {
+        throw std::runtime_error("iq_file_sink: Unable to open " + data_path);
+    }
+    try {
+        write_sigmf_meta(meta_path, meta);
+    } catch (...) {
+        fclose(data_file);
+        throw;
+    }
+
+    convert_buf = volk_malloc(CONVERT_LEN * bits / 8, volk_get_alignment());
+}
+
+/*
+ * Our virtual destructor.
+ */
+iq_file_sink_impl::~iq_file_sink_impl()
+{
+    fclose(data_file);
+    volk_free(convert_buf);
+}
+
+bool iq_file_sink_impl::stop()
+{
+    fflush(data_file);
+    write_sigmf_meta(meta_path, meta);
+    return block::stop();
+}
+
+/*
+ * The start of the first frame is noted in the metadata as soon as it is seen, so
+ * that a recording cut short still says where it is in time.
+ */
+void iq_file_sink_impl::find_alfn(int nitems)
+{
+    std::vector<tag_t> tags;
+    uint64_t start = nitems_read(0);
+    get_tags_in_range(tags, 0, start, start + nitems, alfn_tag());
+    if (tags.empty()) {
+        return;
+    }
+
+    const tag_t* first = &tags[0];
+    for (const tag_t& tag : tags) {
+        if (tag.offset < first->offset) {
+            first = &tag;
+        }
+    }
+    meta.has_alfn = true;
+    meta.alfn = pmt::to_uint64(first->value);
+    meta.alfn_sample = first->offset * meta.vlen;
+    write_sigmf_meta(meta_path, meta);
+}
+
+int iq_file_sink_impl::work(int noutput_items,
+                            gr_vector_const_void_star& input_items,
+                            gr_vector_void_star& output_items)
+{
+    const float* in = (const float*)input_items[0];
+
+    if (!meta.has_alfn) {
+        find_alfn(noutput_items);
+    }
+
+    size_t total = (size_t)noutput_items * meta.vlen * 2;
+    for (size_t off = 0; off < total; off += CONVERT_LEN) {
+        int n = std::min<size_t>(CONVERT_LEN, total - off);
+        if (meta.bits == 8) {
+            volk_32f_s32f_convert_8i((int8_t*)convert_buf, in + off, scale, n);
+        } else {
+            volk_32f_s32f_convert_16i((int16_t*)convert_buf, in + off, scale, n);
+        }
+        if (fwrite(convert_buf, meta.bits / 8, n, data_file) != (size_t)n) {
+            throw std::runtime_error("iq_file_sink: Unable to write to " + data_path);
+        }
+    }
+
+    return noutput_items;
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
@@ -0,0 +1,53 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_IQ_FILE_SINK_IMPL_H
+#define INCLUDED_NRSC5_IQ_FILE_SINK_IMPL_H
+
+#include "sigmf.h"
+#include <nrsc5/iq_file_sink.h>
+#include <cstdio>
+
+namespace gr {
+namespace nrsc5 {
+
+class iq_file_sink_impl : public iq_file_sink
+{
+private:
+    static constexpr int CONVERT_LEN = 16384;
+
+    sigmf_meta meta;
+    std::string data_path;
+    std::string meta_path;
+    FILE* data_file;
+    float scale;
+    void* convert_buf;
+
+    void find_alfn(int nitems);
+
+public:
+    iq_file_sink_impl(const std::string& filename,
+                      int bits,
+                      double sample_rate,
+                      int vlen,
+                      float full_scale,
+                      const std::string& mode,
+                      double lsb_power_db,
+                      double usb_power_db);
+    ~iq_file_sink_impl();
+
+    // Where all the action really happens
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+    bool stop() override;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_IQ_FILE_SINK_IMPL_H */
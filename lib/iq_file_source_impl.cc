@@ -0,0 +1,131 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "iq_file_source_impl.h"
+#include "timing.h"
+#include <gnuradio/io_signature.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <volk/volk.h>
+#include <algorithm>
+
+namespace gr {
+namespace nrsc5 {
+
+iq_file_source::sptr iq_file_source::make(const std::string& filename, bool repeat)
+{
+    // The vector length comes from the metadata, so it is read before construction
+    sigmf_meta meta = read_sigmf_meta(sigmf_base(filename) + ".sigmf-meta");
+    return gnuradio::get_initial_sptr(new iq_file_source_impl(filename, repeat, meta));
+}
+
+
+/*
+ * The private constructor
+ */
+iq_file_source_impl::iq_file_source_impl(const std::string& filename,
+                                         bool repeat,
+                                         const sigmf_meta& meta)
+    : gr::sync_block("iq_file_source",
+                     gr::io_signature::make(0, 0, 0),
+                     gr::io_signature::make(1, 1, sizeof(gr_complex) * meta.vlen)),
+      meta(meta)
+{
+    std::string data_path = sigmf_base(filename) + ".sigmf-data";
+    int fd = open(data_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("iq_file_source: Unable to open " + data_path);
+    }
+    item_bytes = (size_t)meta.vlen * 2 * meta.bits / 8;
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < item_bytes)) {
+        close(fd);
+        throw std::runtime_error("iq_file_source: Unable to read " + data_path);
+    }
+    size = st.st_size;
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("iq_file_source: Unable to map " + data_path);
+    }
+    data = (const unsigned char*)map;
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    num_items = size / item_bytes;
+    if (num_items * item_bytes != size) {
+        d_logger->warn("Ignoring truncated item at the end of " + data_path);
+    }
+
+    scale = ((meta.bits == 8) ? INT8_MAX : INT16_MAX) / meta.full_scale;
+    this->repeat = repeat;
+    item = 0;
+    first_pass = true;
+}
+
+/*
+ * Our virtual destructor.
+ */
+iq_file_source_impl::~iq_file_source_impl() { munmap((void*)data, size); }
+
+double iq_file_source_impl::sample_rate() const { return meta.sample_rate; }
+
+int iq_file_source_impl::vlen() const { return meta.vlen; }
+
+std::string iq_file_source_impl::mode() const { return meta.mode; }
+
+int iq_file_source_impl::work(int noutput_items,
+                              gr_vector_const_void_star& input_items,
+                              gr_vector_void_star& output_items)
+{
+    float* out = (float*)output_items[0];
+    uint64_t alfn_item = meta.alfn_sample / meta.vlen;
+
+    int out_off = 0;
+    while (out_off < noutput_items) {
+        if (item == num_items) {
+            if (!repeat) {
+                break;
+            }
+            item = 0;
+            first_pass = false;
+        }
+
+        int n = std::min<uint64_t>(noutput_items - out_off, num_items - item);
+        if (first_pass && meta.has_alfn && (alfn_item >= item) &&
+            (alfn_item < item + n)) {
+            add_item_tag(0,
+                         nitems_written(0) + out_off + (alfn_item - item),
+                         alfn_tag(),
+                         pmt::from_uint64(meta.alfn));
+        }
+
+        float* dst = out + (size_t)out_off * meta.vlen * 2;
+        const unsigned char* src = data + item * item_bytes;
+        unsigned int len = n * meta.vlen * 2;
+        if (meta.bits == 8) {
+            volk_8i_s32f_convert_32f(dst, (const int8_t*)src, scale, len);
+        } else {
+            volk_16i_s32f_convert_32f(dst, (const int16_t*)src, scale, len);
+        }
+        out_off += n;
+        item += n;
+    }
+
+    if ((out_off == 0) && !repeat) {
+        return WORK_DONE;
+    }
+    return out_off;
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
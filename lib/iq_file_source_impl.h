@@ -0,0 +1,48 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_IQ_FILE_SOURCE_IMPL_H
+#define INCLUDED_NRSC5_IQ_FILE_SOURCE_IMPL_H
+
+#include "sigmf.h"
+#include <nrsc5/iq_file_source.h>
+
+namespace gr {
+namespace nrsc5 {
+
+class iq_file_source_impl : public iq_file_source
+{
+private:
+    sigmf_meta meta;
+    const unsigned char* data;
+    size_t size;
+    size_t item_bytes;
+    uint64_t num_items;
+    float scale;
+    bool repeat;
+
+    uint64_t item;
+    bool first_pass;
+
+public:
+    iq_file_source_impl(const std::string& filename, bool repeat, const sigmf_meta& meta);
+    ~iq_file_source_impl();
+
+    double sample_rate() const override;
+    int vlen() const override;
+    std::string mode() const override;
+
+    // Where all the action really happens
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items) override;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_IQ_FILE_SOURCE_IMPL_H */
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2019 Clayton Smith.
+ * Copyright 2019, 2026 Clayton Smith.
  *
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
@@ -8,115 +8,24 @@
 #ifndef INCLUDED_NRSC5_L1_AM_ENCODER_IMPL_H
 #define INCLUDED_NRSC5_L1_AM_ENCODER_IMPL_H
 
+#include <nrsc5/core/l1_am_frame_encoder.h>
 #include <nrsc5/l1_am_encoder.h>
 
 namespace gr {
 namespace nrsc5 {
 
-constexpr int AM_BLOCKS_PER_FRAME = 8;
-constexpr int SYMBOLS_PER_BLOCK = 32;
-constexpr int AM_SYMBOLS_PER_FRAME = 8 * 32;
-constexpr int AM_FFT_SIZE = 256;
-constexpr int SIS_BITS = 80;
-constexpr int DIVERSITY_DELAY = 18000 * 3;
-
-enum class conv_mode { CONV_E1, CONV_E2, CONV_E3 };
-
-/* 1012s.pdf table 12-10 */
-gr_complex bpsk_am[] = { { 0, -0.5 }, { 0, 0.5 } };
-
-/* 1012s.pdf table 12-4 */
-gr_complex qpsk_am[] = { { -0.5, -0.5 },
-                         { 0.5, -0.5 },
-
-                         { -0.5, 0.5 },
-                         { 0.5, 0.5 } };
-
-/* 1012s.pdf table 12-5 */
-gr_complex qam16[] = { { -1.5, -1.5 }, { 1.5, -1.5 }, { -0.5, -1.5 }, { 0.5, -1.5 },
-
-                       { -1.5, 1.5 },  { 1.5, 1.5 },  { -0.5, 1.5 },  { 0.5, 1.5 },
-
-                       { -1.5, -0.5 }, { 1.5, -0.5 }, { -0.5, -0.5 }, { 0.5, -0.5 },
-
-                       { -1.5, 0.5 },  { 1.5, 0.5 },  { -0.5, 0.5 },  { 0.5, 0.5 } };
-
-/* 1012s.pdf table 12-1 */
-gr_complex qam64[] = { { -3.5, -3.5 }, { 3.5, -3.5 }, { -0.5, -3.5 }, { 0.5, -3.5 },
-                       { -2.5, -3.5 }, { 2.5, -3.5 }, { -1.5, -3.5 }, { 1.5, -3.5 },
-
-                       { -3.5, 3.5 },  { 3.5, 3.5 },  { -0.5, 3.5 },  { 0.5, 3.5 },
-                       { -2.5, 3.5 },  { 2.5, 3.5 },  { -1.5, 3.5 },  { 1.5, 3.5 },
-
-                       { -3.5, -0.5 }, { 3.5, -0.5 }, { -0.5, -0.5 }, { 0.5, -0.5 },
-                       { -2.5, -0.5 }, { 2.5, -0.5 }, { -1.5, -0.5 }, { 1.5, -0.5 },
-
-                       { -3.5, 0.5 },  { 3.5, 0.5 },  { -0.5, 0.5 },  { 0.5, 0.5 },
-                       { -2.5, 0.5 },  { 2.5, 0.5 },  { -1.5, 0.5 },  { 1.5, 0.5 },
-
-                       { -3.5, -2.5 }, { 3.5, -2.5 }, { -0.5, -2.5 }, { 0.5, -2.5 },
-                       { -2.5, -2.5 }, { 2.5, -2.5 }, { -1.5, -2.5 }, { 1.5, -2.5 },
-
-                       { -3.5, 2.5 },  { 3.5, 2.5 },  { -0.5, 2.5 },  { 0.5, 2.5 },
-                       { -2.5, 2.5 },  { 2.5, 2.5 },  { -1.5, 2.5 },  { 1.5, 2.5 },
-
-                       { -3.5, -1.5 }, { 3.5, -1.5 }, { -0.5, -1.5 }, { 0.5, -1.5 },
-                       { -2.5, -1.5 }, { 2.5, -1.5 }, { -1.5, -1.5 }, { 1.5, -1.5 },
-
-                       { -3.5, 1.5 },  { 3.5, 1.5 },  { -0.5, 1.5 },  { 0.5, 1.5 },
-                       { -2.5, 1.5 },  { 2.5, 1.5 },  { -1.5, 1.5 },  { 1.5, 1.5 } };
-
-/* 1012s.pdf figure 10-4 */
-int bl_delay[] = { 2, 1, 5 };
-int ml_delay[] = { 11, 6, 7 };
-int bu_delay[] = { 10, 8, 9 };
-int mu_delay[] = { 4, 3, 0 };
-int el_delay[] = { 0, 1 };
-int eu_delay[] = { 2, 3, 5, 4 };
-
-/* 1012s.pdf figure 10-5 */
-int pids_il_delay[] = { 0, 1, 12, 13, 6, 5, 18, 17, 11, 7, 23, 19 };
-int pids_iu_delay[] = { 2, 4, 14, 16, 3, 8, 15, 20, 9, 10, 21, 22 };
+constexpr int AM_BLOCKS_PER_FRAME = l1_am_frame_encoder::BLOCKS_PER_FRAME;
+constexpr int SYMBOLS_PER_BLOCK = l1_am_frame_encoder::SYMBOLS_PER_BLOCK;
+constexpr int AM_SYMBOLS_PER_FRAME = l1_am_frame_encoder::SYMBOLS_PER_FRAME;
+constexpr int AM_FFT_SIZE = l1_am_frame_encoder::FFT_SIZE;
 
 class l1_am_encoder_impl : public l1_am_encoder
 {
 private:
-    int sm;
-    int p1_bits, p1_mod;
-    int p3_bits, p3_mod;
-
-    unsigned char buf[30000];
-    unsigned char pids_g[SIS_BITS * 3];
-    unsigned char p1_g[72000];
-    unsigned char p3_g[72000];
-    unsigned char bl[18000 + DIVERSITY_DELAY], ml[18000];
-    unsigned char bu[18000 + DIVERSITY_DELAY], mu[18000];
-    unsigned char el[12000], eu[24000];
-    unsigned char ebl[18000 + DIVERSITY_DELAY], eml[18000];
-    unsigned char ebu[18000 + DIVERSITY_DELAY], emu[18000];
-    unsigned char parity[512];
-    unsigned char sc_symbols[AM_SYMBOLS_PER_FRAME];
-    unsigned char pu_matrix[25][AM_SYMBOLS_PER_FRAME];
-    unsigned char pl_matrix[25][AM_SYMBOLS_PER_FRAME];
-    unsigned char s_matrix[25][AM_SYMBOLS_PER_FRAME];
-    unsigned char t_matrix[25][AM_SYMBOLS_PER_FRAME];
-    unsigned char pids_matrix[2][AM_SYMBOLS_PER_FRAME];
-    float channel_power[AM_FFT_SIZE];
+    l1_am_frame_encoder encoder;
+    std::vector<l1_channel> channels;
 
-    void reverse_bytes(const unsigned char* in, unsigned char* out, int len);
-    void scramble(unsigned char* buf, int len);
-    void conv_enc(conv_mode mode, const unsigned char* in, unsigned char* out, int len);
-    void
-    encode_l2_pdu(conv_mode mode, const unsigned char* in, unsigned char* out, int len);
-    void bit_map(unsigned char matrix[25][AM_SYMBOLS_PER_FRAME], int b, int k, int bits);
-    void interleaver_ma1();
-    void interleaver_ma3();
-    void interleaver_pids(unsigned char* in,
-                          unsigned char matrix[2][AM_SYMBOLS_PER_FRAME],
-                          int block);
-    void sc_data_seq(
-        unsigned char* out, int pli, int hppi, int abbi, int rdbi, int bc, int smi);
-    void set_channel_power();
+    void forward_pids_tags(int pids_port, int frames);
 
 public:
     l1_am_encoder_impl(const int sm);
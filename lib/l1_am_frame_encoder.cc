@@ -0,0 +1,628 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <nrsc5/core/l1_am_frame_encoder.h>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+constexpr float qam64_power = 10.211893;
+constexpr float qam16_power = 3.979400;
+constexpr float qpsk_power = -3.010300;
+constexpr float bpsk_power = -6.020600;
+
+/* 1012s.pdf table 12-10 */
+gr_complex bpsk_am[] = { { 0, -0.5 }, { 0, 0.5 } };
+
+/* 1012s.pdf table 12-4 */
+gr_complex qpsk_am[] = { { -0.5, -0.5 },
+                         { 0.5, -0.5 },
+
+                         { -0.5, 0.5 },
+                         { 0.5, 0.5 } };
+
+/* 1012s.pdf table 12-5 */
+gr_complex qam16[] = { { -1.5, -1.5 }, { 1.5, -1.5 }, { -0.5, -1.5 }, { 0.5, -1.5 },
+
+                       { -1.5, 1.5 },  { 1.5, 1.5 },  { -0.5, 1.5 },  { 0.5, 1.5 },
+
+                       { -1.5, -0.5 }, { 1.5, -0.5 }, { -0.5, -0.5 }, { 0.5, -0.5 },
+
+                       { -1.5, 0.5 },  { 1.5, 0.5 },  { -0.5, 0.5 },  { 0.5, 0.5 } };
+
+/* 1012s.pdf table 12-1 */
+gr_complex qam64[] = { { -3.5, -3.5 }, { 3.5, -3.5 }, { -0.5, -3.5 }, { 0.5, -3.5 },
+                       { -2.5, -3.5 }, { 2.5, -3.5 }, { -1.5, -3.5 }, { 1.5, -3.5 },
+
+                       { -3.5, 3.5 },  { 3.5, 3.5 },  { -0.5, 3.5 },  { 0.5, 3.5 },
+                       { -2.5, 3.5 },  { 2.5, 3.5 },  { -1.5, 3.5 },  { 1.5, 3.5 },
+
+                       { -3.5, -0.5 }, { 3.5, -0.5 }, { -0.5, -0.5 }, { 0.5, -0.5 },
+                       { -2.5, -0.5 }, { 2.5, -0.5 }, { -1.5, -0.5 }, { 1.5, -0.5 },
+
+                       { -3.5, 0.5 },  { 3.5, 0.5 },  { -0.5, 0.5 },  { 0.5, 0.5 },
+                       { -2.5, 0.5 },  { 2.5, 0.5 },  { -1.5, 0.5 },  { 1.5, 0.5 },
+
+                       { -3.5, -2.5 }, { 3.5, -2.5 }, { -0.5, -2.5 }, { 0.5, -2.5 },
+                       { -2.5, -2.5 }, { 2.5, -2.5 }, { -1.5, -2.5 }, { 1.5, -2.5 },
+
+                       { -3.5, 2.5 },  { 3.5, 2.5 },  { -0.5, 2.5 },  { 0.5, 2.5 },
+                       { -2.5, 2.5 },  { 2.5, 2.5 },  { -1.5, 2.5 },  { 1.5, 2.5 },
+
+                       { -3.5, -1.5 }, { 3.5, -1.5 }, { -0.5, -1.5 }, { 0.5, -1.5 },
+                       { -2.5, -1.5 }, { 2.5, -1.5 }, { -1.5, -1.5 }, { 1.5, -1.5 },
+
+                       { -3.5, 1.5 },  { 3.5, 1.5 },  { -0.5, 1.5 },  { 0.5, 1.5 },
+                       { -2.5, 1.5 },  { 2.5, 1.5 },  { -1.5, 1.5 },  { 1.5, 1.5 } };
+
+/* 1012s.pdf figure 10-4 */
+int bl_delay[] = { 2, 1, 5 };
+int ml_delay[] = { 11, 6, 7 };
+int bu_delay[] = { 10, 8, 9 };
+int mu_delay[] = { 4, 3, 0 };
+int el_delay[] = { 0, 1 };
+int eu_delay[] = { 2, 3, 5, 4 };
+
+/* 1012s.pdf figure 10-5 */
+int pids_il_delay[] = { 0, 1, 12, 13, 6, 5, 18, 17, 11, 7, 23, 19 };
+int pids_iu_delay[] = { 2, 4, 14, 16, 3, 8, 15, 20, 9, 10, 21, 22 };
+
+} // namespace
+
+std::vector<l1_channel> l1_am_frame_encoder::channels(int sm)
+{
+    switch (sm) {
+    case 1:
+        return { { 3750, 8 }, { 24000, 1 }, { L1_PIDS_BITS, BLOCKS_PER_FRAME } };
+    case 3:
+        return { { 3750, 8 }, { 30000, 1 }, { L1_PIDS_BITS, BLOCKS_PER_FRAME } };
+    default:
+        throw std::invalid_argument("Unsupported service mode");
+    }
+}
+
+l1_am_frame_encoder::l1_am_frame_encoder(int sm)
+{
+    if ((sm != 1) && (sm != 3)) {
+        throw std::invalid_argument("Unsupported service mode");
+    }
+    this->sm = sm;
+
+    p1_bits = 3750;
+    p1_mod = 8;
+    p3_bits = 0;
+    p3_mod = 1;
+    switch (sm) {
+    case 1:
+        p3_bits = 24000;
+        break;
+    case 3:
+        p3_bits = 30000;
+        break;
+    }
+
+    for (int i = 0; i < 512; i++) {
+        int tmp = i;
+        parity[i] = 0;
+        while (tmp != 0) {
+            parity[i] ^= 1;
+            tmp &= (tmp - 1);
+        }
+    }
+
+    for (int bc = 0; bc < BLOCKS_PER_FRAME; bc++) {
+        sc_data_seq(
+            sc_symbols + (bc * SYMBOLS_PER_BLOCK), 0, 0, 0, 0, bc, sm == 1 ? 1 : 2);
+    }
+
+    set_channel_power();
+    memset(bl, 0, DIVERSITY_DELAY);
+    memset(bu, 0, DIVERSITY_DELAY);
+    memset(ebl, 0, DIVERSITY_DELAY);
+    memset(ebu, 0, DIVERSITY_DELAY);
+}
+
+void l1_am_frame_encoder::encode_frame(const unsigned char* const* inputs,
+                                       gr_complex* out)
+{
+    encode_bits(inputs);
+    for (int symbol = 0; symbol < SYMBOLS_PER_FRAME; symbol++) {
+        map_symbol(symbol, out);
+        out += FFT_SIZE;
+    }
+}
+
+/*
+ * The subcarrier levels of table 4-6 are not exact in fixed point, so each symbol is
+ * mapped as above and rounded once to Q14. The weakest subcarriers (-50 dBc QPSK)
+ * still get about 37 steps per axis.
+ */
+void l1_am_frame_encoder::encode_frame(const unsigned char* const* inputs, sc16_t* out)
+{
+    gr_complex row[FFT_SIZE];
+
+    encode_bits(inputs);
+    for (int symbol = 0; symbol < SYMBOLS_PER_FRAME; symbol++) {
+        map_symbol(symbol, row);
+        for (int i = 0; i < FFT_SIZE; i++) {
+            out[i] = sc16_t(std::lround(row[i].real() * L1_SC16_ONE),
+                            std::lround(row[i].imag() * L1_SC16_ONE));
+        }
+        out += FFT_SIZE;
+    }
+}
+
+/* Coding and interleaving, up to the point where subcarrier values are chosen */
+void l1_am_frame_encoder::encode_bits(const unsigned char* const* inputs)
+{
+    const unsigned char* p1 = inputs[0];
+    const unsigned char* p3 = inputs[1];
+    const unsigned char* pids = inputs[2];
+
+    int pids_off = 0, p1_off = 0;
+    for (int block = 0; block < BLOCKS_PER_FRAME; block++) {
+        encode_l2_pdu(
+            conv_mode::CONV_E1, p1 + p1_off, p1_g + p1_off * 12 / 5, p1_bits);
+        encode_l2_pdu(conv_mode::CONV_E3, pids + pids_off, pids_g, L1_PIDS_BITS);
+        interleaver_pids(pids_g, pids_matrix, block);
+        p1_off += p1_bits;
+        pids_off += L1_PIDS_BITS;
+    }
+    switch (sm) {
+    case 1:
+        encode_l2_pdu(conv_mode::CONV_E2, p3, p3_g, p3_bits);
+        interleaver_ma1();
+        break;
+    case 3:
+        encode_l2_pdu(conv_mode::CONV_E1, p3, p3_g, p3_bits);
+        interleaver_ma3();
+        break;
+    }
+}
+
+/* Writes the FFT_SIZE subcarriers of one symbol of the frame */
+void l1_am_frame_encoder::map_symbol(int symbol, gr_complex* out)
+{
+    for (int i = 0; i < FFT_SIZE; i++) {
+        out[i] = 0;
+    }
+
+    for (int col = 0; col < 25; col++) {
+        switch (sm) {
+        case 1:
+            /* 1012s.pdf table 12-2 */
+            out[128 - 57 - col] = -std::conj(qam64[pl_matrix[col][symbol]]);
+            out[128 + 57 + col] = qam64[pu_matrix[col][symbol]];
+
+            /* 1012s.pdf table 12-6 */
+            out[128 + 2 + col] = qpsk_am[t_matrix[col][symbol]];
+            out[128 + 28 + col] = qam16[s_matrix[col][symbol]];
+            out[128 - 2 - col] = -std::conj(qpsk_am[t_matrix[col][symbol]]);
+            out[128 - 28 - col] = -std::conj(qam16[s_matrix[col][symbol]]);
+            break;
+        case 3:
+            /* 1012s.pdf table 12-3 */
+            out[128 - 2 - col] = -std::conj(qam64[pl_matrix[col][symbol]]);
+            out[128 + 2 + col] = qam64[pu_matrix[col][symbol]];
+
+            /* 1012s.pdf table 12-8 */
+            out[128 - 28 - col] = -std::conj(qam64[t_matrix[col][symbol]]);
+            out[128 + 28 + col] = qam64[s_matrix[col][symbol]];
+            break;
+        }
+    }
+
+    gr_complex pids_point_0 = qam16[pids_matrix[0][symbol]];
+    gr_complex pids_point_1 = qam16[pids_matrix[1][symbol]];
+    switch (sm) {
+    case 1:
+        /* 1012s.pdf table 12-7 */
+        out[128 - 27] = -std::conj(pids_point_0);
+        out[128 - 53] = -std::conj(pids_point_1);
+        out[128 + 27] = pids_point_0;
+        out[128 + 53] = pids_point_1;
+        break;
+    case 3:
+        /* 1012s.pdf table 12-9 */
+        out[128 - 27] = -std::conj(pids_point_0);
+        out[128 + 27] = pids_point_1;
+        break;
+    }
+
+    /* 1012s.pdf table 12-12 */
+    gr_complex sc_point = bpsk_am[sc_symbols[symbol]];
+    out[128 - 1] = sc_point;
+    out[128 + 1] = sc_point;
+
+    for (int i = 0; i < FFT_SIZE; i++) {
+        out[i] *= channel_power[i];
+    }
+}
+
+void l1_am_frame_encoder::reverse_bytes(const unsigned char* in,
+                                        unsigned char* out,
+                                        int len)
+{
+    for (int off = 0; off < len; off += 8) {
+        int bits = (len - off < 8) ? len - off : 8;
+        for (int i = 0; i < bits; i++) {
+            out[off + i] = in[off + bits - 1 - i];
+        }
+    }
+}
+
+/* 1012s.pdf section 8.1 */
+void l1_am_frame_encoder::scramble(unsigned char* buf, int len)
+{
+    unsigned int reg = 0x3ff;
+    for (int off = 0; off < len; off++) {
+        unsigned char next_bit = ((reg >> 9) ^ reg) & 1;
+        buf[off] ^= next_bit;
+        reg = (reg >> 1) | (next_bit << 10);
+    }
+}
+
+/* 1012s.pdf section 9.1 */
+void l1_am_frame_encoder::conv_enc(conv_mode mode,
+                                   const unsigned char* in,
+                                   unsigned char* out,
+                                   int len)
+{
+    unsigned int poly_e1[] = { 0561, 0657, 0711 };
+    unsigned int poly_e2[] = { 0561, 0753, 0711 };
+    unsigned int poly_e3[] = { 0561, 0753, 0711 };
+    unsigned int* poly;
+
+    switch (mode) {
+    case conv_mode::CONV_E1:
+        poly = poly_e1;
+        break;
+    case conv_mode::CONV_E2:
+        poly = poly_e2;
+        break;
+    case conv_mode::CONV_E3:
+        poly = poly_e3;
+        break;
+    }
+
+    unsigned int reg = (in[len - 8] << 1) | (in[len - 7] << 2) | (in[len - 6] << 3) |
+                       (in[len - 5] << 4) | (in[len - 4] << 5) | (in[len - 3] << 6) |
+                       (in[len - 2] << 7) | (in[len - 1] << 8);
+    int out_off = 0;
+    for (int in_off = 0; in_off < len; in_off++) {
+        reg = (reg >> 1) | (in[in_off] << 8);
+        for (int i = 0; i < 3; i++) {
+            bool use;
+            switch (mode) {
+            case conv_mode::CONV_E1:
+                use = (i == 0) || (i == 2) || (in_off % 5 >= 3);
+                break;
+            case conv_mode::CONV_E2:
+                use = (i == 0) || ((i == 2) && (in_off % 2 == 0));
+                break;
+            case conv_mode::CONV_E3:
+                use = true;
+                break;
+            }
+            if (use) {
+                out[out_off++] = parity[reg & poly[i]];
+            }
+        }
+    }
+}
+
+void l1_am_frame_encoder::encode_l2_pdu(conv_mode mode,
+                                        const unsigned char* in,
+                                        unsigned char* out,
+                                        int len)
+{
+    reverse_bytes(in, buf, len);
+    scramble(buf, len);
+    conv_enc(mode, buf, out, len);
+}
+
+void l1_am_frame_encoder::bit_map(unsigned char matrix[25][SYMBOLS_PER_FRAME],
+                                  int b,
+                                  int k,
+                                  int bits)
+{
+    int col = (9 * k) % 25;
+    int row = (11 * col + 16 * (k / 25) + 11 * (k / 50)) % 32;
+    matrix[col][b * SYMBOLS_PER_BLOCK + row] |= bits;
+}
+
+void l1_am_frame_encoder::interleaver_ma1()
+{
+    memset(pu_matrix, 0, 25 * SYMBOLS_PER_FRAME);
+    memset(pl_matrix, 0, 25 * SYMBOLS_PER_FRAME);
+    memset(s_matrix, 0, 25 * SYMBOLS_PER_FRAME);
+    memset(t_matrix, 0, 25 * SYMBOLS_PER_FRAME);
+
+    for (int i = 0; i < 6000; i++) {
+        for (int j = 0; j < 3; j++) {
+            bl[DIVERSITY_DELAY + i * 3 + j] = p1_g[i * 12 + bl_delay[j]];
+            ml[i * 3 + j] = p1_g[i * 12 + ml_delay[j]];
+            bu[DIVERSITY_DELAY + i * 3 + j] = p1_g[i * 12 + bu_delay[j]];
+            mu[i * 3 + j] = p1_g[i * 12 + mu_delay[j]];
+        }
+        for (int j = 0; j < 2; j++) {
+            el[i * 2 + j] = p3_g[i * 6 + el_delay[j]];
+        }
+        for (int j = 0; j < 4; j++) {
+            eu[i * 4 + j] = p3_g[i * 6 + eu_delay[j]];
+        }
+    }
+
+    int b, k, p;
+    for (int n = 0; n < 18000; n++) {
+        b = n / 2250;
+        k = (n + n / 750 + 1) % 750;
+        p = n % 3;
+        bit_map(pl_matrix, b, k, bl[n] << p);
+
+        b = (3 * n + 3) % 8;
+        k = (n + n / 3000 + 3) % 750;
+        p = 3 + (n % 3);
+        bit_map(pl_matrix, b, k, ml[n] << p);
+
+        b = n / 2250;
+        k = (n + n / 750) % 750;
+        p = n % 3;
+        bit_map(pu_matrix, b, k, bu[n] << p);
+
+        b = (3 * n) % 8;
+        k = (n + n / 3000 + 2) % 750;
+        p = 3 + (n % 3);
+        bit_map(pu_matrix, b, k, mu[n] << p);
+    }
+    for (int n = 0; n < 12000; n++) {
+        b = (3 * n + n / 3000) % 8;
+        k = (n + (n / 6000)) % 750;
+        p = n % 2;
+        bit_map(t_matrix, b, k, el[n] << p);
+    }
+    for (int n = 0; n < 24000; n++) {
+        b = (3 * n + n / 3000 + 2 * (n / 12000)) % 8;
+        k = (n + (n / 6000)) % 750;
+        p = n % 4;
+        bit_map(s_matrix, b, k, eu[n] << p);
+    }
+
+    /* training symbols */
+    for (int block = 0; block < BLOCKS_PER_FRAME; block++) {
+        for (int k = 750; k < 800; k++) {
+            bit_map(pu_matrix, block, k, 0b100101);
+            bit_map(pl_matrix, block, k, 0b100101);
+            bit_map(s_matrix, block, k, 0b1001);
+            bit_map(t_matrix, block, k, 0b10);
+        }
+    }
+
+    memmove(bl, bl + 18000, DIVERSITY_DELAY);
+    memmove(bu, bu + 18000, DIVERSITY_DELAY);
+}
+
+void l1_am_frame_encoder::interleaver_ma3()
+{
+    memset(pu_matrix, 0, 25 * SYMBOLS_PER_FRAME);
+    memset(pl_matrix, 0, 25 * SYMBOLS_PER_FRAME);
+    memset(s_matrix, 0, 25 * SYMBOLS_PER_FRAME);
+    memset(t_matrix, 0, 25 * SYMBOLS_PER_FRAME);
+
+    for (int i = 0; i < 6000; i++) {
+        for (int j = 0; j < 3; j++) {
+            bl[DIVERSITY_DELAY + i * 3 + j] = p1_g[i * 12 + bl_delay[j]];
+            ml[i * 3 + j] = p1_g[i * 12 + ml_delay[j]];
+            bu[DIVERSITY_DELAY + i * 3 + j] = p1_g[i * 12 + bu_delay[j]];
+            mu[i * 3 + j] = p1_g[i * 12 + mu_delay[j]];
+
+            ebl[DIVERSITY_DELAY + i * 3 + j] = p3_g[i * 12 + bl_delay[j]];
+            eml[i * 3 + j] = p3_g[i * 12 + ml_delay[j]];
+            ebu[DIVERSITY_DELAY + i * 3 + j] = p3_g[i * 12 + bu_delay[j]];
+            emu[i * 3 + j] = p3_g[i * 12 + mu_delay[j]];
+        }
+    }
+
+    int b, k, p;
+    for (int n = 0; n < 18000; n++) {
+        b = n / 2250;
+        k = (n + n / 750 + 1) % 750;
+        p = n % 3;
+        bit_map(pl_matrix, b, k, bl[n] << p);
+
+        b = (3 * n + 3) % 8;
+        k = (n + n / 3000 + 3) % 750;
+        p = 3 + (n % 3);
+        bit_map(pl_matrix, b, k, ml[n] << p);
+
+        b = n / 2250;
+        k = (n + n / 750) % 750;
+        p = n % 3;
+        bit_map(pu_matrix, b, k, bu[n] << p);
+
+        b = (3 * n) % 8;
+        k = (n + n / 3000 + 2) % 750;
+        p = 3 + (n % 3);
+        bit_map(pu_matrix, b, k, mu[n] << p);
+
+        b = (3 * n + 3) % 8;
+        k = (n + n / 3000 + 3) % 750;
+        p = n % 3;
+        bit_map(t_matrix, b, k, ebl[n] << p);
+
+        b = (3 * n + 3) % 8;
+        k = (n + n / 3000 + 3) % 750;
+        p = 3 + (n % 3);
+        bit_map(t_matrix, b, k, eml[n] << p);
+
+        b = (3 * n) % 8;
+        k = (n + n / 3000 + 2) % 750;
+        p = n % 3;
+        bit_map(s_matrix, b, k, ebu[n] << p);
+
+        b = (3 * n) % 8;
+        k = (n + n / 3000 + 2) % 750;
+        p = 3 + (n % 3);
+        bit_map(s_matrix, b, k, emu[n] << p);
+    }
+
+    /* training symbols */
+    for (int block = 0; block < BLOCKS_PER_FRAME; block++) {
+        for (int k = 750; k < 800; k++) {
+            bit_map(pu_matrix, block, k, 0b100101);
+            bit_map(pl_matrix, block, k, 0b100101);
+            bit_map(s_matrix, block, k, 0b100101);
+            bit_map(t_matrix, block, k, 0b100101);
+        }
+    }
+
+    memmove(bl, bl + 18000, DIVERSITY_DELAY);
+    memmove(bu, bu + 18000, DIVERSITY_DELAY);
+    memmove(ebl, ebl + 18000, DIVERSITY_DELAY);
+    memmove(ebu, ebu + 18000, DIVERSITY_DELAY);
+}
+
+void l1_am_frame_encoder::interleaver_pids(unsigned char* in,
+                                           unsigned char matrix[2][SYMBOLS_PER_FRAME],
+                                           int block)
+{
+    unsigned char il[120], iu[120];
+    int offset = block * SYMBOLS_PER_BLOCK;
+
+    memset(matrix[0] + offset, 0, SYMBOLS_PER_BLOCK);
+    memset(matrix[1] + offset, 0, SYMBOLS_PER_BLOCK);
+
+    /* 1012s.pdf figure 10-5 */
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 12; j++) {
+            il[i * 12 + j] = in[i * 24 + pids_il_delay[j]];
+            iu[i * 12 + j] = in[i * 24 + pids_iu_delay[j]];
+        }
+    }
+    /* 1012s.pdf section 10.4 */
+    for (int n = 0; n < 120; n++) {
+        int k, p, row;
+
+        p = n % 4;
+
+        k = (n + (n / 60) + 11) % 30;
+        row = (11 * (k + (k / 15)) + 3) % 32;
+        matrix[0][offset + row] |= (il[n] << p);
+
+        k = (n + (n / 60)) % 30;
+        row = (11 * (k + (k / 15)) + 3) % 32;
+        matrix[1][offset + row] |= (iu[n] << p);
+    }
+    matrix[0][offset + 8] = 0b1001;
+    matrix[0][offset + 24] = 0b1001;
+    matrix[1][offset + 8] = 0b1001;
+    matrix[1][offset + 24] = 0b1001;
+}
+
+/* 1012s.pdf table 11-1 */
+void l1_am_frame_encoder::sc_data_seq(
+    unsigned char* out, int pli, int hppi, int abbi, int rdbi, int bc, int smi)
+{
+    out[0] = 0; // sync
+    out[1] = 1; // sync
+    out[2] = 1; // sync
+    out[3] = 0; // sync
+    out[4] = 0; // sync
+    out[5] = 1; // sync
+    out[6] = 0; // sync
+
+    out[7] = pli;    // power level indicator
+    out[8] = out[7]; // parity
+
+    out[9] = 1; // sync
+
+    out[10] = 0;                           // reserved
+    out[11] = hppi;                        // high power pids indicator
+    out[12] = abbi;                        // analog audio bandwidth indicator
+    out[13] = out[10] ^ out[11] ^ out[12]; // parity
+
+    out[14] = 0; // sync
+
+    out[15] = rdbi; // reduced digital bandwidth indicator
+    out[16] = 0;    // reserved
+    out[17] = (bc & 0x4) >> 2;
+    out[18] = (bc & 0x2) >> 1;
+    out[19] = (bc & 0x1);
+    out[20] = out[15] ^ out[16] ^ out[17] ^ out[18] ^ out[19]; // parity
+
+    out[21] = 1; // sync
+    out[22] = 1; // sync
+
+    out[23] = 0; // reserved
+    out[24] = 0; // reserved
+    out[25] = 0; // reserved
+    out[26] = (smi & 0x10) >> 4;
+    out[27] = (smi & 0x08) >> 3;
+    out[28] = (smi & 0x04) >> 2;
+    out[29] = (smi & 0x02) >> 1;
+    out[30] = (smi & 0x01);
+    out[31] = out[23] ^ out[24] ^ out[25] ^ out[26] ^ out[27] ^ out[28] ^ out[29] ^
+              out[30]; // parity
+}
+
+void l1_am_frame_encoder::set_channel_power()
+{
+    for (int i = 0; i < FFT_SIZE; i++) {
+        channel_power[i] = -INFINITY;
+    }
+
+    // Table 4-6 from 1082s.pdf
+    switch (sm) {
+    case 1:
+        for (int col = 0; col < 25; col++) {
+            channel_power[128 + 57 + col] = -30 - qam64_power;
+            channel_power[128 - 57 - col] = -30 - qam64_power;
+
+            channel_power[128 + 28 + col] = -43 - qam16_power;
+            channel_power[128 - 28 - col] = -43 - qam16_power;
+
+            channel_power[128 + 2 + col] = (col < 12 ? (-44 - 0.5 * col) : -50) - qpsk_power;
+            channel_power[128 - 2 - col] = (col < 12 ? (-44 - 0.5 * col) : -50) - qpsk_power;
+        }
+
+        channel_power[128 + 1] = -26 - bpsk_power;
+        channel_power[128 - 1] = -26 - bpsk_power;
+
+        channel_power[128 + 27] = -43 - qam16_power;
+        channel_power[128 - 27] = -43 - qam16_power;
+        channel_power[128 + 53] = -43 - qam16_power;
+        channel_power[128 - 53] = -43 - qam16_power;
+        break;
+    case 3:
+        for (int col = 0; col < 25; col++) {
+            channel_power[128 + 2 + col] = -15 - qam64_power;
+            channel_power[128 - 2 - col] = -15 - qam64_power;
+
+            channel_power[128 + 28 + col] = -30 - qam64_power;
+            channel_power[128 - 28 - col] = -30 - qam64_power;
+        }
+
+        channel_power[128 + 1] = -15 - bpsk_power;
+        channel_power[128 - 1] = -15 - bpsk_power;
+
+        channel_power[128 + 27] = -30 - qam16_power;
+        channel_power[128 - 27] = -30 - qam16_power;
+        break;
+    }
+
+    for (int i = 0; i < FFT_SIZE; i++) {
+        channel_power[i] = pow(10, channel_power[i] / 20);
+    }
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
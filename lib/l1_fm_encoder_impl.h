@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2017 Clayton Smith.
+ * Copyright 2017, 2026 Clayton Smith.
  *
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
@@ -8,113 +8,24 @@
 #ifndef INCLUDED_NRSC5_L1_FM_ENCODER_IMPL_H
 #define INCLUDED_NRSC5_L1_FM_ENCODER_IMPL_H
 
+#include <nrsc5/core/l1_fm_frame_encoder.h>
 #include <nrsc5/l1_fm_encoder.h>
 
 namespace gr {
 namespace nrsc5 {
 
-constexpr int FM_BLOCKS_PER_FRAME = 16;
-constexpr int SYMBOLS_PER_BLOCK = 32;
-constexpr int FM_SYMBOLS_PER_FRAME = 16 * 32;
-constexpr int FM_FFT_SIZE = 2048;
-constexpr int SIS_BITS = 80;
-constexpr int FM_P1_BITS = 146176;
-
-enum class conv_mode { CONV_2_5, CONV_1_2 };
-
-/* 1011s.pdf table 12-1 */
-gr_complex qpsk_fm[] = { { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } };
-
-/* 1012s.pdf table 12-2 */
-gr_complex bpsk_fm[] = { { -1, -1 }, { 1, 1 } };
-
-unsigned char V_PM[] = { 10, 2, 18, 6, 14, 8, 16, 0, 12, 4,
-                         11, 3, 19, 7, 15, 9, 17, 1, 13, 5 };
-unsigned char V_PX2_MP5[] = { 0, 1, 2, 3 };
-unsigned char V_PX2_MP6[] = { 0, 1, 3, 2, 4, 5, 7, 6 };
-unsigned char V_SM[] = { 19, 7, 11, 3, 15, 1, 13, 9, 17, 5,
-                         18, 6, 10, 2, 14, 0, 12, 8, 16, 4 };
-unsigned char V_SB[] = { 27, 7, 19, 12, 3, 23, 10, 1, 21, 9, 14, 25, 5, 17,
-                         26, 6, 18, 13, 2, 22, 11, 0, 20, 8, 15, 24, 4, 16 };
-unsigned char V_SP[] = { 1, 0 };
-int REF_SC_CHAN[] = { 478,  497,  516,  535,  554,  573,  592,  611,  630,  649,  668,
-                      687,  706,  725,  744,  745,  758,  777,  796,  815,  834,  853,
-                      872,  891,  910,  929,  948,  967,  986,  1005, 1024, 1043, 1062,
-                      1081, 1100, 1119, 1138, 1157, 1176, 1195, 1214, 1233, 1252, 1271,
-                      1290, 1303, 1304, 1323, 1342, 1361, 1380, 1399, 1418, 1437, 1456,
-                      1475, 1494, 1513, 1532, 1551, 1570 };
-int REF_SC_ID[] = { 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2,
-                    1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3,
-                    0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2 };
+constexpr int FM_BLOCKS_PER_FRAME = l1_fm_frame_encoder::BLOCKS_PER_FRAME;
+constexpr int SYMBOLS_PER_BLOCK = l1_fm_frame_encoder::SYMBOLS_PER_BLOCK;
+constexpr int FM_SYMBOLS_PER_FRAME = l1_fm_frame_encoder::SYMBOLS_PER_FRAME;
+constexpr int FM_FFT_SIZE = l1_fm_frame_encoder::FFT_SIZE;
 
 class l1_fm_encoder_impl : public l1_fm_encoder
 {
 private:
-    int psm;
-    int p1_bits, p1_mod;
-    int p2_bits, p2_mod;
-    int p3_bits, p3_mod;
-    int p4_bits, p4_mod;
-
-    int ssm;
-
-    unsigned char buf[FM_P1_BITS];
-    unsigned char pids_g[SIS_BITS * 5 / 2 * FM_BLOCKS_PER_FRAME];
-    unsigned char p1_g[FM_P1_BITS * 5 / 2];
-    unsigned char* p3_p4_g;
-    int p1_prime_off;
-    unsigned char* p1_prime;
-    unsigned char* p1_prime_g;
-    unsigned char pm_matrix[FM_SYMBOLS_PER_FRAME * 20 * 36];
-    unsigned char* px1_matrix;
-    unsigned char* px2_matrix;
-    unsigned char* px1_internal;
-    unsigned char* px2_internal;
-    int internal_half;
-    unsigned char parity[128];
-    unsigned char primary_sc_symbols[4][FM_SYMBOLS_PER_FRAME];
-    unsigned char secondary_sc_symbols[4][FM_SYMBOLS_PER_FRAME];
+    l1_fm_frame_encoder encoder;
+    std::vector<l1_channel> channels;
 
-    void reverse_bytes(const unsigned char* in, unsigned char* out, int len);
-    void scramble(unsigned char* buf, int len);
-    void conv_enc(conv_mode mode, const unsigned char* in, unsigned char* out, int len);
-    void
-    encode_l2_pdu(conv_mode mode, const unsigned char* in, unsigned char* out, int len);
-    void interleaver_i(unsigned char* in,
-                       unsigned char* matrix,
-                       int J,
-                       int B,
-                       int C,
-                       int M,
-                       unsigned char* V,
-                       int N);
-    void interleaver_ii(unsigned char* in,
-                        unsigned char* matrix,
-                        int J,
-                        int B,
-                        int C,
-                        int M,
-                        unsigned char* V,
-                        int b,
-                        int I0,
-                        int N);
-    void interleaver_iii(unsigned char* in,
-                         unsigned char* matrix,
-                         int J,
-                         int B,
-                         int C,
-                         int M,
-                         unsigned char* V,
-                         int N);
-    void interleaver_iv(unsigned char* matrix, unsigned char* internal, int half);
-    void write_symbol(unsigned char* matrix_row,
-                      gr_complex* out_row,
-                      int* channels,
-                      int num_channels);
-    void primary_sc_data_seq(unsigned char* out, int scid, int sci, int bc, int psmi);
-    void secondary_sc_data_seq(unsigned char* out, int scid, int bc, int ssmi);
-    void differential_encode(unsigned char* buf);
-    int partitions_per_band();
+    void forward_pids_tags(int pids_port, int frames);
 
 public:
     l1_fm_encoder_impl(const int psm, const int ssm);
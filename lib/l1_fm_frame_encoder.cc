@@ -0,0 +1,632 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <nrsc5/core/l1_fm_frame_encoder.h>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+/* 1011s.pdf table 12-1 */
+gr_complex qpsk_fm[] = { { -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 } };
+
+/* 1012s.pdf table 12-2 */
+gr_complex bpsk_fm[] = { { -1, -1 }, { 1, 1 } };
+
+/* The same constellations in Q14, which represents them exactly */
+constexpr int16_t ONE = L1_SC16_ONE;
+sc16_t qpsk_fm_sc16[] = { { -ONE, -ONE }, { -ONE, ONE }, { ONE, -ONE }, { ONE, ONE } };
+sc16_t bpsk_fm_sc16[] = { { -ONE, -ONE }, { ONE, ONE } };
+
+const gr_complex* qpsk_table(const gr_complex*) { return qpsk_fm; }
+const sc16_t* qpsk_table(const sc16_t*) { return qpsk_fm_sc16; }
+const gr_complex* bpsk_table(const gr_complex*) { return bpsk_fm; }
+const sc16_t* bpsk_table(const sc16_t*) { return bpsk_fm_sc16; }
+
+unsigned char V_PM[] = { 10, 2, 18, 6, 14, 8, 16, 0, 12, 4,
+                         11, 3, 19, 7, 15, 9, 17, 1, 13, 5 };
+unsigned char V_PX2_MP5[] = { 0, 1, 2, 3 };
+unsigned char V_PX2_MP6[] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+int REF_SC_CHAN[] = { 478,  497,  516,  535,  554,  573,  592,  611,  630,  649,  668,
+                      687,  706,  725,  744,  745,  758,  777,  796,  815,  834,  853,
+                      872,  891,  910,  929,  948,  967,  986,  1005, 1024, 1043, 1062,
+                      1081, 1100, 1119, 1138, 1157, 1176, 1195, 1214, 1233, 1252, 1271,
+                      1290, 1303, 1304, 1323, 1342, 1361, 1380, 1399, 1418, 1437, 1456,
+                      1475, 1494, 1513, 1532, 1551, 1570 };
+int REF_SC_ID[] = { 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 3, 2,
+                    1, 0, 3, 2, 1, 0, 3, 2, 1, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3,
+                    0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2 };
+
+} // namespace
+
+std::vector<l1_channel> l1_fm_frame_encoder::channels(int psm)
+{
+    switch (psm) {
+    case 1:
+        return { { 146176, 1 }, { L1_PIDS_BITS, BLOCKS_PER_FRAME } };
+    case 2:
+        return { { 146176, 1 }, { 2304, 8 }, { L1_PIDS_BITS, BLOCKS_PER_FRAME } };
+    case 3:
+        return { { 146176, 1 }, { 4608, 8 }, { L1_PIDS_BITS, BLOCKS_PER_FRAME } };
+    case 11:
+        return { { 146176, 1 },
+                 { 4608, 8 },
+                 { 4608, 8 },
+                 { L1_PIDS_BITS, BLOCKS_PER_FRAME } };
+    case 5:
+        return { { 4608, 8 },
+                 { 109312, 1 },
+                 { 4608, 8 },
+                 { L1_PIDS_BITS, BLOCKS_PER_FRAME } };
+    case 6:
+        return { { 9216, 8 }, { 72448, 1 }, { L1_PIDS_BITS, BLOCKS_PER_FRAME } };
+    default:
+        throw std::invalid_argument("Unsupported service mode");
+    }
+}
+
+l1_fm_frame_encoder::l1_fm_frame_encoder(int psm, int ssm)
+{
+    this->psm = psm;
+    this->ssm = ssm;
+
+    p1_bits = 0;
+    p2_bits = 0;
+    p3_bits = 0;
+    p4_bits = 0;
+    p1_mod = 1;
+    p2_mod = 1;
+    p3_mod = 8;
+    p4_mod = 8;
+    switch (psm) {
+    case 1:
+        p1_bits = 146176;
+        break;
+    case 2:
+        p1_bits = 146176;
+        p3_bits = 2304;
+        break;
+    case 3:
+        p1_bits = 146176;
+        p3_bits = 4608;
+        break;
+    case 11:
+        p1_bits = 146176;
+        p3_bits = 4608;
+        p4_bits = 4608;
+        break;
+    case 5:
+        p1_bits = 4608;
+        p1_mod = 8;
+        p2_bits = 109312;
+        p3_bits = 4608;
+        break;
+    case 6:
+        p1_bits = 9216;
+        p1_mod = 8;
+        p2_bits = 72448;
+        break;
+    default:
+        throw std::invalid_argument("Unsupported service mode");
+    }
+
+    // Delay lines are read before they are first filled, so they start out zeroed
+    if (p1_mod == 8) {
+        p1_prime_off = 0;
+        p1_prime = (unsigned char*)calloc(p1_bits * p1_mod * 3, 1);
+        p1_prime_g = (unsigned char*)malloc(p1_bits * 2 * p1_mod);
+        px2_matrix = (unsigned char*)malloc(p1_bits * 2 * p1_mod);
+    }
+    if (p3_bits) {
+        p3_p4_g = (unsigned char*)malloc(p3_bits * 2 * p3_mod);
+        px1_matrix = (unsigned char*)malloc(p3_bits * 2 * p3_mod);
+        px1_internal = (unsigned char*)calloc(p3_bits * 2 * p3_mod * 2, 1);
+    }
+    if (p4_bits) {
+        px2_matrix = (unsigned char*)malloc(p4_bits * 2 * p4_mod);
+        px2_internal = (unsigned char*)calloc(p4_bits * 2 * p4_mod * 2, 1);
+    }
+    internal_half = 0;
+
+    for (int i = 0; i < 128; i++) {
+        int tmp = i;
+        parity[i] = 0;
+        while (tmp != 0) {
+            parity[i] ^= 1;
+            tmp &= (tmp - 1);
+        }
+    }
+
+    for (int scid = 0; scid < 4; scid++) {
+        for (int bc = 0; bc < BLOCKS_PER_FRAME; bc++) {
+            primary_sc_data_seq(primary_sc_symbols[scid] + (bc * SYMBOLS_PER_BLOCK),
+                                scid,
+                                ssm ? 1 : 0,
+                                bc,
+                                psm);
+            secondary_sc_data_seq(
+                secondary_sc_symbols[scid] + (bc * SYMBOLS_PER_BLOCK), scid, bc, ssm);
+        }
+    }
+}
+
+l1_fm_frame_encoder::~l1_fm_frame_encoder()
+{
+    if (p1_mod == 8) {
+        free(p1_prime);
+        free(p1_prime_g);
+        free(px2_matrix);
+    }
+    if (p3_bits) {
+        free(p3_p4_g);
+        free(px1_matrix);
+        free(px1_internal);
+    }
+    if (p4_bits) {
+        free(px2_matrix);
+        free(px2_internal);
+    }
+}
+
+void l1_fm_frame_encoder::encode_frame(const unsigned char* const* inputs,
+                                       gr_complex* out)
+{
+    encode_bits(inputs);
+    map_symbols(out);
+}
+
+void l1_fm_frame_encoder::encode_frame(const unsigned char* const* inputs, sc16_t* out)
+{
+    encode_bits(inputs);
+    map_symbols(out);
+}
+
+/* Coding and interleaving, up to the point where subcarrier values are chosen */
+void l1_fm_frame_encoder::encode_bits(const unsigned char* const* inputs)
+{
+    int port = 0;
+    const unsigned char *p1 = NULL, *p2 = NULL, *p3 = NULL, *p4 = NULL;
+
+    if (p1_bits)
+        p1 = inputs[port++];
+    if (p2_bits)
+        p2 = inputs[port++];
+    if (p3_bits)
+        p3 = inputs[port++];
+    if (p4_bits)
+        p4 = inputs[port++];
+    const unsigned char* pids = inputs[port++];
+
+    int pids_off = 0, p1_off = 0, p2_off = 0, p3_off = 0, p4_off = 0;
+    for (int i = 0; i < BLOCKS_PER_FRAME; i++) {
+        encode_l2_pdu(conv_mode::CONV_2_5,
+                      pids + pids_off,
+                      pids_g + (L1_PIDS_BITS * 5 / 2 * i),
+                      L1_PIDS_BITS);
+        pids_off += L1_PIDS_BITS;
+    }
+
+    if (p1_mod == 1) {
+        encode_l2_pdu(conv_mode::CONV_2_5, p1 + p1_off, p1_g, p1_bits);
+        p1_off += p1_bits;
+    } else {
+        for (int i = 0; i < p1_mod; i++) {
+            encode_l2_pdu(conv_mode::CONV_2_5,
+                          p1 + p1_off,
+                          p1_g + (p1_bits * 5 / 2 * i),
+                          p1_bits);
+            encode_l2_pdu(conv_mode::CONV_1_2,
+                          p1_prime + p1_prime_off,
+                          p1_prime_g + (p1_bits * 2 * i),
+                          p1_bits);
+
+            if (psm == 5) {
+                interleaver_i(p1_prime_g + (p1_bits * 2 * i),
+                              px2_matrix + (p1_bits * 2 * i),
+                              4,
+                              2,
+                              36,
+                              2,
+                              V_PX2_MP5,
+                              9216);
+            } else {
+                interleaver_i(p1_prime_g + (p1_bits * 2 * i),
+                              px2_matrix + (p1_bits * 2 * i),
+                              8,
+                              2,
+                              36,
+                              1,
+                              V_PX2_MP6,
+                              18432);
+            }
+
+            memcpy(p1_prime + p1_prime_off, p1 + p1_off, p1_bits);
+            p1_off += p1_bits;
+            p1_prime_off = (p1_prime_off + p1_bits) % (p1_bits * p1_mod * 3);
+        }
+        encode_l2_pdu(conv_mode::CONV_2_5,
+                      p2 + p2_off,
+                      p1_g + (p1_bits * 5 / 2 * p1_mod),
+                      p2_bits);
+        p2_off += p2_bits;
+    }
+    interleaver_i(p1_g, pm_matrix, 20, 16, 36, 1, V_PM, 365440);
+    interleaver_ii(pids_g, pm_matrix, 20, 16, 36, 1, V_PM, 200, 365440, 3200);
+
+    if (p3_bits) {
+        for (int i = 0; i < p3_mod; i++) {
+            encode_l2_pdu(conv_mode::CONV_1_2,
+                          p3 + p3_off,
+                          p3_p4_g + (p3_bits * 2 * i),
+                          p3_bits);
+            p3_off += p3_bits;
+        }
+        interleaver_iv(px1_matrix, px1_internal, internal_half);
+    }
+    if (p4_bits) {
+        for (int i = 0; i < p4_mod; i++) {
+            encode_l2_pdu(conv_mode::CONV_1_2,
+                          p4 + p4_off,
+                          p3_p4_g + (p4_bits * 2 * i),
+                          p4_bits);
+            p4_off += p4_bits;
+        }
+        interleaver_iv(px2_matrix, px2_internal, internal_half);
+    }
+    internal_half ^= 1;
+}
+
+template <class T>
+void l1_fm_frame_encoder::map_symbols(T* out)
+{
+    const T* bpsk = bpsk_table(out);
+
+    for (int symbol = 0; symbol < SYMBOLS_PER_FRAME; symbol++) {
+        for (int i = 0; i < FFT_SIZE; i++) {
+            out[i] = 0;
+        }
+
+        for (int chan = 0; chan < 61; chan++) {
+            out[REF_SC_CHAN[chan]] = bpsk[primary_sc_symbols[REF_SC_ID[chan]][symbol]];
+            if (chan == partitions_per_band())
+                chan = 61 - partitions_per_band() - 2;
+        }
+
+        int pm_channels[] = { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9,
+                              50, 51, 52, 53, 54, 55, 56, 57, 58, 59 };
+        write_symbol(pm_matrix + (symbol * 20 * 36), out, pm_channels, 20);
+
+        if (psm == 2) {
+            int px1_channels[] = { 10, 49 };
+            write_symbol(px1_matrix + (symbol * 2 * 36), out, px1_channels, 2);
+        }
+        if (psm == 3 || psm == 11 || psm == 5) {
+            int px1_channels[] = { 10, 11, 48, 49 };
+            write_symbol(px1_matrix + (symbol * 4 * 36), out, px1_channels, 4);
+        }
+        if (psm == 11 || psm == 5) {
+            int px2_channels[] = { 12, 13, 46, 47 };
+            write_symbol(px2_matrix + (symbol * 4 * 36), out, px2_channels, 4);
+        }
+        if (psm == 6) {
+            int px2_channels[] = { 10, 11, 12, 13, 46, 47, 48, 49 };
+            write_symbol(px2_matrix + (symbol * 8 * 36), out, px2_channels, 8);
+        }
+
+        out += FFT_SIZE;
+    }
+}
+
+void l1_fm_frame_encoder::reverse_bytes(const unsigned char* in,
+                                        unsigned char* out,
+                                        int len)
+{
+    for (int off = 0; off < len; off += 8) {
+        for (int i = 0; i < 8; i++) {
+            out[off + i] = in[off + 7 - i];
+        }
+    }
+}
+
+/* 1011s.pdf section 8.2 */
+void l1_fm_frame_encoder::scramble(unsigned char* buf, int len)
+{
+    unsigned int reg = 0x3ff;
+    for (int off = 0; off < len; off++) {
+        unsigned char next_bit = ((reg >> 9) ^ reg) & 1;
+        buf[off] ^= next_bit;
+        reg = (reg >> 1) | (next_bit << 10);
+    }
+}
+
+/* 1011s.pdf section 9.3 */
+void l1_fm_frame_encoder::conv_enc(conv_mode mode,
+                                   const unsigned char* in,
+                                   unsigned char* out,
+                                   int len)
+{
+    unsigned char poly_2_5[] = { 3, 2, 0133, 0171, 0165 };
+    unsigned char poly_1_2[] = { 2, 2, 0133, 0165 };
+    unsigned char* poly;
+
+    switch (mode) {
+    case conv_mode::CONV_2_5:
+        poly = poly_2_5;
+        break;
+    case conv_mode::CONV_1_2:
+        poly = poly_1_2;
+        break;
+    }
+
+    unsigned char reg = (in[len - 6] << 1) | (in[len - 5] << 2) | (in[len - 4] << 3) |
+                        (in[len - 3] << 4) | (in[len - 2] << 5) | (in[len - 1] << 6);
+    int out_off = 0;
+    for (int in_off = 0; in_off < len; in_off++) {
+        reg = (reg >> 1) | (in[in_off] << 6);
+        for (int i = 0; i < poly[in_off & 1]; i++) {
+            out[out_off++] = parity[reg & poly[i + 2]];
+        }
+    }
+}
+
+void l1_fm_frame_encoder::encode_l2_pdu(conv_mode mode,
+                                        const unsigned char* in,
+                                        unsigned char* out,
+                                        int len)
+{
+    reverse_bytes(in, buf, len);
+    scramble(buf, len);
+    conv_enc(mode, buf, out, len);
+}
+
+/* 1011s.pdf sections 10.2.3 */
+void l1_fm_frame_encoder::interleaver_i(unsigned char* in,
+                                        unsigned char* matrix,
+                                        int J,
+                                        int B,
+                                        int C,
+                                        int M,
+                                        unsigned char* V,
+                                        int N)
+{
+    for (int i = 0; i < N; i++) {
+        int partition = V[((i + 2 * (M / 4)) / M) % J];
+        int block;
+        if (M == 1)
+            block = ((i / J) + (partition * 7)) % B;
+        else
+            block = (i + (i / (J * B))) % B;
+        int ki = i / (J * B);
+        int row = (ki * 11) % 32;
+        int col = ((ki * 11) + (ki / (32 * 9))) % C;
+        matrix[((block * 32) + row) * (J * C) + (partition * C) + col] = in[i];
+    }
+}
+
+/* 1011s.pdf sections 10.2.4 */
+void l1_fm_frame_encoder::interleaver_ii(unsigned char* in,
+                                         unsigned char* matrix,
+                                         int J,
+                                         int B,
+                                         int C,
+                                         int M,
+                                         unsigned char* V,
+                                         int b,
+                                         int I0,
+                                         int N)
+{
+    for (int i = 0; i < N; i++) {
+        int partition = V[i % J];
+        int block = i / b;
+        int ki = ((i / J) % (b / J)) + (I0 / (J * B));
+        int row = (ki * 11) % 32;
+        int col = ((ki * 11) + (ki / (32 * 9))) % C;
+        matrix[((block * 32) + row) * (J * C) + (partition * C) + col] = in[i];
+    }
+}
+
+/* 1011s.pdf sections 10.2.5 */
+void l1_fm_frame_encoder::interleaver_iii(unsigned char* in,
+                                          unsigned char* matrix,
+                                          int J,
+                                          int B,
+                                          int C,
+                                          int M,
+                                          unsigned char* V,
+                                          int N)
+{
+    for (int i = 0; i < N; i++) {
+        int partition = V[(i + (i / M)) % J];
+        int ki = i / J;
+        int row = (ki * 11) % 32;
+        int col = ((ki * 11) + (ki / 32)) % C;
+        matrix[row * (J * C) + (partition * C) + col] = in[i];
+    }
+}
+
+/* 1011s.pdf sections 10.2.6 */
+void l1_fm_frame_encoder::interleaver_iv(unsigned char* matrix,
+                                         unsigned char* internal,
+                                         int half)
+{
+    int J = psm == 2 ? 2 : 4; // number of partitions
+    int B = 32;               // blocks
+    int C = 36;               // columns per partition
+    int M = psm == 2 ? 4 : 2; // factor: 1, 2 or 4
+    int N = psm == 2 ? 73728 : 147456;
+
+    int bk_bits = 32 * C;
+    int bk_adj = 32 * C - 1;
+
+    int internal_off = half * (N / 2);
+    int pt[4];
+    for (int i = 0; i < J; i++) {
+        pt[i] = internal_off / J;
+    }
+
+    for (int i = 0; i < N / 2; i++) {
+        int partition = ((i + 2 * (M / 4)) / M) % J;
+        unsigned int pti = pt[partition]++;
+        int block = (pti + (partition * 7) - (bk_adj * (pti / bk_bits))) % B;
+        int row = ((11 * pti) % bk_bits) / C;
+        int column = (pti * 11) % C;
+        internal[(block * 32 + row) * (J * C) + partition * C + column] = p3_p4_g[i];
+        matrix[i] = internal[internal_off++];
+    }
+}
+
+template <class T>
+void l1_fm_frame_encoder::write_symbol(unsigned char* matrix_row,
+                                       T* out_row,
+                                       int* channels,
+                                       int num_channels)
+{
+    const T* qpsk = qpsk_table(out_row);
+
+    for (int i = 0; i < num_channels; i++) {
+        int width = (channels[i] == 15 || channels[i] == 44) ? 12 : 18;
+        for (int j = 0; j < width; j++) {
+            unsigned char ii = matrix_row[(i * width * 2) + (j * 2)];
+            unsigned char qq = matrix_row[(i * width * 2) + (j * 2) + 1];
+            unsigned char symbol = (ii << 1) | qq;
+            int carrier = REF_SC_CHAN[channels[i]] + 1 + j;
+            out_row[carrier] = qpsk[symbol];
+        }
+    }
+}
+
+/* 1011s.pdf table 11-1 */
+void l1_fm_frame_encoder::primary_sc_data_seq(
+    unsigned char* out, int scid, int sci, int bc, int psmi)
+{
+    out[0] = 0; // sync
+    out[1] = 1; // sync
+    out[2] = 1; // sync
+    out[3] = 0; // sync
+    out[4] = 0; // sync
+    out[5] = 1; // sync
+    out[6] = 0; // sync
+
+    out[7] = sci;
+    out[8] = out[7]; // parity
+
+    out[9] = 1; // sync
+
+    out[10] = (scid & 0x2) >> 1;
+    out[11] = (scid & 0x1);
+    out[12] = 0; // ASM1
+    out[13] = out[10] ^ out[11] ^ out[12]; // parity
+
+    out[14] = 0; // sync
+
+    out[15] = 0; // reserved
+    out[16] = (bc & 0x8) >> 3;
+    out[17] = (bc & 0x4) >> 2;
+    out[18] = (bc & 0x2) >> 1;
+    out[19] = (bc & 0x1);
+    out[20] = out[15] ^ out[16] ^ out[17] ^ out[18] ^ out[19]; // parity
+
+    out[21] = 1; // sync
+    out[22] = 1; // sync
+
+    out[23] = 1; // ASM0
+    out[24] = 0; // reserved
+    out[25] = (psmi & 0x20) >> 5;
+    out[26] = (psmi & 0x10) >> 4;
+    out[27] = (psmi & 0x08) >> 3;
+    out[28] = (psmi & 0x04) >> 2;
+    out[29] = (psmi & 0x02) >> 1;
+    out[30] = (psmi & 0x01);
+    out[31] = out[23] ^ out[24] ^ out[25] ^ out[26] ^ out[27] ^ out[28] ^ out[29] ^
+              out[30]; // parity
+
+    differential_encode(out);
+}
+
+/* 1011s.pdf table 11-2 */
+void l1_fm_frame_encoder::secondary_sc_data_seq(unsigned char* out,
+                                                int scid,
+                                                int bc,
+                                                int ssmi)
+{
+    out[0] = 0; // sync
+    out[1] = 1; // sync
+    out[2] = 1; // sync
+    out[3] = 0; // sync
+    out[4] = 0; // sync
+    out[5] = 1; // sync
+    out[6] = 0; // sync
+
+    out[7] = 0;      // reserved
+    out[8] = out[7]; // parity
+
+    out[9] = 1; // sync
+
+    out[10] = (scid & 0x2) >> 1;
+    out[11] = (scid & 0x1);
+    out[12] = 0;                           // reserved
+    out[13] = out[10] ^ out[11] ^ out[12]; // parity
+
+    out[14] = 0; // sync
+
+    out[15] = 0; // reserved
+    out[16] = (bc & 0x8) >> 3;
+    out[17] = (bc & 0x4) >> 2;
+    out[18] = (bc & 0x2) >> 1;
+    out[19] = (bc & 0x1);
+    out[20] = out[15] ^ out[16] ^ out[17] ^ out[18] ^ out[19]; // parity
+
+    out[21] = 1; // sync
+    out[22] = 1; // sync
+
+    out[23] = 0; // reserved
+    out[24] = 0; // reserved
+    out[25] = 0; // reserved
+    out[26] = 0; // reserved
+    out[27] = 0; // reserved
+    out[28] = (ssmi & 0x04) >> 2;
+    out[29] = (ssmi & 0x02) >> 1;
+    out[30] = (ssmi & 0x01);
+    out[31] = out[23] ^ out[24] ^ out[25] ^ out[26] ^ out[27] ^ out[28] ^ out[29] ^
+              out[30]; // parity
+
+    differential_encode(out);
+}
+
+void l1_fm_frame_encoder::differential_encode(unsigned char* buf)
+{
+    unsigned char last_symbol = 0;
+    for (int i = 0; i < SYMBOLS_PER_BLOCK; i++) {
+        if (buf[i]) {
+            last_symbol ^= 1;
+        }
+        buf[i] = last_symbol;
+    }
+}
+
+int l1_fm_frame_encoder::partitions_per_band()
+{
+    switch (psm) {
+    case 2:
+        return 11;
+    case 3:
+        return 12;
+    case 5:
+    case 6:
+    case 11:
+        return 14;
+    default:
+        return 10;
+    }
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
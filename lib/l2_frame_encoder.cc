@@ -0,0 +1,471 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017, 2023, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "adts.h"
+#include "crc.h"
+#include "hdlc.h"
+#include "reed_solomon.h"
+#include <nrsc5/core/l2_frame_encoder.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+constexpr unsigned char CW0_AUDIO[] = { 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 0, 1,
+                                        1, 0, 0, 0, 1, 1, 0, 1, 0, 0, 1, 1 };
+constexpr unsigned char CW1_AUDIO_OPP[] = { 1, 1, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1,
+                                            0, 1, 1, 0, 0, 0, 1, 1, 0, 1, 0, 0 };
+constexpr unsigned char CW2_AUDIO_FIXED[] = { 1, 1, 1, 0, 0, 0, 1, 1, 0, 1, 1, 0,
+                                              0, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0 };
+constexpr unsigned char CW3_AUDIO_FIXED_OPP[] = { 1, 0, 0, 0, 1, 1, 0, 1, 1, 0, 0, 0,
+                                                  1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 1 };
+constexpr unsigned char CW4_FIXED[] = { 0, 0, 1, 1, 0, 1, 1, 0, 0, 0, 1, 1,
+                                        0, 1, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0 };
+
+constexpr unsigned char BBM[] = { 0x7d, 0x3a, 0xe2, 0x42 };
+
+constexpr uint8_t AAS_PACKET_FORMAT = 0x21;
+constexpr uint16_t SIG_PORT = 0x20;
+constexpr int RS_CODEWORD_LEN = 96;
+constexpr int RS_PARITY_LEN = 8;
+constexpr int CONTROL_WORD_LEN = 6;
+constexpr int HEF_LEN = 3;
+
+l2_frame_encoder::l2_frame_encoder(int num_progs,
+                                   int first_prog,
+                                   int size,
+                                   int data_bytes,
+                                   blend blend_control)
+{
+    this->num_progs = num_progs;
+    this->first_prog = first_prog;
+    memset(program_type, 0, sizeof(program_type));
+    this->size = size;
+    this->data_bytes = data_bytes;
+    this->blend_control = blend_control;
+    payload_bytes = (size - 22) / 8;
+    rs_enc.reset(new rs_encoder(0x11d, 1, 1, RS_PARITY_LEN));
+    memset(rs_buf, 0, 255);
+    pdu_seq_no = 0;
+    memset(start_seq_no, 0, sizeof(start_seq_no));
+    target_seq_no = 0;
+    memset(partial_bytes, 0, sizeof(partial_bytes));
+    for (int p = 0; p < MAX_PROGRAMS; p++) {
+        next_frame_seq[p] = -1;
+    }
+    discontinuity_count = 0;
+    audio_overrun_count = 0;
+    ccc_width = 24;
+    ccc_count = 0;
+    ccc = hdlc_encode({ 0x00,
+                        0x00,
+                        0x00,
+                        (unsigned char)(this->data_bytes & 0xff),
+                        (unsigned char)(this->data_bytes >> 8) });
+    ccc_offset = ccc.size() - 1;
+    total_data_width = (this->data_bytes > 0) ? (this->data_bytes + ccc_width + 1) : 0;
+    aas_framer.reset(new hdlc_framer());
+    aas_current_port = 0;
+    aas_block_offset = 0;
+
+    switch (size) {
+    case 146176:
+    case 109312:
+    case 72448:
+    case 30000:
+    case 24000:
+        target_nop = 32;
+        lc_bits = 16;
+        psd_bytes = 128;
+        pdu_seq_len = 2;
+        codec_mode = 0;
+        break;
+    case 9216:
+    case 4608:
+    case 3750:
+    case 2304:
+        target_nop = 4;
+        lc_bits = 12;
+        psd_bytes = 8;
+        pdu_seq_len = 8;
+        codec_mode = 13;
+        break;
+    default:
+        throw std::invalid_argument("unsupported L2 PDU size");
+    }
+    out_buf = (unsigned char*)malloc(payload_bytes);
+}
+
+l2_frame_encoder::~l2_frame_encoder() { free(out_buf); }
+
+int l2_frame_encoder::frames_needed(int p) const
+{
+    return target_seq_no + target_nop - start_seq_no[p] - (partial_bytes[p] ? 1 : 0);
+}
+
+void l2_frame_encoder::encode_frame(l2_program_input* inputs, unsigned char* out)
+{
+    memset(out_buf, 0, payload_bytes);
+
+    unsigned char* out_program = out_buf;
+    target_seq_no += target_nop;
+    for (int p = 0; p < num_progs; p++) {
+        l2_program_input& in = inputs[p];
+        int program_number = first_prog + p;
+        int bytes_left = (out_buf + payload_bytes - total_data_width) - out_program;
+        int nop = 0;
+        size_t next_frame = 0;
+        int audio_length = 0;
+        int begin_bytes = 0;
+        int end_bytes = 0;
+        while (next_frame < in.frames->size() &&
+               (*in.frames)[next_frame].offset < in.audio_offset + partial_bytes[p]) {
+            next_frame++;
+        }
+        if (partial_bytes[p]) {
+            nop++;
+            audio_length = partial_bytes[p] + 1;
+        }
+        for (size_t k = next_frame; nop < target_seq_no - start_seq_no[p]; k++) {
+            if (k == in.frames->size())
+                break;
+            int length = (*in.frames)[k].length;
+
+            if (RS_PARITY_LEN + CONTROL_WORD_LEN + len_locators(nop + 1) + HEF_LEN +
+                    psd_bytes + audio_length + 2 >
+                bytes_left)
+                break;
+            if (RS_PARITY_LEN + CONTROL_WORD_LEN + len_locators(nop + 1) + HEF_LEN +
+                    psd_bytes + audio_length + length + 1 >
+                bytes_left) {
+                begin_bytes = bytes_left - (RS_PARITY_LEN + CONTROL_WORD_LEN +
+                                            len_locators(nop + 1) + HEF_LEN +
+                                            psd_bytes + audio_length + 1);
+                end_bytes = length - begin_bytes;
+                nop++;
+                break;
+            }
+
+            nop++;
+            audio_length += length + 1;
+        }
+
+        int la_loc = RS_PARITY_LEN + CONTROL_WORD_LEN + len_locators(nop) + HEF_LEN +
+                     psd_bytes - 1;
+
+        write_control_word(out_program + RS_PARITY_LEN,
+                           codec_mode,
+                           /*stream_id*/ 0,
+                           pdu_seq_no,
+                           program_number == 0 ? static_cast<int>(blend_control) : 0,
+                           /*digital_gain_or_per_stream_delay*/ 0,
+                           /*common_delay*/ program_number == 0 ? 24 : 0,
+                           /*latency*/ 4,
+                           partial_bytes[p] ? 1 : 0,
+                           begin_bytes ? 1 : 0,
+                           start_seq_no[p],
+                           nop,
+                           /*hef*/ 1,
+                           la_loc);
+
+        int end = la_loc;
+        for (int i = 0; i < nop; i++) {
+            const unsigned char* frame_data;
+            int length;
+            if ((i == 0) && partial_bytes[p]) {
+                frame_data = in.audio + in.audio_offset;
+                length = partial_bytes[p];
+            } else {
+                const adts_frame& frame = (*in.frames)[next_frame++];
+                if ((frame.seq >= 0) && (next_frame_seq[p] >= 0) &&
+                    (frame.seq != next_frame_seq[p])) {
+                    discontinuity_count++;
+                }
+                next_frame_seq[p] = (frame.seq >= 0) ? frame.seq + 1 : -1;
+
+                frame_data = in.audio + frame.offset + ADTS_HEADER_LEN;
+                length = ((i == nop - 1) && begin_bytes) ? begin_bytes : frame.length;
+                start_seq_no[p]++;
+            }
+            in.audio_offset = (frame_data - in.audio) + length;
+
+            memcpy(out_program + end + 1, frame_data, length);
+            end += length;
+            out_program[++end] = crc8(frame_data, length);
+            write_locator(out_program + RS_PARITY_LEN + CONTROL_WORD_LEN, i, end);
+        }
+        partial_bytes[p] = end_bytes;
+
+        write_hef(out_program + RS_PARITY_LEN + CONTROL_WORD_LEN + len_locators(nop),
+                  program_number,
+                  /*access*/ 0,
+                  program_type[program_number]);
+
+        memcpy(out_program +
+                   (RS_PARITY_LEN + CONTROL_WORD_LEN + len_locators(nop) + HEF_LEN),
+               in.psd + in.psd_offset,
+               psd_bytes);
+        in.psd_offset += psd_bytes;
+
+        // Reed-Solomon encoding
+        for (int i = RS_CODEWORD_LEN - 1; i >= RS_PARITY_LEN; i--) {
+            rs_buf[255 - i - 1] = out_program[i];
+        }
+        rs_enc->encode(rs_buf, rs_buf + 255 - RS_PARITY_LEN);
+        for (int i = RS_PARITY_LEN - 1; i >= 0; i--) {
+            out_program[i] = rs_buf[255 - i - 1];
+        }
+
+        out_program += (end + 1);
+
+        if (target_seq_no - start_seq_no[p] > 8) {
+            audio_overrun_count++;
+        }
+    }
+
+    if (data_bytes > 0) {
+        // Synchronization channel
+        if ((ccc_count & 0x03) == 0) {
+            out_buf[payload_bytes - 1] = ccc_count;
+        } else {
+            if (ccc_width == 1) {
+                out_buf[payload_bytes - 1] = 0x00;
+            } else {
+                out_buf[payload_bytes - 1] = ((ccc_width / 2) << 4) | (ccc_width / 2);
+            }
+        }
+        ccc_count++;
+
+        // Configuration control channel
+        for (int i = payload_bytes - 1 - ccc_width; i < payload_bytes - 1; i++) {
+            out_buf[i] = ccc[ccc_offset];
+            ccc_offset = (ccc_offset + 1) % ccc.size();
+        }
+
+        // Fixed data subchannel
+        int i = payload_bytes - 1 - ccc_width - data_bytes;
+        while (i < payload_bytes - 1 - ccc_width) {
+            if (aas_block_offset < 4) {
+                out_buf[i++] = BBM[aas_block_offset++];
+                continue;
+            }
+            int span = std::min(payload_bytes - 1 - ccc_width - i,
+                                255 + 4 - aas_block_offset);
+            fill_data_subchannel(out_buf + i, span);
+            i += span;
+            aas_block_offset = (aas_block_offset + span) % (255 + 4);
+        }
+    }
+
+    header_spread(out_buf, out, (data_bytes > 0) ? CW2_AUDIO_FIXED : CW0_AUDIO);
+
+    pdu_seq_no = (pdu_seq_no + 1) % pdu_seq_len;
+}
+
+void l2_frame_encoder::push_aas_pdu(const uint8_t* pdu,
+                                    size_t len,
+                                    std::shared_ptr<const void> owner)
+{
+    int port = (pdu[2] << 8) | pdu[1];
+
+    if ((pdu[0] == AAS_PACKET_FORMAT) && (port == SIG_PORT)) {
+        decode_sig(pdu, len);
+    }
+
+    aas_queues[port].push({ pdu, len, std::move(owner) });
+}
+
+void l2_frame_encoder::set_ready_callback(std::function<void(int port)> callback)
+{
+    ready_callback = std::move(callback);
+}
+
+/* 1017s.pdf figure 5-2 */
+void l2_frame_encoder::write_control_word(unsigned char* out,
+                                         int codec_mode,
+                                         int stream_id,
+                                         int pdu_seq_no,
+                                         int blend_control,
+                                         int digital_gain_or_per_stream_delay,
+                                         int common_delay,
+                                         int latency,
+                                         int p_first,
+                                         int p_last,
+                                         int start_seq_no,
+                                         int nop,
+                                         int hef,
+                                         int la_loc)
+{
+    out[0] = ((pdu_seq_no & 0x3) << 6) | (stream_id << 4) | codec_mode;
+    out[1] = (digital_gain_or_per_stream_delay << 3) | (blend_control << 1) |
+             (pdu_seq_no >> 2);
+    out[2] = ((latency & 0x3) << 6) | common_delay;
+    out[3] =
+        ((start_seq_no & 0x1f) << 3) | (p_last << 2) | (p_first << 1) | (latency >> 2);
+    out[4] = (hef << 7) | (nop << 1) | ((start_seq_no & 0x20) >> 5);
+    out[5] = la_loc;
+}
+
+/* 1017s.pdf section 5.2.1.6 */
+void l2_frame_encoder::write_hef(unsigned char* out,
+                                int program_number,
+                                int access,
+                                int program_type)
+{
+    out[0] = 0x90 | (program_number << 1);
+    out[1] = 0xA0 | (access << 3) | (program_type >> 7);
+    out[2] = program_type & 0x7f;
+}
+
+void l2_frame_encoder::write_locator(unsigned char* out, int i, int locator)
+{
+    if (lc_bits == 16) {
+        out[i * 2] = (locator & 0xff);
+        out[i * 2 + 1] = (locator >> 8);
+    } else {
+        if (i % 2 == 0) {
+            out[i / 2 * 3] = (locator & 0xff);
+            out[i / 2 * 3 + 1] = (locator >> 8);
+        } else {
+            out[i / 2 * 3 + 1] |= ((locator & 0xf) << 4);
+            out[i / 2 * 3 + 2] = (locator >> 4);
+        }
+    }
+}
+
+/* 1014s.pdf figure 5-2 */
+void l2_frame_encoder::header_spread(const unsigned char* in,
+                                    unsigned char* out,
+                                    const unsigned char* pci)
+{
+    int n_start, n_offset, header_bits;
+
+    /* 1014s.pdf table 5-4 */
+    if (size >= 72000) {
+        n_start = 8 * ((size - 30000 + 7) / 8);
+
+        switch (size % 8) {
+        case 0:
+            n_offset = 1247;
+            header_bits = 24;
+            break;
+        case 7:
+            n_offset = 1303;
+            header_bits = 23;
+            break;
+        default:
+            n_offset = 1359;
+            header_bits = 22;
+        }
+    } else {
+        n_start = 120;
+
+        switch (size % 8) {
+        case 0:
+            header_bits = 24;
+            break;
+        case 7:
+            header_bits = 23;
+            break;
+        default:
+            header_bits = 22;
+        }
+
+        n_offset = 8 * (((size - 120 + 7) / 8) / header_bits) - 1;
+    }
+
+    int out_off = 0;
+    int pci_off = 0;
+    for (int i = 0; i < payload_bytes; i++) {
+        for (int j = 0; j < 8; j++) {
+            if ((out_off >= n_start) && (pci_off < header_bits) &&
+                ((out_off - n_start) % (n_offset + 1) == 0)) {
+                out[out_off++] = pci[pci_off++];
+            }
+            out[out_off++] = (in[i] >> (7 - j)) & 1;
+        }
+    }
+}
+
+int l2_frame_encoder::len_locators(int nop) { return ((lc_bits * nop) + 4) / 8; }
+
+/*
+ * Starts framing the next queued AAS PDU, choosing ports in round robin order.
+ * Returns false if all queues are empty.
+ */
+bool l2_frame_encoder::next_aas_pdu()
+{
+    auto it = aas_queues.lower_bound(aas_current_port);
+    for (size_t i = 0; i < aas_queues.size(); i++, it++) {
+        if (it == aas_queues.end()) {
+            it = aas_queues.begin();
+        }
+        if (!it->second.empty()) {
+            const aas_pdu& pdu = it->second.front();
+            aas_current_port = it->first;
+            aas_framer->begin(pdu.data, pdu.len);
+            return true;
+        }
+    }
+    return false;
+}
+
+void l2_frame_encoder::fill_data_subchannel(unsigned char* out, int len)
+{
+    int n = 0;
+    while (n < len) {
+        if (aas_framer->done() && !next_aas_pdu()) {
+            // all queues are empty
+            memset(out + n, 0x7e, len - n);
+            return;
+        }
+
+        n += aas_framer->encode(out + n, len - n);
+
+        if (aas_framer->done()) {
+            auto& queue = aas_queues[aas_current_port];
+            queue.pop();
+
+            // if we emptied the queue, ask for more
+            if (queue.empty() && ready_callback) {
+                ready_callback(aas_current_port);
+            }
+
+            // move to the next port at the end of a PDU
+            aas_current_port++;
+        }
+    }
+}
+
+void l2_frame_encoder::decode_sig(const uint8_t* pdu_bytes, size_t len)
+{
+    size_t offset = 5;
+    while (offset < len) {
+        unsigned char type = pdu_bytes[offset++];
+        switch (type & 0xf0) {
+        case 0x40:
+            offset += 3;
+            break;
+        case 0x60:
+            unsigned char length = pdu_bytes[offset++];
+            if (type == 0x66) {
+                unsigned char port = pdu_bytes[offset + 1];
+                unsigned char type = pdu_bytes[offset + 2];
+                if (port < MAX_PROGRAMS) {
+                    program_type[port] = type;
+                }
+            }
+            offset += length - 1;
+        }
+    }
+}
+
+} // namespace nrsc5
+} // namespace gr
@@ -0,0 +1,685 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "aas.h"
+#include "lot_carousel_impl.h"
+#include <dirent.h>
+#include <gnuradio/io_signature.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+/* Splits a spool file name of the form <lot_id>_<name> */
+bool parse_spool_name(const std::string& filename, uint16_t& lot_id, std::string& name)
+{
+    size_t sep = filename.find('_');
+    if ((sep == 0) || (sep == std::string::npos) || (sep > 5) ||
+        (sep + 1 == filename.size())) {
+        return false;
+    }
+    for (size_t i = 0; i < sep; i++) {
+        if (!isdigit((unsigned char)filename[i])) {
+            return false;
+        }
+    }
+    unsigned long id = std::stoul(filename.substr(0, sep));
+    if (id > 0xffff) {
+        return false;
+    }
+    lot_id = id;
+    name = filename.substr(sep + 1);
+    return true;
+}
+
+} // namespace
+
+lot_carousel::sptr lot_carousel::make(const std::string& spool_dir, int spool_port)
+{
+    return gnuradio::get_initial_sptr(new lot_carousel_impl(spool_dir, spool_port));
+}
+
+
+/*
+ * The private constructor
+ */
+lot_carousel_impl::lot_carousel_impl(const std::string& spool_dir, int spool_port)
+    : gr::block("lot_carousel",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0))
+{
+    total_outstanding = 0;
+    vtime = 0;
+    shares_dirty = false;
+    deadline_warned = false;
+    started = false;
+    parts_per_second = 0;
+    rate_parts = 0;
+    ingested = 0;
+    ingest_count = 0;
+    ingest_seconds = 0;
+    air_count = 0;
+    air_seconds = 0;
+
+    if ((spool_port < 0) || (spool_port > 0xffff)) {
+        throw std::invalid_argument("port must be between 0 and 65535");
+    }
+    this->spool_dir = spool_dir;
+    this->spool_port = spool_port;
+    inotify_fd = -1;
+    wake_pipe[0] = wake_pipe[1] = -1;
+    if (!spool_dir.empty()) {
+        inotify_fd = inotify_init1(IN_CLOEXEC);
+        if (inotify_fd < 0) {
+            throw std::runtime_error("Unable to initialize inotify");
+        }
+        if (inotify_add_watch(inotify_fd,
+                              spool_dir.c_str(),
+                              IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM |
+                                  IN_ONLYDIR) < 0) {
+            close(inotify_fd);
+            throw std::invalid_argument("Unable to watch directory " + spool_dir);
+        }
+        if (pipe(wake_pipe) != 0) {
+            close(inotify_fd);
+            throw std::runtime_error("Unable to create pipe");
+        }
+    }
+
+    message_port_register_out(pmt::intern("aas"));
+
+    message_port_register_in(pmt::intern("command"));
+    set_msg_handler(pmt::intern("command"),
+                    [this](pmt::pmt_t msg) { this->handle_command(msg); });
+
+    message_port_register_in(pmt::intern("ready"));
+    set_msg_handler(pmt::intern("ready"),
+                    [this](pmt::pmt_t msg) { this->handle_notify(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+lot_carousel_impl::~lot_carousel_impl()
+{
+    if (spool_thread.joinable()) {
+        write(wake_pipe[1], "", 1);
+        spool_thread.join();
+    }
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+        close(wake_pipe[0]);
+        close(wake_pipe[1]);
+    }
+}
+
+bool lot_carousel_impl::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        started = true;
+        rate_start = std::chrono::steady_clock::now();
+        fill();
+    }
+    if (inotify_fd >= 0) {
+        spool_thread = std::thread([this] { this->watch_spool(); });
+    }
+    return block::start();
+}
+
+bool lot_carousel_impl::stop()
+{
+    if (spool_thread.joinable()) {
+        write(wake_pipe[1], "", 1);
+        spool_thread.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    started = false;
+    return block::stop();
+}
+
+void lot_carousel_impl::add_file(const std::string& filename,
+                                 int lot_id,
+                                 int port,
+                                 double priority,
+                                 int repeat,
+                                 double expiry,
+                                 double deadline)
+{
+    if ((lot_id < 0) || (lot_id > 0xffff)) {
+        throw std::invalid_argument("LOT ID must be between 0 and 65535");
+    }
+    if ((port < 0) || (port > 0xffff)) {
+        throw std::invalid_argument("port must be between 0 and 65535");
+    }
+    if (!(priority > 0)) {
+        throw std::invalid_argument("priority must be positive");
+    }
+    if ((repeat < 0) || (expiry < 0) || (deadline < 0)) {
+        throw std::invalid_argument("repeat, expiry and deadline must not be negative");
+    }
+
+    std::string name = filename.substr(filename.find_last_of('/') + 1);
+    auto object = lot_object::from_file(filename, name, lot_id);
+    if (object->num_parts() == 0) {
+        throw std::invalid_argument("File is empty: " + filename);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    carousel_file file;
+    file.object = object;
+    file.port = port;
+    file.priority = priority;
+    file.repeat = repeat;
+    file.expires = std::chrono::steady_clock::time_point::max();
+    file.deadline = deadline;
+    file.changed = std::chrono::steady_clock::time_point();
+    if (expiry > 0) {
+        using std::chrono::steady_clock;
+        auto duration = std::chrono::duration<double>(expiry);
+        file.expires = now + std::chrono::duration_cast<steady_clock::duration>(duration);
+        object->set_expiry(time(nullptr) + (time_t)std::ceil(expiry));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    add(lot_id, file);
+    if (started) {
+        fill();
+    }
+}
+
+void lot_carousel_impl::remove_file(int lot_id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.erase(lot_id) > 0) {
+        shares_dirty = true;
+        d_logger->info("Removed LOT file " + std::to_string(lot_id));
+    }
+}
+
+int lot_carousel_impl::num_files() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+uint64_t lot_carousel_impl::files_ingested() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return ingested;
+}
+
+double lot_carousel_impl::ingest_latency() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return ingest_count ? ingest_seconds / ingest_count : 0;
+}
+
+double lot_carousel_impl::air_latency() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return air_count ? air_seconds / air_count : 0;
+}
+
+/*
+ * Picks up the files already in the spool directory, then follows changes to it until
+ * woken through wake_pipe. Files are read here, rather than in the scheduler, so that
+ * a large file does not hold up the carousel.
+ */
+void lot_carousel_impl::watch_spool()
+{
+    DIR* dir = opendir(spool_dir.c_str());
+    if (dir) {
+        while (struct dirent* entry = readdir(dir)) {
+            if ((entry->d_type == DT_REG) || (entry->d_type == DT_UNKNOWN)) {
+                ingest(entry->d_name, std::chrono::steady_clock::time_point());
+            }
+        }
+        closedir(dir);
+    }
+
+    alignas(struct inotify_event) char buffer[4096];
+    while (true) {
+        struct pollfd fds[2] = { { inotify_fd, POLLIN, 0 }, { wake_pipe[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            d_logger->error("Unable to watch spool directory");
+            return;
+        }
+        if (fds[1].revents) {
+            read(wake_pipe[0], buffer, 1);
+            return;
+        }
+
+        ssize_t len = read(inotify_fd, buffer, sizeof(buffer));
+        auto now = std::chrono::steady_clock::now();
+        for (ssize_t i = 0; i < len;) {
+            const struct inotify_event* event = (const struct inotify_event*)&buffer[i];
+            if (event->len > 0) {
+                if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                    ingest(event->name, now);
+                } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    withdraw(event->name);
+                }
+            }
+            i += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+
+/*
+ * Files are copied into memory, since the spool file may be overwritten in place while
+ * it is being sent.
+ */
+void lot_carousel_impl::ingest(const std::string& filename,
+                               std::chrono::steady_clock::time_point changed)
+{
+    uint16_t lot_id;
+    std::string name;
+    if (!parse_spool_name(filename, lot_id, name)) {
+        if (filename[0] != '.') {
+            d_logger->warn("Ignoring spool file without a LOT ID: " + filename);
+        }
+        return;
+    }
+
+    std::shared_ptr<lot_object> object;
+    try {
+        std::ifstream stream(spool_dir + "/" + filename, std::ios::binary);
+        if (!stream) {
+            d_logger->warn("Unable to read spool file: " + filename);
+            return;
+        }
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)),
+                                  std::istreambuf_iterator<char>());
+        if (data.empty()) {
+            return;
+        }
+        object = lot_object::from_data(std::move(data), name, lot_id);
+    } catch (const std::exception& e) {
+        d_logger->error(filename + ": " + e.what());
+        return;
+    }
+
+    carousel_file file;
+    file.object = object;
+    file.port = spool_port;
+    file.priority = 1.0;
+    file.repeat = 0;
+    file.expires = std::chrono::steady_clock::time_point::max();
+    file.deadline = 0;
+    file.changed = changed;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    add(lot_id, file);
+    ingested++;
+    if (changed != std::chrono::steady_clock::time_point()) {
+        auto latency = std::chrono::steady_clock::now() - changed;
+        ingest_seconds += std::chrono::duration<double>(latency).count();
+        ingest_count++;
+    }
+    if (started) {
+        fill();
+    }
+}
+
+/*
+ * Deleting the file on air hands over to its pending replacement straight away, if
+ * there is one with another name. Deleting a pending replacement cancels it.
+ */
+void lot_carousel_impl::withdraw(const std::string& filename)
+{
+    uint16_t lot_id;
+    std::string name;
+    if (!parse_spool_name(filename, lot_id, name)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(lot_id);
+    if (it == entries.end()) {
+        return;
+    }
+
+    carousel_entry& entry = it->second;
+    bool current = (entry.file.object->name() == name);
+    bool pending = entry.has_pending && (entry.pending.object->name() == name);
+    if (current && entry.has_pending && !pending) {
+        entry.file = entry.pending;
+        entry.pending.object.reset();
+        entry.has_pending = false;
+        entry.next_part = 0;
+        entry.cycles = 0;
+        shares_dirty = true;
+        d_logger->info("Replaced LOT file " + std::to_string(lot_id) + ": " +
+                       entry.file.object->name());
+    } else if (current) {
+        entries.erase(it);
+        shares_dirty = true;
+        d_logger->info("Removed LOT file " + std::to_string(lot_id));
+    } else if (pending) {
+        entry.pending.object.reset();
+        entry.has_pending = false;
+        d_logger->info("Cancelled replacement of LOT file " + std::to_string(lot_id));
+    }
+}
+
+/*
+ * A file replacing one with the same LOT ID takes over once the current one has been
+ * sent in full, so that receivers are not left with an incomplete object. Unchanged
+ * files keep their place in the cycle, and only their parameters are updated.
+ */
+void lot_carousel_impl::add(uint16_t lot_id, const carousel_file& file)
+{
+    shares_dirty = true;
+
+    auto it = entries.find(lot_id);
+    if (it == entries.end()) {
+        carousel_entry entry;
+        entry.file = file;
+        entry.has_pending = false;
+        entry.next_part = 0;
+        entry.cycles = 0;
+        entry.share = 0;
+        entry.pass = vtime;
+        entries[lot_id] = entry;
+        d_logger->info("Added LOT file " + std::to_string(lot_id) + ": " +
+                       file.object->name());
+        return;
+    }
+
+    carousel_entry& entry = it->second;
+    if (((entry.file.object->hash() == file.object->hash()) &&
+         (entry.file.port == file.port)) ||
+        (entry.next_part == 0)) {
+        entry.file = file;
+        entry.has_pending = false;
+        entry.cycles = 0;
+    } else {
+        entry.pending = file;
+        entry.has_pending = true;
+    }
+    d_logger->info("Replaced LOT file " + std::to_string(lot_id) + ": " +
+                   file.object->name());
+}
+
+void lot_carousel_impl::handle_command(pmt::pmt_t msg)
+{
+    for (auto byte : pmt::u8vector_elements(pmt::cdr(msg))) {
+        if (byte == '\n') {
+            run_command(command_line);
+            command_line.clear();
+        } else {
+            command_line += byte;
+        }
+    }
+}
+
+/*
+ * Accepts "add|<lot_id>|<port>|<priority>|<repeat>|<expiry>|<deadline>|<filename>" and
+ * "remove|<lot_id>".
+ */
+void lot_carousel_impl::run_command(const std::string& command)
+{
+    std::vector<std::string> parts;
+    std::istringstream stream(command);
+    std::string part;
+    while ((parts.size() < 7) && std::getline(stream, part, '|')) {
+        parts.push_back(part);
+    }
+    if (std::getline(stream, part)) {
+        parts.push_back(part);
+    }
+
+    try {
+        if ((parts.size() == 8) && (parts[0] == "add")) {
+            add_file(parts[7],
+                     std::stoi(parts[1]),
+                     std::stoi(parts[2], nullptr, 0),
+                     std::stod(parts[3]),
+                     std::stoi(parts[4]),
+                     std::stod(parts[5]),
+                     std::stod(parts[6]));
+        } else if ((parts.size() == 2) && (parts[0] == "remove")) {
+            remove_file(std::stoi(parts[1]));
+        } else {
+            d_logger->warn("Invalid command: " + command);
+        }
+    } catch (const std::exception& e) {
+        d_logger->error(e.what());
+    }
+}
+
+void lot_carousel_impl::handle_notify(pmt::pmt_t msg)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    bool lockstep;
+    long port = aas_ready_port(msg, lockstep);
+    auto it = outstanding.find(port);
+    if (it == outstanding.end()) {
+        // a Layer 2 encoder in lockstep still waits for our (empty) reply
+        if (lockstep) {
+            message_port_pub(pmt::intern("aas"), aas_reply_end(port));
+        }
+        return;
+    }
+    total_outstanding -= it->second;
+    rate_parts += it->second;
+    it->second = 0;
+
+    // Measure the capacity available to the carousel, for scheduling deadlines
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - rate_start).count();
+    if (elapsed >= 1.0) {
+        double rate = rate_parts / elapsed;
+        parts_per_second =
+            (parts_per_second == 0) ? rate : 0.75 * parts_per_second + 0.25 * rate;
+        rate_parts = 0;
+        rate_start = now;
+        shares_dirty = true;
+    }
+
+    fill();
+    if (lockstep) {
+        message_port_pub(pmt::intern("aas"), aas_reply_end(port));
+    }
+}
+
+void lot_carousel_impl::expire()
+{
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (now >= it->second.file.expires) {
+            d_logger->info("LOT file " + std::to_string(it->first) + " expired");
+            it = entries.erase(it);
+            shares_dirty = true;
+        } else {
+            it++;
+        }
+    }
+}
+
+/*
+ * If a receiver needs every part of a file, its expected wait is the time taken to
+ * send the whole file, i.e. its size divided by its share of the capacity. The
+ * priority-weighted sum of these waits is smallest when each share is proportional to
+ * sqrt(priority * size). Files with a deadline are first given the share they need to
+ * meet it, and the rest of the capacity is divided according to that rule.
+ */
+void lot_carousel_impl::update_shares()
+{
+    std::map<uint16_t, double> minimum;
+    double total_minimum = 0;
+    for (auto& kv : entries) {
+        const carousel_file& file = kv.second.file;
+        double min_share = 0;
+        if ((file.deadline > 0) && (parts_per_second > 0)) {
+            min_share = file.object->num_parts() / (file.deadline * parts_per_second);
+        }
+        minimum[kv.first] = min_share;
+        total_minimum += min_share;
+    }
+
+    if (total_minimum > 1) {
+        if (!deadline_warned) {
+            d_logger->warn("LOT deadlines exceed the available AAS capacity");
+            deadline_warned = true;
+        }
+        for (auto& kv : entries) {
+            kv.second.share = minimum[kv.first] / total_minimum;
+        }
+    } else {
+        deadline_warned = false;
+        divide_shares(minimum);
+    }
+
+    // A file whose share has grown should not wait out the stride of its old share
+    for (auto& kv : entries) {
+        carousel_entry& entry = kv.second;
+        if ((entry.share > 0) && (entry.pass > vtime + 1 / entry.share)) {
+            entry.pass = vtime + 1 / entry.share;
+        }
+    }
+}
+
+void lot_carousel_impl::divide_shares(std::map<uint16_t, double>& minimum)
+{
+    std::map<uint16_t, bool> fixed;
+    bool changed = true;
+    double remaining = 1;
+    double total_weight = 0;
+    while (changed) {
+        changed = false;
+        remaining = 1;
+        total_weight = 0;
+        for (auto& kv : entries) {
+            const carousel_file& file = kv.second.file;
+            if (fixed[kv.first]) {
+                remaining -= minimum[kv.first];
+            } else {
+                total_weight += std::sqrt(file.priority * file.object->num_parts());
+            }
+        }
+        for (auto& kv : entries) {
+            const carousel_file& file = kv.second.file;
+            double weight = std::sqrt(file.priority * file.object->num_parts());
+            if (!fixed[kv.first] &&
+                (remaining * weight / total_weight < minimum[kv.first])) {
+                fixed[kv.first] = true;
+                changed = true;
+            }
+        }
+    }
+
+    for (auto& kv : entries) {
+        const carousel_file& file = kv.second.file;
+        if (fixed[kv.first]) {
+            kv.second.share = minimum[kv.first];
+        } else {
+            double weight = std::sqrt(file.priority * file.object->num_parts());
+            kv.second.share = remaining * weight / total_weight;
+        }
+    }
+}
+
+/*
+ * Keeps up to LOT_WINDOW_PARTS PDUs queued at the Layer 2 encoder, choosing each part
+ * from the file furthest behind its share (stride scheduling), so that parts of all
+ * files are spread evenly through the carousel.
+ */
+void lot_carousel_impl::fill()
+{
+    expire();
+
+    while (total_outstanding < LOT_WINDOW_PARTS) {
+        if (shares_dirty) {
+            update_shares();
+            shares_dirty = false;
+        }
+
+        auto best = entries.end();
+        for (auto it = entries.begin(); it != entries.end(); it++) {
+            if (it->second.share <= 0) {
+                continue;
+            }
+            if ((best == entries.end()) || (it->second.pass < best->second.pass)) {
+                best = it;
+            }
+        }
+        if (best == entries.end()) {
+            return;
+        }
+
+        send_part(best->first, best->second);
+    }
+}
+
+void lot_carousel_impl::send_part(uint16_t lot_id, carousel_entry& entry)
+{
+    carousel_file& file = entry.file;
+    if ((entry.next_part == 0) && (file.changed != decltype(file.changed)())) {
+        auto latency = std::chrono::steady_clock::now() - file.changed;
+        air_seconds += std::chrono::duration<double>(latency).count();
+        air_count++;
+        file.changed = std::chrono::steady_clock::time_point();
+    }
+
+    uint16_t& seq = aas_seq[file.port];
+    std::vector<uint8_t> pdu = { AAS_PACKET_FORMAT,
+                                 (uint8_t)(file.port & 0xff),
+                                 (uint8_t)(file.port >> 8),
+                                 (uint8_t)(seq & 0xff),
+                                 (uint8_t)(seq >> 8) };
+    file.object->append_part(entry.next_part, pdu);
+    message_port_pub(pmt::intern("aas"),
+                     pmt::cons(pmt::make_dict(), pmt::init_u8vector(pdu.size(), pdu)));
+    seq++;
+    outstanding[file.port]++;
+    total_outstanding++;
+
+    vtime = entry.pass;
+    entry.pass += 1 / entry.share;
+
+    if (++entry.next_part < file.object->num_parts()) {
+        return;
+    }
+
+    entry.next_part = 0;
+    entry.cycles++;
+    if (entry.has_pending) {
+        entry.file = entry.pending;
+        entry.pending.object.reset();
+        entry.has_pending = false;
+        entry.cycles = 0;
+        shares_dirty = true;
+    } else if ((entry.file.repeat > 0) && (entry.cycles >= entry.file.repeat)) {
+        d_logger->info("LOT file " + std::to_string(lot_id) + " sent " +
+                       std::to_string(entry.cycles) + " times");
+        entries.erase(lot_id);
+        shares_dirty = true;
+    }
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
@@ -0,0 +1,109 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_LOT_CAROUSEL_IMPL_H
+#define INCLUDED_NRSC5_LOT_CAROUSEL_IMPL_H
+
+#include "lot_object.h"
+#include <nrsc5/lot_carousel.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace gr {
+namespace nrsc5 {
+
+/* A file and the parameters it is scheduled with */
+struct carousel_file {
+    std::shared_ptr<lot_object> object;
+    int port;
+    double priority;
+    int repeat;
+    std::chrono::steady_clock::time_point expires;
+    double deadline;
+    std::chrono::steady_clock::time_point changed; // when the spool file was written
+};
+
+struct carousel_entry {
+    carousel_file file;
+    carousel_file pending; // replaces file at the end of its current cycle
+    bool has_pending;
+    int next_part;
+    int cycles;
+    double share; // fraction of the carousel's capacity
+    double pass;  // virtual time at which the next part is due
+};
+
+class lot_carousel_impl : public lot_carousel
+{
+private:
+    mutable std::mutex mutex;
+    std::map<uint16_t, carousel_entry> entries;
+    std::map<int, int> outstanding;
+    std::map<int, uint16_t> aas_seq;
+    int total_outstanding;
+    double vtime;
+    bool shares_dirty;
+    bool deadline_warned;
+    bool started;
+
+    double parts_per_second;
+    int rate_parts;
+    std::chrono::steady_clock::time_point rate_start;
+
+    std::string command_line;
+
+    std::string spool_dir;
+    int spool_port;
+    int inotify_fd;
+    int wake_pipe[2];
+    std::thread spool_thread;
+    uint64_t ingested;
+    uint64_t ingest_count;
+    double ingest_seconds;
+    uint64_t air_count;
+    double air_seconds;
+
+    void handle_command(pmt::pmt_t msg);
+    void handle_notify(pmt::pmt_t msg);
+    void run_command(const std::string& command);
+    void add(uint16_t lot_id, const carousel_file& file);
+    void expire();
+    void update_shares();
+    void divide_shares(std::map<uint16_t, double>& minimum);
+    void fill();
+    void send_part(uint16_t lot_id, carousel_entry& entry);
+    void watch_spool();
+    void ingest(const std::string& name, std::chrono::steady_clock::time_point changed);
+    void withdraw(const std::string& name);
+
+public:
+    lot_carousel_impl(const std::string& spool_dir, int spool_port);
+    ~lot_carousel_impl();
+
+    void add_file(const std::string& filename,
+                  int lot_id,
+                  int port,
+                  double priority,
+                  int repeat,
+                  double expiry,
+                  double deadline) override;
+    void remove_file(int lot_id) override;
+    int num_files() const override;
+    uint64_t files_ingested() const override;
+    double ingest_latency() const override;
+    double air_latency() const override;
+
+    bool start() override;
+    bool stop() override;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_LOT_CAROUSEL_IMPL_H */
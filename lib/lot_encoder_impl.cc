@@ -0,0 +1,205 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "aas.h"
+#include "lot_encoder_impl.h"
+#include <gnuradio/io_signature.h>
+#include <sstream>
+
+namespace gr {
+namespace nrsc5 {
+
+lot_encoder::sptr lot_encoder::make(const std::string& filename, int lot_id, int port)
+{
+    return gnuradio::get_initial_sptr(new lot_encoder_impl(filename, lot_id, port));
+}
+
+
+/*
+ * The private constructor
+ */
+lot_encoder_impl::lot_encoder_impl(const std::string& filename, int lot_id, int port)
+    : gr::block("lot_encoder",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0))
+{
+    this->port = port;
+    next_part = 0;
+    aas_seq = 0;
+    stream_remaining = 0;
+    stream_id = 0;
+
+    if (!filename.empty()) {
+        std::string name = filename.substr(filename.find_last_of('/') + 1);
+        object = lot_object::from_file(filename, name, lot_id);
+    }
+
+    message_port_register_out(pmt::intern("aas"));
+
+    message_port_register_in(pmt::intern("file"));
+    set_msg_handler(pmt::intern("file"),
+                    [this](pmt::pmt_t msg) { this->handle_file(msg); });
+
+    message_port_register_in(pmt::intern("ready"));
+    set_msg_handler(pmt::intern("ready"),
+                    [this](pmt::pmt_t msg) { this->handle_notify(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+lot_encoder_impl::~lot_encoder_impl() {}
+
+bool lot_encoder_impl::start()
+{
+    aas_seq = 0;
+    send();
+    return block::start();
+}
+
+/*
+ * Accepts "file|<id>|<path>" to send a file from disk, or "streamfile|<id>|<size>|<name>"
+ * followed by <size> bytes of file contents. Commands are terminated by a newline.
+ */
+void lot_encoder_impl::handle_file(pmt::pmt_t msg)
+{
+    size_t len;
+    const uint8_t* bytes = pmt::u8vector_elements(pmt::cdr(msg), len);
+
+    size_t i = 0;
+    while (i < len) {
+        if (stream_remaining > 0) {
+            size_t n = std::min(stream_remaining, len - i);
+            stream_data.insert(stream_data.end(), bytes + i, bytes + i + n);
+            stream_remaining -= n;
+            i += n;
+            if (stream_remaining == 0) {
+                try {
+                    set_object(lot_object::from_data(
+                        std::move(stream_data), stream_name, stream_id));
+                } catch (const std::exception& e) {
+                    d_logger->error(e.what());
+                }
+                stream_data.clear();
+            }
+            continue;
+        }
+
+        if (bytes[i] == '\n') {
+            handle_command(command_line);
+            command_line.clear();
+        } else {
+            command_line += bytes[i];
+        }
+        i++;
+    }
+}
+
+void lot_encoder_impl::handle_command(const std::string& command)
+{
+    std::vector<std::string> parts;
+    std::istringstream stream(command);
+    std::string part;
+    while (std::getline(stream, part, '|')) {
+        parts.push_back(part);
+    }
+
+    try {
+        if ((parts.size() == 4) && (parts[0] == "streamfile")) {
+            stream_id = std::stoi(parts[1]);
+            stream_remaining = std::stoul(parts[2]);
+            stream_name = parts[3];
+            stream_data.clear();
+            stream_data.reserve(stream_remaining);
+            if (stream_remaining == 0) {
+                set_object(lot_object::from_data({}, stream_name, stream_id));
+            }
+        } else if ((parts.size() == 3) && (parts[0] == "file")) {
+            std::string name = parts[2].substr(parts[2].find_last_of('/') + 1);
+            set_object(lot_object::from_file(parts[2], name, std::stoi(parts[1])));
+        } else {
+            d_logger->warn("Invalid command: " + command);
+        }
+    } catch (const std::exception& e) {
+        d_logger->error(e.what());
+    }
+}
+
+/*
+ * A new file replaces the current one once the current one has been sent in full, so
+ * that receivers are not left with an incomplete object.
+ */
+void lot_encoder_impl::set_object(std::shared_ptr<lot_object> new_object)
+{
+    auto latest = next_object ? next_object : object;
+    if (latest && (latest->hash() == new_object->hash())) {
+        return;
+    }
+
+    if (!object || (next_part == 0)) {
+        object = new_object;
+        next_object.reset();
+    } else {
+        next_object = new_object;
+    }
+}
+
+void lot_encoder_impl::handle_notify(pmt::pmt_t msg)
+{
+    bool lockstep;
+    if (aas_ready_port(msg, lockstep) == port) {
+        send();
+        if (lockstep) {
+            message_port_pub(pmt::intern("aas"), aas_reply_end(port));
+        }
+    }
+}
+
+/*
+ * Queues the next few parts of the current file, stopping at the end of the file so
+ * that it is repeated only when the Layer 2 encoder has room for it.
+ */
+void lot_encoder_impl::send()
+{
+    if (next_object && (next_part == 0)) {
+        object = next_object;
+        next_object.reset();
+    }
+    if (!object || (object->num_parts() == 0)) {
+        return;
+    }
+
+    if (next_part == 0) {
+        d_logger->info("Sending LOT file " + std::to_string(object->id()) + ": " +
+                       object->name());
+    }
+
+    for (int i = 0; i < LOT_WINDOW_PARTS; i++) {
+        std::vector<uint8_t> pdu = { AAS_PACKET_FORMAT,
+                                     (uint8_t)(port & 0xff),
+                                     (uint8_t)(port >> 8),
+                                     (uint8_t)(aas_seq & 0xff),
+                                     (uint8_t)(aas_seq >> 8) };
+        object->append_part(next_part, pdu);
+        message_port_pub(
+            pmt::intern("aas"),
+            pmt::cons(pmt::make_dict(), pmt::init_u8vector(pdu.size(), pdu)));
+        aas_seq++;
+
+        if (++next_part == object->num_parts()) {
+            next_part = 0;
+            break;
+        }
+    }
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
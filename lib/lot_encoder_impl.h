@@ -0,0 +1,48 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2023, 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_LOT_ENCODER_IMPL_H
+#define INCLUDED_NRSC5_LOT_ENCODER_IMPL_H
+
+#include "lot_object.h"
+#include <nrsc5/lot_encoder.h>
+
+namespace gr {
+namespace nrsc5 {
+
+class lot_encoder_impl : public lot_encoder
+{
+private:
+    int port;
+    std::shared_ptr<lot_object> object;
+    std::shared_ptr<lot_object> next_object;
+    int next_part;
+    uint16_t aas_seq;
+
+    std::string command_line;
+    size_t stream_remaining;
+    std::vector<uint8_t> stream_data;
+    std::string stream_name;
+    uint16_t stream_id;
+
+    void handle_file(pmt::pmt_t msg);
+    void handle_notify(pmt::pmt_t msg);
+    void handle_command(const std::string& command);
+    void set_object(std::shared_ptr<lot_object> new_object);
+    void send();
+
+public:
+    lot_encoder_impl(const std::string& filename, int lot_id, int port);
+    ~lot_encoder_impl();
+
+    bool start() override;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_LOT_ENCODER_IMPL_H */
@@ -0,0 +1,196 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "lot_object.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+const uint8_t PNG_START[] = { 0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a };
+const uint8_t JPEG_START[] = { 0xff, 0xd8 };
+const uint8_t JPEG_END[] = { 0xff, 0xd9 };
+
+bool has_prefix(const uint8_t* data, size_t len, const uint8_t* prefix, size_t n)
+{
+    return (len >= n) && (memcmp(data, prefix, n) == 0);
+}
+
+bool has_suffix(const std::string& name, const std::string& suffix)
+{
+    if (name.length() < suffix.length()) {
+        return false;
+    }
+    std::string end = name.substr(name.length() - suffix.length());
+    std::transform(end.begin(), end.end(), end.begin(), ::tolower);
+    return end == suffix;
+}
+
+/* 64-bit FNV-1a */
+uint64_t fnv1a(uint64_t hash, const uint8_t* data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3;
+    }
+    return hash;
+}
+
+void append_le(std::vector<uint8_t>& out, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++) {
+        out.push_back((value >> (8 * i)) & 0xff);
+    }
+}
+
+/* The current time, or SOURCE_DATE_EPOCH if set, so that offline renders repeat */
+time_t current_time()
+{
+    const char* epoch = getenv("SOURCE_DATE_EPOCH");
+    if (epoch && *epoch) {
+        return (time_t)strtoll(epoch, nullptr, 10);
+    }
+    return time(nullptr);
+}
+
+} // namespace
+
+std::shared_ptr<lot_object>
+lot_object::from_file(const std::string& path, const std::string& name, uint16_t lot_id)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Unable to read " + path);
+    }
+
+    size_t len = st.st_size;
+    void* map = nullptr;
+    if (len > 0) {
+        map = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Unable to map " + path);
+        }
+    }
+    close(fd);
+
+    try {
+        return std::shared_ptr<lot_object>(
+            new lot_object((const uint8_t*)map, len, name, lot_id, map, {}));
+    } catch (...) {
+        if (map) {
+            munmap(map, len);
+        }
+        throw;
+    }
+}
+
+std::shared_ptr<lot_object>
+lot_object::from_data(std::vector<uint8_t> data, const std::string& name, uint16_t lot_id)
+{
+    const uint8_t* ptr = data.data();
+    size_t len = data.size();
+    return std::shared_ptr<lot_object>(
+        new lot_object(ptr, len, name, lot_id, nullptr, std::move(data)));
+}
+
+lot_object::lot_object(const uint8_t* data,
+                       size_t len,
+                       const std::string& name,
+                       uint16_t lot_id,
+                       void* map,
+                       std::vector<uint8_t> owned)
+    : data(data),
+      len(len),
+      map(map),
+      owned(std::move(owned)),
+      filename(name),
+      lot_id(lot_id),
+      expiry_time(0)
+{
+    if (name.length() > LOT_MAX_NAME_LENGTH) {
+        throw std::invalid_argument("File name too long: " + name);
+    }
+
+    if (has_prefix(data, len, PNG_START, sizeof(PNG_START))) {
+        mime_type = mime_hash::PNG;
+    } else if (has_prefix(data, len, JPEG_START, sizeof(JPEG_START)) &&
+               (len >= sizeof(JPEG_END)) &&
+               (memcmp(data + len - sizeof(JPEG_END), JPEG_END, sizeof(JPEG_END)) ==
+                0)) {
+        mime_type = mime_hash::JPEG;
+    } else if (has_suffix(name, ".png")) {
+        mime_type = mime_hash::PNG;
+    } else if (has_suffix(name, ".jpg") || has_suffix(name, ".jpeg")) {
+        mime_type = mime_hash::JPEG;
+    } else if (has_suffix(name, ".txt")) {
+        mime_type = mime_hash::TEXT;
+    } else {
+        throw std::invalid_argument(
+            "Unsupported file type. Supported types: PNG, JPG, TXT.");
+    }
+
+    // Identifies unchanged objects, so that they need not be restarted
+    content_hash = fnv1a(0xcbf29ce484222325, (const uint8_t*)&lot_id, sizeof(lot_id));
+    content_hash = fnv1a(content_hash, (const uint8_t*)filename.data(), filename.size());
+    content_hash = fnv1a(content_hash, data, len);
+}
+
+lot_object::~lot_object()
+{
+    if (map) {
+        munmap(map, len);
+    }
+}
+
+void lot_object::append_part(int seq, std::vector<uint8_t>& out) const
+{
+    int header_len = (seq == 0) ? 24 + filename.length() : 8;
+    int repeat = 1;
+
+    out.push_back(header_len);
+    out.push_back(repeat);
+    append_le(out, lot_id, 2);
+    append_le(out, seq, 4);
+
+    if (seq == 0) {
+        int version = 1;
+
+        time_t expiry = expiry_time ? expiry_time : current_time() + 365 * 24 * 60 * 60;
+        struct tm tm;
+        gmtime_r(&expiry, &tm);
+        uint32_t expiry_field = ((tm.tm_year + 1900) << 20) | ((tm.tm_mon + 1) << 16) |
+                                (tm.tm_mday << 11) | (tm.tm_hour << 6) | tm.tm_min;
+
+        append_le(out, version, 4);
+        append_le(out, expiry_field, 4);
+        append_le(out, len, 4);
+        append_le(out, static_cast<uint32_t>(mime_type), 4);
+        out.insert(out.end(), filename.begin(), filename.end());
+    }
+
+    size_t offset = (size_t)seq * LOT_PART_SIZE;
+    size_t chunk = std::min((size_t)LOT_PART_SIZE, len - offset);
+    out.insert(out.end(), data + offset, data + offset + chunk);
+}
+
+} // namespace nrsc5
+} // namespace gr
@@ -0,0 +1,79 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_LOT_OBJECT_H
+#define INCLUDED_NRSC5_LOT_OBJECT_H
+
+#include <nrsc5/api.h>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+constexpr uint8_t AAS_PACKET_FORMAT = 0x21;
+constexpr int LOT_PART_SIZE = 256;
+
+/* Longest file name that fits in the one-byte header length of a first part */
+constexpr size_t LOT_MAX_NAME_LENGTH = 255 - 24;
+
+/* Number of AAS PDUs queued at the Layer 2 encoder each time it asks for more */
+constexpr int LOT_WINDOW_PARTS = 8;
+
+/*
+ * A file to be sent by Large Object Transfer. The file is split into parts of
+ * LOT_PART_SIZE bytes, each prefixed with a LOT header. Parts are generated on demand
+ * from the file contents, which are memory-mapped when read from disk.
+ */
+class lot_object
+{
+public:
+    static std::shared_ptr<lot_object>
+    from_file(const std::string& path, const std::string& name, uint16_t lot_id);
+    static std::shared_ptr<lot_object>
+    from_data(std::vector<uint8_t> data, const std::string& name, uint16_t lot_id);
+    ~lot_object();
+
+    uint16_t id() const { return lot_id; }
+    const std::string& name() const { return filename; }
+    size_t size() const { return len; }
+    mime_hash mime() const { return mime_type; }
+    uint64_t hash() const { return content_hash; }
+    int num_parts() const { return (len + LOT_PART_SIZE - 1) / LOT_PART_SIZE; }
+
+    /* Expiry time announced to receivers; by default, one year after sending */
+    void set_expiry(time_t expiry) { expiry_time = expiry; }
+
+    /* Appends part seq, including its LOT header, to out */
+    void append_part(int seq, std::vector<uint8_t>& out) const;
+
+private:
+    lot_object(const uint8_t* data,
+               size_t len,
+               const std::string& name,
+               uint16_t lot_id,
+               void* map,
+               std::vector<uint8_t> owned);
+
+    const uint8_t* data;
+    size_t len;
+    void* map;
+    std::vector<uint8_t> owned;
+    std::string filename;
+    uint16_t lot_id;
+    mime_hash mime_type;
+    uint64_t content_hash;
+    time_t expiry_time;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_LOT_OBJECT_H */
@@ -0,0 +1,429 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <nrsc5/core/ofdm_modulator.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+/*
+from sage.calculus.integration import numerical_integral
+
+delta_f = 1488375 / 8192
+alpha = 7/128
+T = 1 / delta_f
+Ts = (1+alpha) / delta_f
+
+H(x) = piecewise([
+    ((-(1-alpha)/2*T, (1-alpha)/2*T), 1),
+    ([-(1+alpha)/2*T, -(1-alpha)/2*T], 1/2*(1 + cos(pi/(2*alpha)*(2*(-x)/T + alpha-1)))),
+    ([(1-alpha)/2*T, (1+alpha)/2*T], 1/2*(1 + cos(pi/(2*alpha)*(2*x/T + alpha-1)))),
+    ((-oo, -(1+alpha)/2*T), 0),
+    (((1+alpha)/2*T, oo), 0)
+])
+
+G(x) = 90 / (Ts * sqrt(2*pi)) * e^(-4050 * (x/Ts)^2)
+
+tau = var("tau")
+pulse1 = [sqrt(numerical_integral(H(tau) * G((i/270)*Ts - tau), -Ts, Ts)[0])
+          for i in range(-256, 256)]
+for i in range(0, 512, 8):
+    print(f"    {pulse1[i]:.6f}, {pulse1[i+1]:.6f}, {pulse1[i+2]:.6f}, {pulse1[i+3]:.6f},"
+          f" {pulse1[i+4]:.6f}, {pulse1[i+5]:.6f}, {pulse1[i+6]:.6f}, {pulse1[i+7]:.6f},")
+*/
+
+const float pulse[] = {
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000001, 0.000003, 0.000011, 0.000031, 0.000088, 0.000231,
+    0.000577, 0.008637, 0.015042, 0.025040, 0.039899, 0.060941, 0.089370, 0.126069,
+    0.171413, 0.225144, 0.286341, 0.353500, 0.424689, 0.497751, 0.570505, 0.640895,
+    0.707107, 0.767629, 0.821294, 0.867320, 0.905339, 0.935435, 0.958128, 0.974326,
+    0.985199, 0.992021, 0.995998, 0.998141, 0.999204, 0.999686, 0.999887, 0.999963,
+    0.999989, 0.999997, 0.999999, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 0.999999, 0.999997,
+    0.999989, 0.999963, 0.999887, 0.999686, 0.999204, 0.998141, 0.995998, 0.992021,
+    0.985199, 0.974326, 0.958128, 0.935435, 0.905339, 0.867320, 0.821294, 0.767629,
+    0.707107, 0.640895, 0.570505, 0.497751, 0.424689, 0.353500, 0.286341, 0.225144,
+    0.171413, 0.126069, 0.089370, 0.060941, 0.039899, 0.025040, 0.015042, 0.008637,
+    0.000577, 0.000231, 0.000088, 0.000031, 0.000011, 0.000003, 0.000001, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000,
+    0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000, 0.000000
+};
+
+/*
+ * Fixed-point samples inside the sc16 modulators carry this many bits below the least
+ * significant bit of the int16 output, so that rounding in the IFFT stays well below
+ * the rounding of the output itself.
+ */
+constexpr int FRAC_BITS = 6;
+
+/* Subcarrier gains are Q16, and windows and pulse shapes Q15 */
+constexpr int GAIN_BITS = 16;
+constexpr int SHAPE_BITS = 15;
+
+/* Rounds x / 2^shift to the nearest integer */
+inline int64_t round_shift(int64_t x, int shift)
+{
+    return (x + ((int64_t)1 << (shift - 1))) >> shift;
+}
+
+inline int16_t saturate(int64_t x)
+{
+    return (int16_t)std::min<int64_t>(std::max<int64_t>(x, INT16_MIN), INT16_MAX);
+}
+
+/*
+ * Converts the gain from a Q14 subcarrier value to the internal scale. The IFFT does
+ * not scale between stages, so the largest possible input, with every subcarrier
+ * adding up in phase, must still fit in 32 bits (with a factor of two to spare).
+ */
+int32_t fixed_gain(double gain, int fft_size)
+{
+    double q16 = std::round(gain * (1 << GAIN_BITS));
+    double peak = q16 / (1 << GAIN_BITS) * 32768 * M_SQRT2 * fft_size;
+    if (peak >= INT32_MAX / 2) {
+        throw std::invalid_argument("full_scale is too small for the fixed-point IFFT");
+    }
+    return (int32_t)q16;
+}
+
+/* Internal samples per unit of amplitude, for a given full scale */
+double internal_scale(double full_scale)
+{
+    if (!(full_scale > 0)) {
+        throw std::invalid_argument("full_scale must be positive");
+    }
+    return INT16_MAX * (1 << FRAC_BITS) / full_scale;
+}
+
+inline inverse_fft_q15::sample scale_subcarrier(const sc16_t& x, int32_t gain)
+{
+    return inverse_fft_q15::sample(round_shift((int64_t)x.real() * gain, GAIN_BITS),
+                                   round_shift((int64_t)x.imag() * gain, GAIN_BITS));
+}
+
+/* Amplitude of FM subcarrier i, with sideband levels in dB relative to the carrier */
+double fm_level(int i, double lsb_power_db, double usb_power_db)
+{
+    constexpr int fft_size = fm_ofdm_modulator::FFT_SIZE;
+    const double base = std::sqrt((135.0 / 128) * (1.0 / 2) * (1.0 / 191));
+    double db = (i < fft_size / 2) ? lsb_power_db : usb_power_db;
+    return std::pow(10, db / 20) * base;
+}
+
+/* Raised-cosine window of FM symbol sample i, over the cyclic extension */
+double fm_window(int i)
+{
+    constexpr int fft_size = fm_ofdm_modulator::FFT_SIZE;
+    constexpr int cp_size = fm_ofdm_modulator::CP_SIZE;
+    if (i < cp_size) {
+        return std::sin(M_PI / 2 * i / cp_size);
+    } else if (i >= fft_size) {
+        return std::cos(M_PI / 2 * (i - fft_size) / cp_size);
+    }
+    return 1;
+}
+
+} // namespace
+
+inverse_fft::inverse_fft(int size) : n(size), order(size), twiddle(size / 2)
+{
+    if ((size < 2) || ((size & (size - 1)) != 0)) {
+        throw std::invalid_argument("FFT size must be a power of two");
+    }
+
+    int bits = 0;
+    while ((1 << bits) < n) {
+        bits++;
+    }
+    for (int i = 0; i < n; i++) {
+        int reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        order[i] = reversed;
+    }
+
+    for (int i = 0; i < n / 2; i++) {
+        double angle = 2 * M_PI * i / n;
+        twiddle[i] = gr_complex(std::cos(angle), std::sin(angle));
+    }
+}
+
+void inverse_fft::execute(const gr_complex* in, gr_complex* out) const
+{
+    for (int k = 0; k < n; k++) {
+        out[order[k]] = in[(k + n / 2) % n];
+    }
+
+    // iterative radix-2 decimation in time
+    for (int len = 2; len <= n; len <<= 1) {
+        int half = len / 2;
+        int step = n / len;
+        for (int i = 0; i < n; i += len) {
+            for (int j = 0; j < half; j++) {
+                gr_complex u = out[i + j];
+                gr_complex v = out[i + j + half] * twiddle[j * step];
+                out[i + j] = u + v;
+                out[i + j + half] = u - v;
+            }
+        }
+    }
+}
+
+fm_ofdm_modulator::fm_ofdm_modulator(double lsb_power_db, double usb_power_db)
+    : ifft(FFT_SIZE),
+      levels(FFT_SIZE),
+      window(SYMBOL_SIZE),
+      scaled(FFT_SIZE),
+      symbol(FFT_SIZE)
+{
+    for (int i = 0; i < FFT_SIZE; i++) {
+        levels[i] = fm_level(i, lsb_power_db, usb_power_db);
+    }
+    for (int i = 0; i < SYMBOL_SIZE; i++) {
+        window[i] = fm_window(i);
+    }
+}
+
+void fm_ofdm_modulator::modulate(const gr_complex* in, gr_complex* out, int nsymbols)
+{
+    for (int s = 0; s < nsymbols; s++) {
+        for (int i = 0; i < FFT_SIZE; i++) {
+            scaled[i] = in[i] * levels[i];
+        }
+        ifft.execute(scaled.data(), symbol.data());
+
+        // the first CP_SIZE samples are repeated at the end of the symbol
+        for (int i = 0; i < SYMBOL_SIZE; i++) {
+            out[i] = std::conj(symbol[i % FFT_SIZE] * window[i]);
+        }
+
+        in += FFT_SIZE;
+        out += SYMBOL_SIZE;
+    }
+}
+
+am_ofdm_modulator::am_ofdm_modulator() : ifft(FFT_SIZE), prev(FFT_SIZE), cur(FFT_SIZE)
+{
+}
+
+void am_ofdm_modulator::modulate(const gr_complex* in, gr_complex* out, int nsymbols)
+{
+    for (int s = 0; s < nsymbols; s++) {
+        ifft.execute(in, cur.data());
+        shape(prev.data(), cur.data(), out);
+        prev.swap(cur);
+
+        in += FFT_SIZE;
+        out += SYMBOL_SIZE;
+    }
+}
+
+void am_ofdm_modulator::shape(const gr_complex* prev,
+                              const gr_complex* cur,
+                              gr_complex* out)
+{
+    for (int i = 0; i < FFT_SIZE; i++) {
+        out[i] = prev[i] * pulse[FFT_SIZE + i];
+    }
+    for (int i = FFT_SIZE; i < SYMBOL_SIZE; i++) {
+        out[i] = 0;
+    }
+    for (int i = 0; i < FFT_SIZE; i++) {
+        out[CP_SIZE + i] += cur[i] * pulse[i];
+    }
+}
+
+inverse_fft_q15::inverse_fft_q15(int size) : n(size), order(size), twiddle(size / 2)
+{
+    if ((size < 2) || ((size & (size - 1)) != 0)) {
+        throw std::invalid_argument("FFT size must be a power of two");
+    }
+
+    int bits = 0;
+    while ((1 << bits) < n) {
+        bits++;
+    }
+    for (int i = 0; i < n; i++) {
+        int reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        order[i] = reversed;
+    }
+
+    // Q15 with 1.0 at 32768, which needs more than 16 bits. Scaling by INT16_MAX
+    // instead would shrink every product by 2^-15, which adds up over the stages.
+    for (int i = 0; i < n / 2; i++) {
+        double angle = 2 * M_PI * i / n;
+        twiddle[i] = std::complex<int32_t>(std::lround(std::cos(angle) * (1 << 15)),
+                                           std::lround(std::sin(angle) * (1 << 15)));
+    }
+}
+
+void inverse_fft_q15::execute(const sample* in, sample* out) const
+{
+    for (int k = 0; k < n; k++) {
+        out[order[k]] = in[(k + n / 2) % n];
+    }
+
+    // iterative radix-2 decimation in time, with products rounded back to 32 bits
+    for (int len = 2; len <= n; len <<= 1) {
+        int half = len / 2;
+        int step = n / len;
+        for (int i = 0; i < n; i += len) {
+            for (int j = 0; j < half; j++) {
+                sample u = out[i + j];
+                sample x = out[i + j + half];
+                const std::complex<int32_t>& w = twiddle[j * step];
+                int32_t v_re = round_shift(
+                    (int64_t)x.real() * w.real() - (int64_t)x.imag() * w.imag(), 15);
+                int32_t v_im = round_shift(
+                    (int64_t)x.real() * w.imag() + (int64_t)x.imag() * w.real(), 15);
+                out[i + j] = sample(u.real() + v_re, u.imag() + v_im);
+                out[i + j + half] = sample(u.real() - v_re, u.imag() - v_im);
+            }
+        }
+    }
+}
+
+fm_ofdm_modulator_sc16::fm_ofdm_modulator_sc16(double lsb_power_db,
+                                               double usb_power_db,
+                                               double full_scale)
+    : ifft(FFT_SIZE), gains(FFT_SIZE), scaled(FFT_SIZE), symbol(FFT_SIZE)
+{
+    double scale = internal_scale(full_scale) / L1_SC16_ONE;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        gains[i] = fixed_gain(fm_level(i, lsb_power_db, usb_power_db) * scale, FFT_SIZE);
+    }
+    for (int i = 0; i < SYMBOL_SIZE; i++) {
+        window.push_back(std::lround(fm_window(i) * (1 << SHAPE_BITS)));
+    }
+}
+
+void fm_ofdm_modulator_sc16::modulate(const sc16_t* in, sc16_t* out, int nsymbols)
+{
+    for (int s = 0; s < nsymbols; s++) {
+        for (int i = 0; i < FFT_SIZE; i++) {
+            scaled[i] = scale_subcarrier(in[i], gains[i]);
+        }
+        ifft.execute(scaled.data(), symbol.data());
+
+        // the first CP_SIZE samples are repeated at the end of the symbol
+        for (int i = 0; i < SYMBOL_SIZE; i++) {
+            const inverse_fft_q15::sample& x = symbol[i % FFT_SIZE];
+            int64_t re = (int64_t)x.real() * window[i];
+            int64_t im = (int64_t)x.imag() * window[i];
+            out[i] = sc16_t(saturate(round_shift(re, SHAPE_BITS + FRAC_BITS)),
+                            saturate(round_shift(-im, SHAPE_BITS + FRAC_BITS)));
+        }
+
+        in += FFT_SIZE;
+        out += SYMBOL_SIZE;
+    }
+}
+
+am_ofdm_modulator_sc16::am_ofdm_modulator_sc16(double full_scale, double carrier)
+    : ifft(FFT_SIZE),
+      gain(fixed_gain(internal_scale(full_scale) / L1_SC16_ONE, FFT_SIZE)),
+      carrier(std::llround(carrier * internal_scale(full_scale)) << SHAPE_BITS),
+      scaled(FFT_SIZE),
+      prev(FFT_SIZE),
+      cur(FFT_SIZE)
+{
+    for (int i = 0; i < 2 * FFT_SIZE; i++) {
+        pulse_q15.push_back(std::lround(pulse[i] * (1 << SHAPE_BITS)));
+    }
+}
+
+void am_ofdm_modulator_sc16::modulate(const sc16_t* in, sc16_t* out, int nsymbols)
+{
+    for (int s = 0; s < nsymbols; s++) {
+        for (int i = 0; i < FFT_SIZE; i++) {
+            scaled[i] = scale_subcarrier(in[i], gain);
+        }
+        ifft.execute(scaled.data(), cur.data());
+
+        // as in am_ofdm_modulator::shape: the tail of the previous symbol overlaps
+        // the start of this one
+        for (int i = 0; i < SYMBOL_SIZE; i++) {
+            int64_t re = carrier, im = 0;
+            if (i < FFT_SIZE) {
+                re += (int64_t)prev[i].real() * pulse_q15[FFT_SIZE + i];
+                im += (int64_t)prev[i].imag() * pulse_q15[FFT_SIZE + i];
+            }
+            if (i >= CP_SIZE) {
+                re += (int64_t)cur[i - CP_SIZE].real() * pulse_q15[i - CP_SIZE];
+                im += (int64_t)cur[i - CP_SIZE].imag() * pulse_q15[i - CP_SIZE];
+            }
+            out[i] = sc16_t(saturate(round_shift(re, SHAPE_BITS + FRAC_BITS)),
+                            saturate(round_shift(im, SHAPE_BITS + FRAC_BITS)));
+        }
+        prev.swap(cur);
+
+        in += FFT_SIZE;
+        out += SYMBOL_SIZE;
+    }
+}
+
+} // namespace nrsc5
+} // namespace gr
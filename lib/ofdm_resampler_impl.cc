@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "ofdm_resampler_impl.h"
+#include <gnuradio/io_signature.h>
+
+namespace gr {
+namespace nrsc5 {
+
+ofdm_resampler::sptr
+ofdm_resampler::make(pids_mode band, double sample_rate, double rejection_db)
+{
+    return gnuradio::make_block_sptr<ofdm_resampler_impl>(
+        band, sample_rate, rejection_db);
+}
+
+
+/*
+ * The private constructor
+ */
+ofdm_resampler_impl::ofdm_resampler_impl(pids_mode band,
+                                         double sample_rate,
+                                         double rejection_db)
+    : gr::block("ofdm_resampler",
+                gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                gr::io_signature::make(1, 1, sizeof(gr_complex))),
+      resampler((band == pids_mode::FM) ? FM_OFDM_SAMPLE_RATE : AM_OFDM_SAMPLE_RATE,
+                sample_rate,
+                (band == pids_mode::FM) ? FM_OFDM_BANDWIDTH : AM_OFDM_BANDWIDTH,
+                rejection_db)
+{
+    set_relative_rate((uint64_t)resampler.interpolation(),
+                      (uint64_t)resampler.decimation());
+}
+
+/*
+ * Our virtual destructor.
+ */
+ofdm_resampler_impl::~ofdm_resampler_impl() {}
+
+/* Input samples that produce at least the outputs still needed */
+int ofdm_resampler_impl::inputs_needed(int noutput_items) const
+{
+    int64_t outputs = noutput_items - (int64_t)pending.size();
+    if (outputs <= 0) {
+        return 0;
+    }
+    int64_t interp = resampler.interpolation();
+    return (int)((outputs * resampler.decimation() + interp - 1) / interp);
+}
+
+void ofdm_resampler_impl::forecast(int noutput_items,
+                                   gr_vector_int& ninput_items_required)
+{
+    // pending output can always be delivered, even once the input has ended
+    ninput_items_required[0] = pending.empty() ? inputs_needed(noutput_items) : 0;
+}
+
+int ofdm_resampler_impl::general_work(int noutput_items,
+                                      gr_vector_int& ninput_items,
+                                      gr_vector_const_void_star& input_items,
+                                      gr_vector_void_star& output_items)
+{
+    auto in = static_cast<const gr_complex*>(input_items[0]);
+    auto out = static_cast<gr_complex*>(output_items[0]);
+
+    int ninput = std::min(ninput_items[0], inputs_needed(noutput_items));
+    resampler.process(in, ninput, pending);
+    consume_each(ninput);
+
+    int n = std::min<int>(noutput_items, pending.size());
+    std::copy(pending.begin(), pending.begin() + n, out);
+    pending.erase(pending.begin(), pending.begin() + n);
+    return n;
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
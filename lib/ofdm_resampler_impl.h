@@ -0,0 +1,42 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_OFDM_RESAMPLER_IMPL_H
+#define INCLUDED_NRSC5_OFDM_RESAMPLER_IMPL_H
+
+#include <nrsc5/core/rational_resampler.h>
+#include <nrsc5/ofdm_resampler.h>
+
+namespace gr {
+namespace nrsc5 {
+
+class ofdm_resampler_impl : public ofdm_resampler
+{
+private:
+    polyphase_resampler resampler;
+
+    // output computed beyond what the last call had room for
+    std::vector<gr_complex> pending;
+
+    int inputs_needed(int noutput_items) const;
+
+public:
+    ofdm_resampler_impl(pids_mode band, double sample_rate, double rejection_db);
+    ~ofdm_resampler_impl();
+
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required);
+
+    int general_work(int noutput_items,
+                     gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items,
+                     gr_vector_void_star& output_items);
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_OFDM_RESAMPLER_IMPL_H */
@@ -9,7 +9,6 @@
 #include "config.h"
 #endif
 
-#include "hdlc.h"
 #include "psd_encoder_impl.h"
 #include <gnuradio/io_signature.h>
 #include <sstream>
@@ -20,10 +19,12 @@ namespace nrsc5 {
 psd_encoder::sptr psd_encoder::make(const int prog_num,
                                     const std::string& title,
                                     const std::string& artist,
-                                    const int bytes_per_frame)
+                                    const int bytes_per_frame,
+                                    const bool preempt,
+                                    const int lookahead_frames)
 {
-    return gnuradio::get_initial_sptr(
-        new psd_encoder_impl(prog_num, title, artist, bytes_per_frame));
+    return gnuradio::get_initial_sptr(new psd_encoder_impl(
+        prog_num, title, artist, bytes_per_frame, preempt, lookahead_frames));
 }
 
 
@@ -33,24 +34,31 @@ psd_encoder::sptr psd_encoder::make(const int prog_num,
 psd_encoder_impl::psd_encoder_impl(const int prog_num,
                                    const std::string& title,
                                    const std::string& artist,
-                                   const int bytes_per_frame)
+                                   const int bytes_per_frame,
+                                   const bool preempt,
+                                   const int lookahead_frames)
     : gr::sync_block("psd_encoder",
                      gr::io_signature::make(0, 0, 0),
-                     gr::io_signature::make(1, 1, sizeof(unsigned char)))
+                     gr::io_signature::make(1, 1, sizeof(unsigned char))),
+      stream(prog_num, title, artist, preempt)
 {
-    this->prog_num = prog_num;
-    this->title = title;
-    this->artist = artist;
+    if (lookahead_frames < 0) {
+        throw std::invalid_argument("lookahead must not be negative");
+    }
+
     this->bytes_per_frame = bytes_per_frame;
-    lot = -1;
-    seq_num = 0;
-    packet_off = 0;
+    frames_clocked = 0;
+    underrun_count = 0;
 
-    set_max_output_buffer(0, 4096);
+    // In preemption mode, only the PSD needed by the next PDU is generated ahead of
+    // time, so that metadata updates are not stuck behind stale packets.
+    this->lookahead_frames = preempt ? 0 : lookahead_frames;
 
     if (this->bytes_per_frame > 0) {
-        bytes_allowed = 2 * this->bytes_per_frame;
+        bytes_allowed = this->bytes_per_frame * (1 + this->lookahead_frames);
+        set_max_output_buffer(0, preempt ? bytes_allowed : std::max(4096, bytes_allowed));
     } else {
+        set_max_output_buffer(0, 4096);
         bytes_allowed = INT_MAX;
     }
 
@@ -75,117 +83,40 @@ int psd_encoder_impl::work(int noutput_items,
     unsigned char* out = (unsigned char*)output_items[0];
 
     int noutput_items_reduced = std::min(noutput_items, bytes_allowed);
-
-    for (int off = 0; off < noutput_items_reduced; off++) {
-        if (packet_off == packet.size()) {
-            std::string packet_str =
-                encode_psd_packet(AAS_PACKET_FORMAT, PORT[prog_num], seq_num++);
-            std::vector<unsigned char> packet_vect(packet_str.begin(), packet_str.end());
-            packet = hdlc_encode(packet_vect);
-
-            packet_off = 0;
-        }
-        out[off] = packet[packet_off++];
-    }
+    stream.produce(out, noutput_items_reduced, nitems_written(0));
 
     bytes_allowed -= noutput_items_reduced;
     return noutput_items_reduced;
 }
 
-std::string psd_encoder_impl::encode_psd_packet(uint8_t dtpf, uint16_t port, uint16_t seq)
-{
-    std::stringstream out;
-
-    out << dtpf;
-    out << (char)(port & 0xff);
-    out << (char)(port >> 8);
-    out << (char)(seq & 0xff);
-    out << (char)(seq >> 8);
-    out << encode_id3();
-    out << "UF";
-
-    return out.str();
-}
-
-std::string psd_encoder_impl::encode_id3()
-{
-    std::stringstream out;
-
-    std::string payload = encode_text_frame("TIT2", title) +
-                          encode_text_frame("TPE1", artist) + encode_xhdr_frame();
-    int len = payload.length();
-
-    out << "ID3";
-    out << (char)3;
-    out << (char)0;
-    out << (char)0;
-    out << (char)((len >> 21) & 0x7f);
-    out << (char)((len >> 14) & 0x7f);
-    out << (char)((len >> 7) & 0x7f);
-    out << (char)(len & 0x7f);
-    out << payload;
-
-    return out.str();
-}
-
-std::string psd_encoder_impl::encode_text_frame(const std::string& id,
-                                                const std::string& data)
-{
-    std::stringstream out;
-
-    int len = data.length() + 1;
-
-    out << id;
-    out << (char)((len >> 24) & 0xff);
-    out << (char)((len >> 16) & 0xff);
-    out << (char)((len >> 8) & 0xff);
-    out << (char)(len & 0xff);
-    out << (char)0;
-    out << (char)0;
-    out << (char)0;
-    out << data;
-
-    return out.str();
-}
-
-std::string psd_encoder_impl::encode_xhdr_frame()
-{
-    std::stringstream out;
-
-    int param = (lot >= 0) ? 0 : 1;
-    int extlen = (lot >= 0) ? 2 : 0;
-    int len = 6 + extlen;
-    uint32_t mime_int = static_cast<int>(mime_hash::PRIMARY_IMAGE);
-
-    out << "XHDR";
-    out << (char)((len >> 24) & 0xff);
-    out << (char)((len >> 16) & 0xff);
-    out << (char)((len >> 8) & 0xff);
-    out << (char)(len & 0xff);
-    out << (char)0;
-    out << (char)0;
-    out << (char)(mime_int & 0xff);
-    out << (char)((mime_int >> 8) & 0xff);
-    out << (char)((mime_int >> 16) & 0xff);
-    out << (char)((mime_int >> 24) & 0xff);
-    out << (char)param;
-    out << (char)extlen;
-
-    if (lot >= 0) {
-        out << (char)(lot & 0xff);
-        out << (char)((lot >> 8) & 0xff);
-    }
-
-    return out.str();
-}
-
 void psd_encoder_impl::handle_clock(pmt::pmt_t msg)
 {
-    if (bytes_per_frame > 0) {
-        bytes_allowed += bytes_per_frame;
+    // The clock carries the number of frames consumed so far by the Layer 1 encoder
+    uint64_t frames_consumed = pmt::to_long(msg);
+    if ((bytes_per_frame > 0) && (frames_consumed > frames_clocked)) {
+        frames_clocked = frames_consumed;
+
+        // The Layer 1 encoder has to wait if its next frame of PSD is not ready, and
+        // we are to blame if we were already allowed to generate it
+        int64_t produced = nitems_written(0);
+        if ((bytes_allowed > 0) &&
+            (produced < (int64_t)(frames_clocked + 1) * bytes_per_frame)) {
+            underrun_count++;
+        }
+        int64_t target =
+            (int64_t)(frames_clocked + 1 + lookahead_frames) * bytes_per_frame;
+        bytes_allowed = target - produced;
+
+        long latency_ms;
+        if (stream.meta_on_air(frames_clocked * bytes_per_frame, latency_ms)) {
+            d_logger->info("Metadata update on air after " +
+                           std::to_string(latency_ms) + " ms");
+        }
     }
 }
 
+uint64_t psd_encoder_impl::underruns() const { return underrun_count; }
+
 void psd_encoder_impl::set_meta(const pmt::pmt_t& msg)
 {
     int msg_len = pmt::blob_length(pmt::cdr(msg));
@@ -193,20 +124,8 @@ void psd_encoder_impl::set_meta(const pmt::pmt_t& msg)
 
     for (int i = 0; i < msg_len; i++) {
         if (msg_data[i] == '\n') {
-            std::string line = meta_buffer.str();
+            stream.set_meta(meta_buffer.str());
             meta_buffer.str("");
-
-            if (line.rfind("title", 0) == 0) {
-                title = line.substr(5, msg_len - 5);
-            } else if (line.rfind("artist", 0) == 0) {
-                artist = line.substr(6, msg_len - 6);
-            } else if (line.rfind("lot", 0) == 0) {
-                try {
-                    lot = std::stoi(line.substr(3, msg_len - 3));
-                } catch (std::invalid_argument& err) {
-                    // ignore
-                }
-            }
         } else {
             meta_buffer << msg_data[i];
         }
@@ -8,34 +8,24 @@
 #ifndef INCLUDED_NRSC5_PSD_ENCODER_IMPL_H
 #define INCLUDED_NRSC5_PSD_ENCODER_IMPL_H
 
+#include "psd_stream.h"
 #include <nrsc5/psd_encoder.h>
+#include <atomic>
+#include <sstream>
 
 namespace gr {
 namespace nrsc5 {
 
-constexpr uint16_t PORT[] = { 0x5100, 0x5201, 0x5202, 0x5203,
-                              0x5204, 0x5205, 0x5206, 0x5207 };
-
-constexpr uint8_t AAS_PACKET_FORMAT = 0x21;
-
 class psd_encoder_impl : public psd_encoder
 {
 private:
-    int prog_num;
-    std::string title;
-    std::string artist;
-    int lot;
+    psd_stream stream;
     int bytes_per_frame;
-    uint16_t seq_num;
-    std::vector<unsigned char> packet;
-    int packet_off;
     int bytes_allowed;
+    int lookahead_frames;
     std::ostringstream meta_buffer;
-
-    std::string encode_psd_packet(uint8_t dtpf, uint16_t port, uint16_t seq);
-    std::string encode_id3();
-    std::string encode_text_frame(const std::string& id, const std::string& data);
-    std::string encode_xhdr_frame();
+    uint64_t frames_clocked;
+    std::atomic<uint64_t> underrun_count;
 
     void handle_clock(pmt::pmt_t msg);
     void set_meta(const pmt::pmt_t& msg);
@@ -44,13 +34,16 @@ public:
     psd_encoder_impl(const int prog_num,
                      const std::string& title,
                      const std::string& artist,
-                     const int bytes_per_frame = 0);
+                     const int bytes_per_frame = 0,
+                     const bool preempt = false,
+                     const int lookahead_frames = 1);
     ~psd_encoder_impl();
 
     // Where all the action really happens
     int work(int noutput_items,
              gr_vector_const_void_star& input_items,
              gr_vector_void_star& output_items);
+    uint64_t underruns() const override;
 };
 
 } // namespace nrsc5
@@ -0,0 +1,195 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "psd_multi_encoder_impl.h"
+#include <gnuradio/io_signature.h>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+psd_multi_encoder::sptr psd_multi_encoder::make(const int num_progs,
+                                                const int first_prog,
+                                                const std::vector<std::string> titles,
+                                                const std::vector<std::string> artists,
+                                                const int bytes_per_frame,
+                                                const bool preempt,
+                                                const int lookahead_frames)
+{
+    return gnuradio::get_initial_sptr(new psd_multi_encoder_impl(num_progs,
+                                                                 first_prog,
+                                                                 titles,
+                                                                 artists,
+                                                                 bytes_per_frame,
+                                                                 preempt,
+                                                                 lookahead_frames));
+}
+
+
+/*
+ * The private constructor
+ */
+psd_multi_encoder_impl::psd_multi_encoder_impl(const int num_progs,
+                                               const int first_prog,
+                                               const std::vector<std::string> titles,
+                                               const std::vector<std::string> artists,
+                                               const int bytes_per_frame,
+                                               const bool preempt,
+                                               const int lookahead_frames)
+    : gr::sync_block("psd_multi_encoder",
+                     gr::io_signature::make(0, 0, 0),
+                     gr::io_signature::make(num_progs, num_progs, sizeof(unsigned char)))
+{
+    constexpr int max_programs = sizeof(PORT) / sizeof(PORT[0]);
+    if ((first_prog < 0) || (num_progs < 1) || (first_prog + num_progs > max_programs)) {
+        throw std::invalid_argument("psd_multi_encoder: invalid program range");
+    }
+    if (((int)titles.size() != num_progs) || ((int)artists.size() != num_progs)) {
+        throw std::invalid_argument(
+            "psd_multi_encoder: need one title and artist per program");
+    }
+    if (lookahead_frames < 0) {
+        throw std::invalid_argument("psd_multi_encoder: lookahead must not be negative");
+    }
+
+    this->num_progs = num_progs;
+    this->first_prog = first_prog;
+    this->bytes_per_frame = bytes_per_frame;
+    this->lookahead_frames = preempt ? 0 : lookahead_frames;
+    frames_clocked = 0;
+    underrun_count = 0;
+
+    streams.reserve(num_progs);
+    for (int i = 0; i < num_progs; i++) {
+        streams.emplace_back(first_prog + i, titles[i], artists[i], preempt);
+    }
+
+    // All programs share one credit, since every output advances together
+    if (this->bytes_per_frame > 0) {
+        bytes_allowed = this->bytes_per_frame * (1 + this->lookahead_frames);
+    } else {
+        bytes_allowed = INT_MAX;
+    }
+
+    int buffer_size = 4096;
+    if (bytes_per_frame > 0) {
+        buffer_size = preempt ? bytes_allowed : std::max(4096, bytes_allowed);
+    }
+    for (int i = 0; i < num_progs; i++) {
+        set_max_output_buffer(i, buffer_size);
+    }
+
+    message_port_register_in(pmt::intern("clock"));
+    set_msg_handler(pmt::intern("clock"),
+                    [this](pmt::pmt_t msg) { this->handle_clock(msg); });
+
+    message_port_register_in(pmt::mp("set_meta"));
+    set_msg_handler(pmt::mp("set_meta"),
+                    [this](const pmt::pmt_t& msg) { this->set_meta(msg); });
+}
+
+/*
+ * Our virtual destructor.
+ */
+psd_multi_encoder_impl::~psd_multi_encoder_impl() {}
+
+int psd_multi_encoder_impl::work(int noutput_items,
+                                 gr_vector_const_void_star& input_items,
+                                 gr_vector_void_star& output_items)
+{
+    int noutput_items_reduced = std::min(noutput_items, bytes_allowed);
+    uint64_t offset = nitems_written(0);
+
+    for (int i = 0; i < num_progs; i++) {
+        streams[i].produce(
+            (unsigned char*)output_items[i], noutput_items_reduced, offset);
+    }
+
+    bytes_allowed -= noutput_items_reduced;
+    return noutput_items_reduced;
+}
+
+void psd_multi_encoder_impl::handle_clock(pmt::pmt_t msg)
+{
+    // The clock carries the number of frames consumed so far by the Layer 1 encoder
+    uint64_t frames_consumed = pmt::to_long(msg);
+    if ((bytes_per_frame > 0) && (frames_consumed > frames_clocked)) {
+        frames_clocked = frames_consumed;
+
+        // The Layer 1 encoder has to wait if its next frame of PSD is not ready, and
+        // we are to blame if we were already allowed to generate it
+        int64_t produced = nitems_written(0);
+        if ((bytes_allowed > 0) &&
+            (produced < (int64_t)(frames_clocked + 1) * bytes_per_frame)) {
+            underrun_count++;
+        }
+        int64_t target =
+            (int64_t)(frames_clocked + 1 + lookahead_frames) * bytes_per_frame;
+        bytes_allowed = target - produced;
+
+        for (int i = 0; i < num_progs; i++) {
+            long latency_ms;
+            if (streams[i].meta_on_air(frames_clocked * bytes_per_frame, latency_ms)) {
+                d_logger->info("Program " + std::to_string(first_prog + i) +
+                               " metadata update on air after " +
+                               std::to_string(latency_ms) + " ms");
+            }
+        }
+    }
+}
+
+uint64_t psd_multi_encoder_impl::underruns() const { return underrun_count; }
+
+/*
+ * Lines of the form "N|<field><value>" update program N. Lines without a program
+ * prefix apply to the first program.
+ */
+void psd_multi_encoder_impl::dispatch_meta(const std::string& line)
+{
+    int prog = first_prog;
+    std::string field = line;
+
+    size_t sep = line.find('|');
+    if ((sep != std::string::npos) && (sep > 0) &&
+        (line.find_first_not_of("0123456789") == sep)) {
+        try {
+            prog = std::stoi(line.substr(0, sep));
+        } catch (std::out_of_range& err) {
+            d_logger->warn("Ignoring metadata for program " + line.substr(0, sep));
+            return;
+        }
+        field = line.substr(sep + 1);
+    }
+
+    if ((prog < first_prog) || (prog >= first_prog + num_progs)) {
+        d_logger->warn("Ignoring metadata for program " + std::to_string(prog));
+        return;
+    }
+    streams[prog - first_prog].set_meta(field);
+}
+
+void psd_multi_encoder_impl::set_meta(const pmt::pmt_t& msg)
+{
+    int msg_len = pmt::blob_length(pmt::cdr(msg));
+    char* msg_data = (char*)pmt::blob_data(pmt::cdr(msg));
+
+    for (int i = 0; i < msg_len; i++) {
+        if (msg_data[i] == '\n') {
+            dispatch_meta(meta_buffer.str());
+            meta_buffer.str("");
+        } else {
+            meta_buffer << msg_data[i];
+        }
+    }
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
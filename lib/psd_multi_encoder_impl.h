@@ -0,0 +1,56 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_PSD_MULTI_ENCODER_IMPL_H
+#define INCLUDED_NRSC5_PSD_MULTI_ENCODER_IMPL_H
+
+#include "psd_stream.h"
+#include <nrsc5/psd_multi_encoder.h>
+#include <atomic>
+#include <sstream>
+
+namespace gr {
+namespace nrsc5 {
+
+class psd_multi_encoder_impl : public psd_multi_encoder
+{
+private:
+    int num_progs;
+    int first_prog;
+    std::vector<psd_stream> streams;
+    int bytes_per_frame;
+    int bytes_allowed;
+    int lookahead_frames;
+    std::ostringstream meta_buffer;
+    uint64_t frames_clocked;
+    std::atomic<uint64_t> underrun_count;
+
+    void handle_clock(pmt::pmt_t msg);
+    void set_meta(const pmt::pmt_t& msg);
+    void dispatch_meta(const std::string& line);
+
+public:
+    psd_multi_encoder_impl(const int num_progs,
+                           const int first_prog,
+                           const std::vector<std::string> titles,
+                           const std::vector<std::string> artists,
+                           const int bytes_per_frame = 0,
+                           const bool preempt = false,
+                           const int lookahead_frames = 1);
+    ~psd_multi_encoder_impl();
+
+    // Where all the action really happens
+    int work(int noutput_items,
+             gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+    uint64_t underruns() const override;
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_PSD_MULTI_ENCODER_IMPL_H */
@@ -0,0 +1,258 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "psd_stream.h"
+#include "crc.h"
+#include "hdlc.h"
+#include <nrsc5/api.h>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+psd_stream::psd_stream(const int prog_num,
+                       const std::string& title,
+                       const std::string& artist,
+                       const bool preempt)
+{
+    this->prog_num = prog_num;
+    this->title = title;
+    this->artist = artist;
+    lot = -1;
+    seq_num = 0;
+    packet_off = 0;
+    packet_start = 0;
+    packet_end = 0;
+    template_valid = false;
+    this->preempt = preempt;
+    preempt_pending = false;
+    meta_pending = false;
+    meta_packet = false;
+    meta_end = 0;
+}
+
+/*
+ * Writes the next len bytes of the stream. The offset is the absolute position of
+ * out[0] in the output stream, which is used to track when metadata updates are sent.
+ */
+void psd_stream::produce(unsigned char* out, int len, uint64_t offset)
+{
+    // Abandon a stale packet, closing it early with a flag so that the receiver
+    // discards it, and start over with the new metadata.
+    if (preempt_pending && (len > 0)) {
+        if (packet_off != packet_end) {
+            bool started = (packet_off != packet_start);
+            next_packet();
+            if (started) {
+                packet[--packet_off] = 0x7e;
+            }
+        }
+        preempt_pending = false;
+    }
+
+    int off = 0;
+    while (off < len) {
+        if (packet_off == packet_end) {
+            next_packet();
+        }
+        int n = std::min(len - off, packet_end - packet_off);
+        memcpy(out + off, packet.data() + packet_off, n);
+        off += n;
+        packet_off += n;
+
+        if (meta_packet && (packet_off == packet_end)) {
+            meta_end = offset + off;
+            meta_packet = false;
+        }
+    }
+}
+
+/*
+ * Returns true (once) when the first complete packet carrying the most recent
+ * metadata update lies within the first bytes_sent bytes of the stream.
+ */
+bool psd_stream::meta_on_air(uint64_t bytes_sent, long& latency_ms)
+{
+    if (meta_pending && (meta_end > 0) && (bytes_sent >= meta_end)) {
+        latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - meta_time)
+                         .count();
+        meta_pending = false;
+        meta_end = 0;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Escapes the ID3 body of the packet into place once, leaving room in front of it for
+ * the header. Since the FCS is linear in the CRC register value entering the body,
+ * the body's contribution is also precomputed, so that each repeat only needs the
+ * CRC of its header.
+ */
+void psd_stream::build_template()
+{
+    std::string body = encode_id3() + "UF";
+    const unsigned char* body_bytes = (const unsigned char*)body.data();
+
+    packet.resize(PSD_HEAD_ROOM + 2 * body.size() + 5);
+    body_end =
+        PSD_HEAD_ROOM + hdlc_escape(body_bytes, body.size(), &packet[PSD_HEAD_ROOM]);
+
+    std::vector<unsigned char> zeros(body.size());
+    body_fcs = fcs16_update(0, body_bytes, body.size());
+    for (int k = 0; k < 16; k++) {
+        body_shift[k] = fcs16_update(1 << k, zeros.data(), zeros.size());
+    }
+    template_valid = true;
+}
+
+void psd_stream::next_packet()
+{
+    if (!template_valid) {
+        build_template();
+        meta_packet = meta_pending;
+    }
+
+    uint16_t port = PORT[prog_num];
+    uint16_t seq = seq_num++;
+    unsigned char header[PSD_HEADER_LEN] = { AAS_PACKET_FORMAT,
+                                             (unsigned char)(port & 0xff),
+                                             (unsigned char)(port >> 8),
+                                             (unsigned char)(seq & 0xff),
+                                             (unsigned char)(seq >> 8) };
+
+    uint16_t reg = fcs16_update(0xffff, header, sizeof(header));
+    uint16_t fcs = body_fcs;
+    for (int k = 0; k < 16; k++) {
+        if ((reg >> k) & 1) {
+            fcs ^= body_shift[k];
+        }
+    }
+    fcs ^= 0xffff;
+
+    unsigned char escaped_header[2 * PSD_HEADER_LEN];
+    int header_len = hdlc_escape(header, sizeof(header), escaped_header);
+    packet_off = PSD_HEAD_ROOM - header_len;
+    packet_start = packet_off;
+    memcpy(&packet[packet_off], escaped_header, header_len);
+
+    unsigned char fcs_bytes[2] = { (unsigned char)(fcs & 0xff),
+                                   (unsigned char)(fcs >> 8) };
+    packet_end = body_end + hdlc_escape(fcs_bytes, sizeof(fcs_bytes), &packet[body_end]);
+    packet[packet_end++] = 0x7e;
+}
+
+std::string psd_stream::encode_id3()
+{
+    std::stringstream out;
+
+    std::string payload = encode_text_frame("TIT2", title) +
+                          encode_text_frame("TPE1", artist) + encode_xhdr_frame();
+    int len = payload.length();
+
+    out << "ID3";
+    out << (char)3;
+    out << (char)0;
+    out << (char)0;
+    out << (char)((len >> 21) & 0x7f);
+    out << (char)((len >> 14) & 0x7f);
+    out << (char)((len >> 7) & 0x7f);
+    out << (char)(len & 0x7f);
+    out << payload;
+
+    return out.str();
+}
+
+std::string psd_stream::encode_text_frame(const std::string& id, const std::string& data)
+{
+    std::stringstream out;
+
+    int len = data.length() + 1;
+
+    out << id;
+    out << (char)((len >> 24) & 0xff);
+    out << (char)((len >> 16) & 0xff);
+    out << (char)((len >> 8) & 0xff);
+    out << (char)(len & 0xff);
+    out << (char)0;
+    out << (char)0;
+    out << (char)0;
+    out << data;
+
+    return out.str();
+}
+
+std::string psd_stream::encode_xhdr_frame()
+{
+    std::stringstream out;
+
+    int param = (lot >= 0) ? 0 : 1;
+    int extlen = (lot >= 0) ? 2 : 0;
+    int len = 6 + extlen;
+    uint32_t mime_int = static_cast<int>(mime_hash::PRIMARY_IMAGE);
+
+    out << "XHDR";
+    out << (char)((len >> 24) & 0xff);
+    out << (char)((len >> 16) & 0xff);
+    out << (char)((len >> 8) & 0xff);
+    out << (char)(len & 0xff);
+    out << (char)0;
+    out << (char)0;
+    out << (char)(mime_int & 0xff);
+    out << (char)((mime_int >> 8) & 0xff);
+    out << (char)((mime_int >> 16) & 0xff);
+    out << (char)((mime_int >> 24) & 0xff);
+    out << (char)param;
+    out << (char)extlen;
+
+    if (lot >= 0) {
+        out << (char)(lot & 0xff);
+        out << (char)((lot >> 8) & 0xff);
+    }
+
+    return out.str();
+}
+
+void psd_stream::meta_changed()
+{
+    template_valid = false;
+    if (preempt) {
+        preempt_pending = true;
+    }
+    if (!meta_pending) {
+        meta_time = std::chrono::steady_clock::now();
+        meta_pending = true;
+    }
+    meta_end = 0;
+}
+
+void psd_stream::set_meta(const std::string& line)
+{
+    if (line.rfind("title", 0) == 0) {
+        title = line.substr(5);
+        meta_changed();
+    } else if (line.rfind("artist", 0) == 0) {
+        artist = line.substr(6);
+        meta_changed();
+    } else if (line.rfind("lot", 0) == 0) {
+        try {
+            lot = std::stoi(line.substr(3));
+            meta_changed();
+        } catch (std::invalid_argument& err) {
+            // ignore
+        } catch (std::out_of_range& err) {
+            // ignore
+        }
+    }
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
@@ -0,0 +1,75 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_PSD_STREAM_H
+#define INCLUDED_NRSC5_PSD_STREAM_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+constexpr uint16_t PORT[] = { 0x5100, 0x5201, 0x5202, 0x5203,
+                              0x5204, 0x5205, 0x5206, 0x5207 };
+
+constexpr uint8_t AAS_PACKET_FORMAT = 0x21;
+constexpr int PSD_HEADER_LEN = 5;
+constexpr int PSD_HEAD_ROOM = 2 * PSD_HEADER_LEN + 1; // escaped header, abort flag
+
+/*
+ * Generates the HDLC-framed PSD packet stream for a single program, repeating the
+ * current metadata until it is changed by set_meta().
+ */
+class psd_stream
+{
+private:
+    int prog_num;
+    std::string title;
+    std::string artist;
+    int lot;
+    uint16_t seq_num;
+    std::vector<unsigned char> packet; // [head room][escaped body][escaped FCS, flag]
+    int packet_off;
+    int packet_start;
+    int packet_end;
+    int body_end;
+    bool template_valid;
+    uint16_t body_fcs;
+    uint16_t body_shift[16];
+
+    bool preempt;
+    bool preempt_pending;
+    bool meta_pending;
+    bool meta_packet;
+    std::chrono::steady_clock::time_point meta_time;
+    uint64_t meta_end;
+
+    void build_template();
+    void next_packet();
+    std::string encode_id3();
+    std::string encode_text_frame(const std::string& id, const std::string& data);
+    std::string encode_xhdr_frame();
+    void meta_changed();
+
+public:
+    psd_stream(const int prog_num,
+               const std::string& title,
+               const std::string& artist,
+               const bool preempt = false);
+
+    void set_meta(const std::string& line);
+    void produce(unsigned char* out, int len, uint64_t offset);
+    bool meta_on_air(uint64_t bytes_sent, long& latency_ms);
+};
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_PSD_STREAM_H */
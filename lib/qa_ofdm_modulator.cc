@@ -0,0 +1,146 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <nrsc5/core/l1_am_frame_encoder.h>
+#include <nrsc5/core/l1_fm_frame_encoder.h>
+#include <nrsc5/core/ofdm_modulator.h>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+/* One frame of random bits for each logical channel */
+struct random_frame {
+    std::vector<std::vector<unsigned char>> bits;
+    std::vector<const unsigned char*> inputs;
+
+    random_frame(const std::vector<l1_channel>& channels)
+    {
+        std::mt19937 rng(1);
+        bits.resize(channels.size());
+        for (size_t c = 0; c < channels.size(); c++) {
+            bits[c].resize(channels[c].bits * channels[c].pdus_per_frame);
+            for (unsigned char& bit : bits[c]) {
+                bit = rng() & 1;
+            }
+            inputs.push_back(bits[c].data());
+        }
+    }
+};
+
+/* Fixed-point output against the float output scaled to the same full scale */
+struct comparison {
+    double evm_db;
+    size_t clipped;
+};
+
+comparison compare(const std::vector<gr_complex>& expected,
+                   const std::vector<sc16_t>& actual,
+                   double full_scale)
+{
+    double error = 0, power = 0;
+    size_t clipped = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        std::complex<double> x(expected[i]);
+        x *= INT16_MAX / full_scale;
+        std::complex<double> y(actual[i].real(), actual[i].imag());
+        error += std::norm(y - x);
+        power += std::norm(x);
+        if (std::max(std::abs(x.real()), std::abs(x.imag())) > INT16_MAX) {
+            clipped++;
+        }
+    }
+    return { 10 * std::log10(error / power), clipped };
+}
+
+double rms(const std::vector<gr_complex>& samples)
+{
+    double power = 0;
+    for (const gr_complex& x : samples) {
+        power += std::norm(x);
+    }
+    return std::sqrt(power / samples.size());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_fm_sc16_evm)
+{
+    constexpr int symbols_per_frame = l1_fm_frame_encoder::SYMBOLS_PER_FRAME;
+    random_frame frame(l1_fm_frame_encoder::channels(1));
+
+    // each path starts from a fresh encoder, as the encoders keep state
+    std::vector<gr_complex> symbols(symbols_per_frame * fm_ofdm_modulator::FFT_SIZE);
+    std::vector<sc16_t> symbols_sc16(symbols.size());
+    std::unique_ptr<l1_fm_frame_encoder> encoder(new l1_fm_frame_encoder(1));
+    encoder->encode_frame(frame.inputs.data(), symbols.data());
+    encoder.reset(new l1_fm_frame_encoder(1));
+    encoder->encode_frame(frame.inputs.data(), symbols_sc16.data());
+
+    std::vector<gr_complex> expected(symbols_per_frame * fm_ofdm_modulator::SYMBOL_SIZE);
+    std::vector<sc16_t> actual(expected.size());
+    fm_ofdm_modulator(0, 0).modulate(symbols.data(), expected.data(), symbols_per_frame);
+
+    // MP1 is not clipped with full scale at five times the RMS amplitude
+    double full_scale = 5 * rms(expected);
+    fm_ofdm_modulator_sc16(0, 0, full_scale)
+        .modulate(symbols_sc16.data(), actual.data(), symbols_per_frame);
+
+    comparison result = compare(expected, actual, full_scale);
+    BOOST_CHECK_EQUAL(result.clipped, 0u);
+    BOOST_CHECK_LT(result.evm_db, -80);
+}
+
+BOOST_AUTO_TEST_CASE(test_am_sc16_evm)
+{
+    constexpr int symbols_per_frame = l1_am_frame_encoder::SYMBOLS_PER_FRAME;
+    random_frame frame(l1_am_frame_encoder::channels(1));
+
+    // each path starts from a fresh encoder, as the encoders keep state
+    std::vector<gr_complex> symbols(symbols_per_frame * am_ofdm_modulator::FFT_SIZE);
+    std::vector<sc16_t> symbols_sc16(symbols.size());
+    std::unique_ptr<l1_am_frame_encoder> encoder(new l1_am_frame_encoder(1));
+    encoder->encode_frame(frame.inputs.data(), symbols.data());
+    encoder.reset(new l1_am_frame_encoder(1));
+    encoder->encode_frame(frame.inputs.data(), symbols_sc16.data());
+
+    std::vector<gr_complex> expected(symbols_per_frame * am_ofdm_modulator::SYMBOL_SIZE);
+    std::vector<sc16_t> actual(expected.size());
+    am_ofdm_modulator().modulate(symbols.data(), expected.data(), symbols_per_frame);
+    for (gr_complex& sample : expected) {
+        sample += 1.0f;
+    }
+
+    // MA1 with the carrier at 1 fits within a full scale of 2
+    double full_scale = 2;
+    am_ofdm_modulator_sc16(full_scale, 1.0)
+        .modulate(symbols_sc16.data(), actual.data(), symbols_per_frame);
+
+    comparison result = compare(expected, actual, full_scale);
+    BOOST_CHECK_EQUAL(result.clipped, 0u);
+    BOOST_CHECK_LT(result.evm_db, -69);
+}
+
+BOOST_AUTO_TEST_CASE(test_sc16_full_scale_too_small)
+{
+    BOOST_CHECK_THROW(fm_ofdm_modulator_sc16(0, 0, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(fm_ofdm_modulator_sc16(0, 0, 1e-3), std::invalid_argument);
+    BOOST_CHECK_THROW(am_ofdm_modulator_sc16(0), std::invalid_argument);
+    BOOST_CHECK_THROW(am_ofdm_modulator_sc16(1e-4, 1.0), std::invalid_argument);
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
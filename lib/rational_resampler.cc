@@ -0,0 +1,273 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <nrsc5/core/rational_resampler.h>
+#include <cmath>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+/* Zeroth-order modified Bessel function of the first kind */
+double bessel_i0(double x)
+{
+    double sum = 1, term = 1;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-17) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/* Kaiser-windowed sinc with a cutoff of fw_t0 radians per sample and a DC gain of gain */
+std::vector<float> windowed_sinc(int ntaps, double gain, double fw_t0, double beta)
+{
+    int m = (ntaps - 1) / 2;
+    std::vector<double> taps(ntaps);
+    for (int n = -m; n <= m; n++) {
+        double r = (2.0 * (n + m)) / (ntaps - 1) - 1;
+        double window = bessel_i0(beta * std::sqrt(1 - r * r)) / bessel_i0(beta);
+        if (n == 0) {
+            taps[n + m] = fw_t0 / M_PI * window;
+        } else {
+            taps[n + m] = std::sin(n * fw_t0) / (n * M_PI) * window;
+        }
+    }
+
+    double dc = 0;
+    for (double tap : taps) {
+        dc += tap;
+    }
+
+    std::vector<float> result(ntaps);
+    for (int i = 0; i < ntaps; i++) {
+        result[i] = taps[i] * gain / dc;
+    }
+    return result;
+}
+
+/* Kaiser's window parameter for a given stopband attenuation in dB */
+double kaiser_beta(double attenuation)
+{
+    if (attenuation > 50) {
+        return 0.1102 * (attenuation - 8.7);
+    } else if (attenuation > 21) {
+        return 0.5842 * std::pow(attenuation - 21, 0.4) + 0.07886 * (attenuation - 21);
+    }
+    return 0;
+}
+
+int64_t gcd(int64_t a, int64_t b)
+{
+    while (b != 0) {
+        int64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Sample rates are exact multiples of 1/1024 Hz, such as 46511.71875 Hz */
+constexpr double RATE_UNIT = 1024;
+
+int64_t rate_units(double rate)
+{
+    double units = rate * RATE_UNIT;
+    if (!(units >= 1) || (units > 9007199254740992.0) || (units != std::floor(units))) {
+        throw std::invalid_argument(
+            "sample rates must be positive multiples of 1/1024 Hz");
+    }
+    return (int64_t)units;
+}
+
+/*
+ * Accumulates x[j] * h[j], for complex x and real taps h stored twice each, eight
+ * floats at a time so that the compiler can use SIMD instructions
+ */
+inline void dot_product(const float* x, const float* h, int nfloats, float* acc)
+{
+    for (int j = 0; j < nfloats; j += 8) {
+        for (int k = 0; k < 8; k++) {
+            acc[k] += x[j + k] * h[j + k];
+        }
+    }
+}
+
+inline gr_complex lane_sum(const float* acc)
+{
+    return gr_complex((acc[0] + acc[2]) + (acc[4] + acc[6]),
+                      (acc[1] + acc[3]) + (acc[5] + acc[7]));
+}
+
+} // namespace
+
+std::vector<float> design_low_pass(
+    double gain, double sample_rate, double cutoff, double transition, double beta)
+{
+    if ((cutoff <= 0) || (cutoff > sample_rate / 2) || (transition <= 0)) {
+        throw std::invalid_argument("invalid low-pass filter parameters");
+    }
+
+    double attenuation = beta / 0.1102 + 8.7;
+    int ntaps = (int)(attenuation * sample_rate / (22.0 * transition));
+    ntaps |= 1;
+    return windowed_sinc(ntaps, gain, 2 * M_PI * cutoff / sample_rate, beta);
+}
+
+std::vector<float>
+design_resampler_taps(int interpolation, int decimation, double fractional_bw)
+{
+    if ((fractional_bw <= 0) || (fractional_bw >= 0.5)) {
+        throw std::invalid_argument("fractional bandwidth must be between 0 and 0.5");
+    }
+
+    const double halfband = 0.5;
+    double rate = (double)interpolation / decimation;
+    double transition, mid_transition;
+    if (rate >= 1.0) {
+        transition = halfband - fractional_bw;
+        mid_transition = halfband - transition / 2;
+    } else {
+        transition = rate * (halfband - fractional_bw);
+        mid_transition = rate * halfband - transition / 2;
+    }
+    return design_low_pass(interpolation, interpolation, mid_transition, transition);
+}
+
+polyphase_resampler::polyphase_resampler(double input_rate,
+                                         double output_rate,
+                                         double passband,
+                                         double rejection_db)
+    : phase(0), fraction(0), skip(0)
+{
+    int64_t in_units = rate_units(input_rate);
+    int64_t out_units = rate_units(output_rate);
+    int64_t g = gcd(in_units, out_units);
+    interp = out_units / g;
+    decim = in_units / g;
+    if ((interp > INT32_MAX) || (decim > INT32_MAX)) {
+        throw std::invalid_argument("the ratio between the sample rates is too complex");
+    }
+
+    // images of the passband begin at the lower of the two sample rates
+    double stopband = std::min(input_rate, output_rate) - passband;
+    if ((passband <= 0) || (stopband <= passband)) {
+        throw std::invalid_argument(
+            "passband must be less than half of both sample rates");
+    }
+    if (rejection_db <= 0) {
+        throw std::invalid_argument("rejection must be positive");
+    }
+
+    // the prototype filter runs at nphases times the input rate, with Kaiser's
+    // estimate of the length needed for the rejection
+    nphases = (int)std::min<int64_t>(interp, MAX_PHASES);
+    double rate = input_rate * nphases;
+    double transition = (stopband - passband) / rate;
+    double length = (rejection_db - 7.95) / (14.36 * transition) + 1;
+    branch_len = (int)std::ceil((length + 1) / nphases);
+    branch_len = (branch_len + 3) / 4 * 4;
+
+    // taps 0 and nphases * branch_len are zero, so that phase nphases is phase 0
+    // one sample later, and phases can be interpolated across the boundary
+    int ntaps = nphases * branch_len - 1;
+    std::vector<float> taps = windowed_sinc(ntaps,
+                                            nphases,
+                                            M_PI * (passband + stopband) / rate,
+                                            kaiser_beta(rejection_db));
+    taps.insert(taps.begin(), 0);
+    taps.push_back(0);
+
+    // phase k holds taps k, k + nphases, ... in reverse, each once for I and once
+    // for Q, so that it can be applied to the oldest sample first
+    bank.assign((size_t)(nphases + 1) * 2 * branch_len, 0);
+    for (int k = 0; k <= nphases; k++) {
+        float* h = &bank[(size_t)k * 2 * branch_len];
+        for (int m = 0; m < branch_len; m++) {
+            h[2 * (branch_len - 1 - m)] = h[2 * (branch_len - 1 - m) + 1] =
+                taps[k + (size_t)nphases * m];
+        }
+    }
+
+    // each output moves decim / interp input samples on, which is a whole number
+    // of phases plus a fraction (in units of 1 / interp) that is carried over
+    step = decim * nphases / interp;
+    fraction_step = decim * nphases % interp;
+
+    if (nphases < interp) {
+        slope.resize((size_t)nphases * 2 * branch_len);
+        for (size_t i = 0; i < slope.size(); i++) {
+            slope[i] = bank[i + 2 * branch_len] - bank[i];
+        }
+    }
+    history.assign(branch_len - 1, gr_complex(0));
+}
+
+void polyphase_resampler::advance(double input_samples)
+{
+    if (input_samples < 0) {
+        throw std::invalid_argument("cannot advance by a negative number of samples");
+    }
+    int64_t units = std::llround(input_samples * interp);
+    skip += units / interp;
+    int64_t scaled = units % interp * nphases;
+    phase = scaled / interp;
+    fraction = scaled % interp;
+}
+
+void polyphase_resampler::process(const gr_complex* in,
+                                  size_t nitems,
+                                  std::vector<gr_complex>& out)
+{
+    history.insert(history.end(), in, in + nitems);
+
+    int nfloats = 2 * branch_len;
+    float fraction_scale = 1.0f / interp;
+    size_t pos = skip;
+    size_t n = out.size();
+    if (pos + branch_len <= history.size()) {
+        out.resize(n + (history.size() - branch_len - pos + 1) * interp / decim + 2);
+    }
+    while (pos + branch_len <= history.size()) {
+        const float* x = reinterpret_cast<const float*>(history.data() + pos);
+        size_t offset = (size_t)phase * nfloats;
+
+        float acc[8] = { 0 };
+        dot_product(x, &bank[offset], nfloats, acc);
+        if (slope.empty()) {
+            out[n++] = lane_sum(acc);
+        } else {
+            float delta[8] = { 0 };
+            dot_product(x, &slope[offset], nfloats, delta);
+            out[n++] = lane_sum(acc) + (fraction * fraction_scale) * lane_sum(delta);
+        }
+
+        phase += step;
+        fraction += fraction_step;
+        if (fraction >= interp) {
+            fraction -= interp;
+            phase++;
+        }
+        while (phase >= nphases) {
+            phase -= nphases;
+            pos++;
+        }
+    }
+    out.resize(n);
+
+    // when decimating, the next output may start beyond the samples we have
+    size_t consumed = std::min(pos, history.size());
+    skip = pos - consumed;
+    history.erase(history.begin(), history.begin() + consumed);
+}
+
+} // namespace nrsc5
+} // namespace gr
@@ -0,0 +1,81 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "reed_solomon.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/* Log of zero, in index form */
+static constexpr int A0 = rs_encoder::NN;
+
+static inline int modnn(int x)
+{
+    while (x >= rs_encoder::NN) {
+        x -= rs_encoder::NN;
+        x = (x >> 8) + (x & rs_encoder::NN);
+    }
+    return x;
+}
+
+rs_encoder::rs_encoder(int gfpoly, int fcr, int prim, int nroots) : nroots(nroots)
+{
+    if ((nroots < 1) || (nroots > MAX_ROOTS) || (prim < 1) || (prim >= NN)) {
+        throw std::invalid_argument("invalid Reed-Solomon code parameters");
+    }
+
+    // log and antilog tables
+    index_of[0] = A0;
+    alpha_to[A0] = 0;
+    int sr = 1;
+    for (int i = 0; i < NN; i++) {
+        index_of[sr] = i;
+        alpha_to[i] = sr;
+        sr <<= 1;
+        if (sr & 0x100) {
+            sr ^= gfpoly;
+        }
+        sr &= NN;
+    }
+    if (sr != 1) {
+        throw std::invalid_argument("Reed-Solomon field polynomial is not primitive");
+    }
+
+    // generator polynomial, with roots at consecutive powers of alpha^prim
+    genpoly[0] = 1;
+    for (int i = 0, root = fcr * prim; i < nroots; i++, root += prim) {
+        genpoly[i + 1] = 1;
+        for (int j = i; j > 0; j--) {
+            if (genpoly[j] != 0) {
+                genpoly[j] =
+                    genpoly[j - 1] ^ alpha_to[modnn(index_of[genpoly[j]] + root)];
+            } else {
+                genpoly[j] = genpoly[j - 1];
+            }
+        }
+        genpoly[0] = alpha_to[modnn(index_of[genpoly[0]] + root)];
+    }
+    for (int i = 0; i <= nroots; i++) {
+        genpoly[i] = index_of[genpoly[i]];
+    }
+}
+
+void rs_encoder::encode(const uint8_t* data, uint8_t* parity) const
+{
+    memset(parity, 0, nroots);
+    for (int i = 0; i < NN - nroots; i++) {
+        int feedback = index_of[data[i] ^ parity[0]];
+        if (feedback != A0) {
+            for (int j = 1; j < nroots; j++) {
+                parity[j] ^= alpha_to[modnn(feedback + genpoly[nroots - j])];
+            }
+        }
+        std::copy(parity + 1, parity + nroots, parity);
+        parity[nroots - 1] =
+            (feedback != A0) ? alpha_to[modnn(feedback + genpoly[0])] : 0;
+    }
+}
@@ -0,0 +1,36 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_REED_SOLOMON_H
+#define INCLUDED_NRSC5_REED_SOLOMON_H
+
+#include <cstdint>
+
+/*
+ * Systematic Reed-Solomon encoder over GF(256) for full-length (255 byte) codewords.
+ * Produces the same parity as Phil Karn's encode_rs_char from gr-fec, which the
+ * Layer 2 encoder used before the core library was split out.
+ */
+class rs_encoder
+{
+public:
+    static constexpr int NN = 255;
+    static constexpr int MAX_ROOTS = 32;
+
+    rs_encoder(int gfpoly, int fcr, int prim, int nroots);
+
+    /* Computes nroots parity bytes for NN - nroots data bytes */
+    void encode(const uint8_t* data, uint8_t* parity) const;
+
+private:
+    int nroots;
+    uint8_t alpha_to[NN + 1];
+    uint8_t index_of[NN + 1];
+    uint8_t genpoly[MAX_ROOTS + 1];
+};
+
+#endif /* INCLUDED_NRSC5_REED_SOLOMON_H */
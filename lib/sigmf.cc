@@ -0,0 +1,206 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "sigmf.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+const char* const CI16 = "ci16_be";
+#else
+const char* const CI16 = "ci16_le";
+#endif
+
+bool has_suffix(const std::string& name, const std::string& suffix)
+{
+    return (name.length() >= suffix.length()) &&
+           (name.compare(name.length() - suffix.length(), suffix.length(), suffix) == 0);
+}
+
+std::string quote(const std::string& value)
+{
+    std::string out = "\"";
+    for (char c : value) {
+        if ((c == '"') || (c == '\\')) {
+            out += '\\';
+        }
+        if ((unsigned char)c >= 0x20) {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+/* Position of the value for the given key, or npos if it is absent */
+size_t find_value(const std::string& json, const std::string& key)
+{
+    size_t pos = json.find(quote(key));
+    if (pos == std::string::npos) {
+        return pos;
+    }
+    pos = json.find(':', pos + key.length() + 2);
+    if (pos == std::string::npos) {
+        return pos;
+    }
+    return json.find_first_not_of(" \t\r\n", pos + 1);
+}
+
+bool get_number(const std::string& json, const std::string& key, double& value)
+{
+    size_t pos = find_value(json, key);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    char* end;
+    value = strtod(json.c_str() + pos, &end);
+    return end != json.c_str() + pos;
+}
+
+bool get_uint64(const std::string& json, const std::string& key, uint64_t& value)
+{
+    size_t pos = find_value(json, key);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    char* end;
+    value = strtoull(json.c_str() + pos, &end, 10);
+    return end != json.c_str() + pos;
+}
+
+bool get_string(const std::string& json, const std::string& key, std::string& value)
+{
+    size_t pos = find_value(json, key);
+    if ((pos == std::string::npos) || (json[pos] != '"')) {
+        return false;
+    }
+    value.clear();
+    for (pos++; (pos < json.length()) && (json[pos] != '"'); pos++) {
+        if ((json[pos] == '\\') && (pos + 1 < json.length())) {
+            pos++;
+        }
+        value += json[pos];
+    }
+    return true;
+}
+
+} // namespace
+
+std::string sigmf_base(const std::string& filename)
+{
+    for (const char* ext : { ".sigmf-data", ".sigmf-meta", ".sigmf" }) {
+        if (has_suffix(filename, ext)) {
+            return filename.substr(0, filename.length() - std::string(ext).length());
+        }
+    }
+    return filename;
+}
+
+std::string sigmf_datatype(int bits) { return (bits == 8) ? "ci8" : CI16; }
+
+void write_sigmf_meta(const std::string& path, const sigmf_meta& meta)
+{
+    std::ostringstream json;
+    json << std::setprecision(17);
+    json << "{\n"
+         << "    \"global\": {\n"
+         << "        \"core:datatype\": " << quote(sigmf_datatype(meta.bits)) << ",\n"
+         << "        \"core:sample_rate\": " << meta.sample_rate << ",\n"
+         << "        \"core:version\": \"1.0.0\",\n"
+         << "        \"core:recorder\": \"gr-nrsc5 iq_file_sink\",\n"
+         << "        \"core:extensions\": [\n"
+         << "            { \"name\": \"nrsc5\", \"version\": \"1.0.0\", "
+         << "\"optional\": true }\n"
+         << "        ],\n"
+         << "        \"nrsc5:mode\": " << quote(meta.mode) << ",\n"
+         << "        \"nrsc5:full_scale\": " << meta.full_scale << ",\n"
+         << "        \"nrsc5:vlen\": " << meta.vlen << ",\n"
+         << "        \"nrsc5:lsb_power_db\": " << meta.lsb_power_db << ",\n"
+         << "        \"nrsc5:usb_power_db\": " << meta.usb_power_db << "\n"
+         << "    },\n"
+         << "    \"captures\": [\n"
+         << "        {\n"
+         << "            \"core:sample_start\": 0";
+    if (meta.has_alfn) {
+        json << ",\n"
+             << "            \"nrsc5:alfn\": " << meta.alfn << ",\n"
+             << "            \"nrsc5:alfn_sample\": " << meta.alfn_sample;
+    }
+    json << "\n"
+         << "        }\n"
+         << "    ],\n"
+         << "    \"annotations\": []\n"
+         << "}\n";
+
+    // Readers never see a half-written file, even if the recording is still going
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << json.str();
+        if (!out) {
+            throw std::runtime_error("sigmf: Unable to write " + tmp);
+        }
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) {
+        remove(tmp.c_str());
+        throw std::runtime_error("sigmf: Unable to write " + path);
+    }
+}
+
+sigmf_meta read_sigmf_meta(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("sigmf: Unable to open " + path);
+    }
+    std::stringstream buf;
+    buf << in.rdbuf();
+    std::string json = buf.str();
+
+    sigmf_meta meta;
+    std::string datatype;
+    if (!get_string(json, "core:datatype", datatype)) {
+        throw std::runtime_error("sigmf: No datatype in " + path);
+    }
+    if (datatype == "ci8") {
+        meta.bits = 8;
+    } else if (datatype == CI16) {
+        meta.bits = 16;
+    } else {
+        throw std::runtime_error("sigmf: Unsupported datatype " + datatype + " in " +
+                                 path);
+    }
+
+    get_number(json, "core:sample_rate", meta.sample_rate);
+    get_number(json, "nrsc5:full_scale", meta.full_scale);
+    get_number(json, "nrsc5:lsb_power_db", meta.lsb_power_db);
+    get_number(json, "nrsc5:usb_power_db", meta.usb_power_db);
+    get_string(json, "nrsc5:mode", meta.mode);
+
+    double vlen;
+    if (get_number(json, "nrsc5:vlen", vlen)) {
+        meta.vlen = (int)vlen;
+    }
+    if ((meta.vlen < 1) || !(meta.full_scale > 0)) {
+        throw std::runtime_error("sigmf: Invalid vlen or full_scale in " + path);
+    }
+
+    meta.has_alfn = get_uint64(json, "nrsc5:alfn", meta.alfn) &&
+                    get_uint64(json, "nrsc5:alfn_sample", meta.alfn_sample);
+    return meta;
+}
+
+} // namespace nrsc5
+} // namespace gr
@@ -0,0 +1,55 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_SIGMF_H
+#define INCLUDED_NRSC5_SIGMF_H
+
+#include <cstdint>
+#include <string>
+
+namespace gr {
+namespace nrsc5 {
+
+/*
+ * The parts of a SigMF recording (https://sigmf.org) that iq_file_sink writes and
+ * iq_file_source reads back. Samples are interleaved I/Q integers in host byte order,
+ * where full_scale maps to the largest integer value.
+ */
+struct sigmf_meta {
+    int bits = 16;
+    double sample_rate = 0;
+    double full_scale = 1;
+    int vlen = 1;
+    std::string mode;
+    double lsb_power_db = 0;
+    double usb_power_db = 0;
+
+    // ALFN of the first frame in the recording, and the sample it starts on
+    bool has_alfn = false;
+    uint64_t alfn = 0;
+    uint64_t alfn_sample = 0;
+};
+
+/* Strips a .sigmf-data, .sigmf-meta or .sigmf extension, giving the recording's name */
+std::string sigmf_base(const std::string& filename);
+
+/* SigMF datatype ("ci8" or "ci16_le") for the given sample size */
+std::string sigmf_datatype(int bits);
+
+/* Writes the metadata file, replacing any previous version atomically */
+void write_sigmf_meta(const std::string& path, const sigmf_meta& meta);
+
+/*
+ * Reads a metadata file written by write_sigmf_meta. This is not a general JSON
+ * parser: it looks up the keys above and ignores everything else.
+ */
+sigmf_meta read_sigmf_meta(const std::string& path);
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_SIGMF_H */
@@ -0,0 +1,1303 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2017, 2023, 2026 Clayton Smith.
+ * Copyright 2023 Vladislav Fomitchev.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "crc.h"
+#include <nrsc5/core/sis_frame_encoder.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace gr {
+namespace nrsc5 {
+
+namespace {
+
+enum class pdu_type { PIDS_FORMATTED, LOW_LATENCY_DATA_SERVICE };
+
+enum class extension { NO_EXTENSION, EXTENDED_FORMAT };
+
+enum class msg_id {
+    STATION_ID_NUMBER,
+    STATION_NAME_SHORT,
+    STATION_NAME_LONG,
+    ALFN,
+    STATION_LOCATION,
+    STATION_MESSAGE,
+    SERVICE_INFORMATION_MESSAGE,
+    SIS_PARAMETER_MESSAGE,
+    UNIVERSAL_SHORT_STATION_NAME,
+    EMERGENCY_ALERTS_MESSAGE,
+    ADVANCED_SERVICE_INFORMATION_MESSAGE
+};
+
+enum class name_type { UNIVERSAL_SHORT_STATION_NAME, SLOGAN };
+
+enum class time_status { NOT_LOCKED, LOCKED };
+
+enum class name_extension { NONE, FM };
+
+enum class parameter_type {
+    LEAP_SECOND_OFFSET,
+    LEAP_SECOND_ALFN_LSB,
+    LEAP_SECOND_ALFN_MSB,
+    LOCAL_TIME_DATA,
+    EXCITER_MANUFACTURER_ID,
+    EXCITER_CORE_VERSION_NUMBER_1_2_3,
+    EXCITER_MANUFACTURER_VERSION_NUMBER_1_2_3,
+    EXCITER_VERSION_NUMBER_4_AND_STATUS,
+    IMPORTER_MANUFACTURER_ID,
+    IMPORTER_CORE_VERSION_NUMBER_1_2_3,
+    IMPORTER_MANUFACTURER_VERSION_NUMBER_1_2_3,
+    IMPORTER_VERSION_NUMBER_4_AND_STATUS,
+    IMPORTER_CONFIGURATION_NUMBER
+};
+
+constexpr int NUM_PARAMETERS = 13;
+
+enum class icb { IMPORTER_NOT_CONNECTED, IMPORTER_CONNECTED };
+
+enum class priority { NORMAL, HIGH };
+
+enum class encoding { ISO_8859_1 = 0, UCS_2 = 4 };
+
+enum class service_category { AUDIO, DATA };
+
+enum class access { PUBLIC, RESTRICTED };
+
+enum class sound_experience {
+    NONE = 0,
+    DOLBY_PRO_LOGIC_II_SURROUND = 2,
+    DTS_NEURAL_SURROUND = 3,
+    FHG_MP3_SURROUND = 4,
+    DTS_NEO_6_SURROUND = 5,
+    DTS_NEURAL_X_SURROUND = 7,
+    DOLBY_PRO_LOGIC_IIX_SURROUND = 8,
+    DOLBY_PRO_LOGIC_IIZ_SURROUND = 9
+};
+
+enum class sig_service_type { AUDIO = 0x40, DATA = 0x41 };
+
+enum class sig_tag {
+    DATA_INFO = 0x60,
+    AUDIO_COMPONENT = 0x66,
+    DATA_COMPONENT = 0x67,
+    SERVICE_NAME = 0x69
+};
+
+enum class data_type { STREAM = 0, PACKET = 1, LOT = 3 };
+
+constexpr uint8_t AAS_PACKET_FORMAT = 0x21;
+
+/*
+ * Spreads bits into one byte per bit, most significant bit first, eight at a time.
+ */
+void unpack_bits(uint64_t value, int len, unsigned char* out)
+{
+    static const auto table = [] {
+        std::vector<std::array<unsigned char, 8>> t(256);
+        for (int v = 0; v < 256; v++) {
+            for (int j = 0; j < 8; j++) {
+                t[v][j] = (v >> (7 - j)) & 1;
+            }
+        }
+        return t;
+    }();
+
+    for (int shift = len - 8; shift >= 0; shift -= 8) {
+        memcpy(out, table[(value >> shift) & 0xff].data(), 8);
+        out += 8;
+    }
+}
+
+std::string generate_sig_service(sig_service_type type,
+                                 unsigned int number,
+                                 const std::string name)
+{
+    std::stringstream out;
+
+    out << (char)type;
+    out << (char)number;
+    out << (char)0; // unknown
+    out << (char)2; // unknown
+
+    out << (char)sig_tag::SERVICE_NAME;
+    out << (char)(name.length() + 2);
+    out << (char)0; // encoding?
+    out << name;
+
+    return out.str();
+}
+
+std::string generate_sig_audio_component(unsigned int component_id,
+                                         unsigned int program_id,
+                                         program_type type,
+                                         mime_hash mime)
+{
+    std::stringstream out;
+    uint32_t mime_int = static_cast<uint32_t>(mime);
+
+    out << (char)sig_tag::AUDIO_COMPONENT;
+    out << (char)12; // length
+    out << (char)component_id;
+    out << (char)program_id;
+    out << (char)type;
+    out << (char)0; // unknown
+    out << (char)0; // unknown
+    out << (char)0; // unknown
+    out << (char)0; // unknown
+    out << (char)(mime_int & 0xff);
+    out << (char)((mime_int >> 8) & 0xff);
+    out << (char)((mime_int >> 16) & 0xff);
+    out << (char)((mime_int >> 24) & 0xff);
+
+    return out.str();
+}
+
+std::string generate_sig_data_component(unsigned int component_id,
+                                        uint16_t port,
+                                        service_data_type sdt,
+                                        data_type type,
+                                        mime_hash mime,
+                                        unsigned int vendor_id)
+{
+    std::stringstream out;
+    uint32_t mime_int = static_cast<uint32_t>(mime);
+    uint16_t sdt_int = static_cast<uint16_t>(sdt);
+
+    out << (char)sig_tag::DATA_COMPONENT;
+    out << (char)13; // length
+    out << (char)component_id;
+    out << (char)(port & 0xff);
+    out << (char)((port >> 8) & 0xff);
+    out << (char)(sdt_int & 0xff);
+    out << (char)((sdt_int >> 8) & 0xff);
+    out << (char)type;
+    out << (char)0; // unknown
+    out << (char)0; // unknown
+    out << (char)(mime_int & 0xff);
+    out << (char)((mime_int >> 8) & 0xff);
+    out << (char)((mime_int >> 16) & 0xff);
+    out << (char)((mime_int >> 24) & 0xff);
+
+    out << (char)sig_tag::DATA_INFO;
+    out << (char)9; // length
+    out << "SELF";  // vendor?
+    out << (char)vendor_id;
+    out << (char)0; // unknown
+    out << (char)0; // unknown
+    out << (char)0; // unknown
+
+    return out.str();
+}
+
+std::string generate_aas_header(uint16_t port, uint16_t seq)
+{
+    std::stringstream out;
+
+    out << (char)AAS_PACKET_FORMAT;
+    out << (char)(port & 0xff);
+    out << (char)((port >> 8) & 0xff);
+    out << (char)(seq & 0xff);
+    out << (char)((seq >> 8) & 0xff);
+
+    return out.str();
+}
+
+} // namespace
+
+const sis_frame_encoder::schedule_t sis_frame_encoder::schedule_fm_short_no_ea = {
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::STATION_SLOGAN },
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::STATION_LOCATION, sched_item::STATION_LOCATION },
+    { sched_item::STATION_MESSAGE },
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::LONG_STATION_NAME },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::STATION_MESSAGE },
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE }
+};
+
+const sis_frame_encoder::schedule_t sis_frame_encoder::schedule_fm_short_ea = {
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::STATION_LOCATION, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SHORT_STATION_NAME, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::EA_MESSAGE }
+};
+
+const sis_frame_encoder::schedule_t sis_frame_encoder::schedule_fm_long_no_ea = {
+    { sched_item::UNIVERSAL_SHORT_STATION_NAME },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::STATION_SLOGAN },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::UNIVERSAL_SHORT_STATION_NAME },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::STATION_LOCATION, sched_item::STATION_LOCATION },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::STATION_MESSAGE },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::UNIVERSAL_SHORT_STATION_NAME },
+    { sched_item::STATION_SLOGAN },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::STATION_MESSAGE },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID }
+};
+
+const sis_frame_encoder::schedule_t sis_frame_encoder::schedule_fm_long_ea = {
+    { sched_item::UNIVERSAL_SHORT_STATION_NAME },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::STATION_LOCATION, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::EA_MESSAGE }
+};
+
+const sis_frame_encoder::schedule_t sis_frame_encoder::schedule_am_short_no_ea = {
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::STATION_MESSAGE },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SHORT_STATION_NAME },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_LOCATION },
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::STATION_SLOGAN },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SHORT_STATION_NAME },
+    { sched_item::LONG_STATION_NAME }
+};
+
+const sis_frame_encoder::schedule_t sis_frame_encoder::schedule_am_short_ea = {
+    { sched_item::SHORT_STATION_NAME, sched_item::STATION_ID },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::STATION_LOCATION, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::EA_MESSAGE }
+};
+
+const sis_frame_encoder::schedule_t sis_frame_encoder::schedule_am_long_no_ea = {
+    { sched_item::UNIVERSAL_SHORT_STATION_NAME },
+    { sched_item::STATION_MESSAGE },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::STATION_LOCATION },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::STATION_SLOGAN },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::SERVICE_INFO_MESSAGE, sched_item::SERVICE_INFO_MESSAGE }
+};
+
+const sis_frame_encoder::schedule_t sis_frame_encoder::schedule_am_long_ea = {
+    { sched_item::UNIVERSAL_SHORT_STATION_NAME },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::STATION_LOCATION, sched_item::SERVICE_INFO_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::EA_MESSAGE },
+    { sched_item::SIS_PARAMETER_MESSAGE, sched_item::STATION_ID },
+    { sched_item::EA_MESSAGE }
+};
+
+sis_frame_encoder::sis_frame_encoder(pids_mode mode,
+                                     const std::string& short_name,
+                                     const std::string& slogan,
+                                     const std::string& message,
+                                     const std::vector<std::string>& program_names,
+                                     const std::vector<program_type>& program_types,
+                                     const std::vector<service_data_type>& data_types,
+                                     const std::vector<unsigned int>& data_mime_types,
+                                     float latitude,
+                                     float longitude,
+                                     float altitude,
+                                     const std::string& country_code,
+                                     unsigned int fcc_facility_id,
+                                     bool time_locked)
+{
+    if (country_code.length() != 2) {
+        throw std::invalid_argument("country code must be two characters");
+    }
+    if (program_names.size() != program_types.size()) {
+        throw std::invalid_argument("each program needs a name and a type");
+    }
+    if (program_names.size() > MAX_AUDIO_PROGRAMS) {
+        throw std::invalid_argument("too many programs");
+    }
+
+    alfn = 800000000;
+    this->time_locked = time_locked;
+    this->country_code = country_code;
+    this->fcc_facility_id = fcc_facility_id;
+
+    if ((short_name.length() >= 3) &&
+        (short_name.compare(short_name.length() - 3, 3, "-FM") == 0)) {
+        this->short_name = short_name.substr(0, short_name.length() - 3);
+        fm_suffix = true;
+    } else {
+        this->short_name = short_name;
+        fm_suffix = false;
+    }
+
+    this->use_standard_short_station_name = can_use_standard_short_station_name();
+
+    this->mode = mode;
+    if (this->mode == pids_mode::FM) {
+        blocks = BLOCKS_PER_FRAME_FM;
+    } else {
+        blocks = BLOCKS_PER_FRAME_AM;
+    }
+
+    this->program_names = program_names;
+    this->program_types = program_types;
+    this->data_types = data_types;
+    this->data_mime_types = data_mime_types;
+    this->slogan = slogan;
+    this->message = message;
+    this->emergency_alert = "";
+    this->emergency_alert_cnt_len = 0;
+    this->latitude = latitude;
+    this->longitude = longitude;
+    this->altitude = altitude;
+    pending_leap_second_offset = 18;
+    current_leap_second_offset = 18;
+    leap_second_alfn = 0;
+    utc_offset = -360;
+    dst_sched = dst_schedule::US_CANADA;
+    dst_local = true;
+    dst_regional = true;
+    exciter_manufacturer_id = "CS";
+    exciter_core_version = { 1, 0, 0, 0 };
+    exciter_core_status = 0;
+    exciter_manufacturer_version = { 1, 0, 0, 0 };
+    exciter_manufacturer_status = 0;
+    importer_manufacturer_id = "CS";
+    importer_core_version = { 1, 0, 0, 0 };
+    importer_core_status = 0;
+    importer_manufacturer_version = { 1, 0, 0, 0 };
+    importer_manufacturer_status = 0;
+    importer_configuration_number = 0;
+
+    long_name_current_frame = 0;
+    long_name_seq = 0;
+
+    ussn_current_frame = 0;
+    slogan_current_frame = 0;
+
+    message_current_frame = 0;
+    message_seq = 0;
+
+    emergency_alert_current_frame = 0;
+    emergency_alert_seq = 0;
+
+    current_service = 0;
+
+    current_parameter = 0;
+
+    location_high = true;
+
+    d_seq = 0;
+    sig_valid = false;
+    for (unsigned int program_id = 0; program_id < this->program_names.size();
+         program_id++) {
+        update_sig_program(program_id);
+    }
+
+    for (int i = 0; i < NUM_SCHED_ITEMS; i++) {
+        fresh_segments[i] = 0;
+    }
+    schedule_dirty = true;
+
+    // Contribution of the reserved, time status and ALFN bits to the PDU CRC
+    for (int t = 0; t < 16; t++) {
+        unsigned char bytes[9] = { (unsigned char)(t << 4) };
+        tail_crc[t] = sis_crc16_update(0x0000, bytes, sizeof(bytes));
+    }
+}
+
+void sis_frame_encoder::encode_frame(unsigned char* out)
+{
+    if (schedule_dirty) {
+        compile_schedule();
+    }
+
+    for (int block = 0; block < blocks; block++) {
+        write_pdu(out, schedule[block], block);
+        out += PDU_BITS;
+    }
+    alfn++;
+}
+
+/*
+ * Changes an audio program, or adds one if the number is one past the last program.
+ */
+void sis_frame_encoder::set_program(unsigned int program_id,
+                                    program_type type,
+                                    const std::string& name)
+{
+    if ((program_id > program_names.size()) || (program_id >= MAX_AUDIO_PROGRAMS)) {
+        throw std::invalid_argument("programs must be numbered consecutively");
+    }
+    if ((static_cast<int>(type) < 0) || (static_cast<int>(type) > 255)) {
+        throw std::invalid_argument("invalid program type");
+    }
+
+    if (program_id == program_names.size()) {
+        program_names.push_back(name);
+        program_types.push_back(type);
+    } else {
+        program_names[program_id] = name;
+        program_types[program_id] = type;
+    }
+
+    update_sig_program(program_id);
+    services_changed();
+}
+
+/* Removes the last audio program */
+void sis_frame_encoder::remove_program(unsigned int program_id)
+{
+    if ((program_id + 1 != program_names.size()) || (program_id == 0)) {
+        throw std::invalid_argument(
+            "only the last program can be removed, and HD1 must remain");
+    }
+
+    program_names.pop_back();
+    program_types.pop_back();
+    sig_programs.pop_back();
+    sig_valid = false;
+    services_changed();
+}
+
+void sis_frame_encoder::set_message(const std::string& message)
+{
+    this->message = message;
+    message_current_frame = 0;
+    message_seq = (message_seq + 1) % 4;
+    mark_fresh(sched_item::STATION_MESSAGE);
+}
+
+void sis_frame_encoder::set_slogan(const std::string& slogan)
+{
+    this->slogan = slogan;
+    slogan_current_frame = 0;
+    long_name_current_frame = 0;
+    long_name_seq = (long_name_seq + 1) % 8;
+    mark_fresh(sched_item::STATION_SLOGAN);
+    mark_fresh(sched_item::LONG_STATION_NAME);
+}
+
+/*
+ * Starts sending an emergency alert. control_data holds the raw control bytes, whose
+ * CRC is filled in here.
+ */
+void sis_frame_encoder::set_alert(const std::string& control_data,
+                                  const std::string& message)
+{
+    if ((control_data.length() < 7) || (control_data.length() > 63)) {
+        throw std::invalid_argument("emergency alert control data must be 7-63 bytes");
+    }
+    if (control_data.length() % 2 != 1) {
+        throw std::invalid_argument(
+            "number of emergency alert control bytes must be odd");
+    }
+    if (control_data.length() + message.length() > 381) {
+        throw std::invalid_argument("emergency alert payload cannot exceed 381 bytes");
+    }
+
+    std::string cnt_str = control_data;
+    update_control_data_crc(cnt_str);
+
+    emergency_alert = cnt_str + message;
+    emergency_alert_cnt_len = (cnt_str.length() - 1) / 2;
+    emergency_alert_current_frame = 0;
+    emergency_alert_seq = (emergency_alert_seq + 1) % 4;
+    invalidate_item(sched_item::EA_MESSAGE);
+
+    schedule_dirty = true;
+}
+
+void sis_frame_encoder::clear_alert()
+{
+    emergency_alert = "";
+    emergency_alert_cnt_len = 0;
+    schedule_dirty = true;
+}
+
+const std::vector<uint8_t>& sis_frame_encoder::next_sig_pdu()
+{
+    if (!sig_valid) {
+        encode_sig();
+    }
+
+    sig_packet[3] = d_seq & 0xff;
+    sig_packet[4] = (d_seq >> 8) & 0xff;
+    d_seq++;
+
+    return sig_packet;
+}
+
+const sis_frame_encoder::schedule_t& sis_frame_encoder::current_schedule()
+{
+    bool ea = (emergency_alert.length() > 0);
+    if (mode == pids_mode::FM) {
+        if (use_standard_short_station_name) {
+            return ea ? schedule_fm_short_ea : schedule_fm_short_no_ea;
+        } else {
+            return ea ? schedule_fm_long_ea : schedule_fm_long_no_ea;
+        }
+    } else {
+        if (use_standard_short_station_name) {
+            return ea ? schedule_am_short_ea : schedule_am_short_no_ea;
+        } else {
+            return ea ? schedule_am_long_ea : schedule_am_long_no_ea;
+        }
+    }
+}
+
+/*
+ * Assembles one PIDS PDU from the cached payload bits of its schedule items. Only the
+ * ALFN bits and the CRC vary from frame to frame for most slots.
+ */
+void sis_frame_encoder::write_pdu(unsigned char* out,
+                                 const std::vector<sched_item>& payloads,
+                                 int block)
+{
+    extension ext = (payloads.size() == 1) ? extension::NO_EXTENSION
+                                           : extension::EXTENDED_FORMAT;
+    uint64_t payload = (static_cast<int>(pdu_type::PIDS_FORMATTED) << 1) |
+                       static_cast<int>(ext);
+    int len = 2;
+
+    for (sched_item item : payloads) {
+        packed_bits bits = item_bits(item);
+        payload = (payload << bits.len) | bits.bits;
+        len += bits.len;
+        advance_item(item);
+    }
+    payload <<= (64 - len);
+
+    int alfn_bits;
+    if (mode == pids_mode::FM) {
+        alfn_bits = (alfn >> (block * 2)) & 0x3;
+    } else {
+        if ((alfn & 0x3) == 0) {
+            // write most significant bits once every four blocks
+            alfn_bits = (alfn >> (16 + block * 2)) & 0x3;
+        } else {
+            // write least significant bits in the remaining three blocks
+            alfn_bits = (alfn >> (block * 2)) & 0x3;
+        }
+    }
+
+    // reserved bit, time status and ALFN bits
+    time_status status = time_locked ? time_status::LOCKED : time_status::NOT_LOCKED;
+    int tail = (static_cast<int>(status) << 2) | alfn_bits;
+
+    unpack_bits(payload, 64, out);
+    unpack_bits((tail << 12) | crc12(payload, tail), 16, out + 64);
+}
+
+/*
+ * Returns the rotation state of a schedule item, which together with the station
+ * configuration fully determines the payload bits it produces.
+ */
+unsigned int sis_frame_encoder::item_state(sched_item item)
+{
+    switch (item) {
+    case sched_item::LONG_STATION_NAME:
+        return long_name_current_frame;
+    case sched_item::STATION_LOCATION:
+        return location_high ? 0 : 1;
+    case sched_item::STATION_MESSAGE:
+        return message_current_frame;
+    case sched_item::SERVICE_INFO_MESSAGE:
+        return current_service;
+    case sched_item::SIS_PARAMETER_MESSAGE:
+        return current_parameter;
+    case sched_item::UNIVERSAL_SHORT_STATION_NAME:
+        return ussn_current_frame;
+    case sched_item::STATION_SLOGAN:
+        return slogan_current_frame;
+    case sched_item::EA_MESSAGE:
+        return emergency_alert_current_frame;
+    default:
+        return 0;
+    }
+}
+
+/* Number of PDUs needed to send the full content of a schedule item */
+unsigned int sis_frame_encoder::item_segments(sched_item item)
+{
+    switch (item) {
+    case sched_item::LONG_STATION_NAME: {
+        unsigned int name_length = std::min((unsigned int)slogan.length(), 56u);
+        return std::max((name_length + 6) / 7, 1u);
+    }
+    case sched_item::STATION_LOCATION:
+        return 2;
+    case sched_item::STATION_MESSAGE: {
+        unsigned int message_length = std::min((unsigned int)message.length(), 190u);
+        return (message_length + 7) / 6;
+    }
+    case sched_item::SERVICE_INFO_MESSAGE:
+        return program_types.size() + data_types.size();
+    case sched_item::SIS_PARAMETER_MESSAGE:
+        return NUM_PARAMETERS;
+    case sched_item::UNIVERSAL_SHORT_STATION_NAME: {
+        unsigned int short_name_length = std::min((unsigned int)short_name.length(), 12u);
+        return std::max((short_name_length + 5) / 6, 1u);
+    }
+    case sched_item::STATION_SLOGAN: {
+        unsigned int slogan_length = std::min((unsigned int)slogan.length(), 95u);
+        return (slogan_length + 6) / 6;
+    }
+    case sched_item::EA_MESSAGE:
+        return (emergency_alert.length() + 8) / 6;
+    default:
+        return 1;
+    }
+}
+
+void sis_frame_encoder::advance_item(sched_item item)
+{
+    unsigned int num_frames = item_segments(item);
+
+    switch (item) {
+    case sched_item::LONG_STATION_NAME:
+        long_name_current_frame = (long_name_current_frame + 1) % num_frames;
+        break;
+    case sched_item::STATION_LOCATION:
+        location_high = !location_high;
+        break;
+    case sched_item::STATION_MESSAGE:
+        message_current_frame = (message_current_frame + 1) % num_frames;
+        break;
+    case sched_item::SERVICE_INFO_MESSAGE:
+        current_service = (current_service + 1) % num_frames;
+        break;
+    case sched_item::SIS_PARAMETER_MESSAGE:
+        current_parameter = (current_parameter + 1) % num_frames;
+        break;
+    case sched_item::UNIVERSAL_SHORT_STATION_NAME:
+        ussn_current_frame = (ussn_current_frame + 1) % num_frames;
+        break;
+    case sched_item::STATION_SLOGAN:
+        slogan_current_frame = (slogan_current_frame + 1) % num_frames;
+        break;
+    case sched_item::EA_MESSAGE:
+        emergency_alert_current_frame = (emergency_alert_current_frame + 1) % num_frames;
+        break;
+    default:
+        break;
+    }
+
+    unsigned int& remaining = fresh_segments[static_cast<int>(item)];
+    if (remaining > 0) {
+        remaining--;
+        if (remaining == 0) {
+            schedule_dirty = true;
+        }
+    }
+}
+
+/*
+ * Builds the slot assignment for the coming frames from the standard schedule. The
+ * single-slot long items (station message, slogan and long station name) share
+ * their slots among themselves. While any of them has changed and has not yet been
+ * sent in full, it takes over all of those slots, so that receivers get the update
+ * several times sooner. Slots carrying the station ID, short name, location, service
+ * information and SIS parameters are never reassigned, so their repetition rates are
+ * unaffected, and emergency alert schedules are used as they are.
+ */
+void sis_frame_encoder::compile_schedule()
+{
+    schedule = current_schedule();
+
+    std::vector<sched_item> fresh;
+    std::vector<size_t> long_slots;
+    for (size_t block = 0; block < schedule.size(); block++) {
+        if (schedule[block].size() != 1) {
+            continue;
+        }
+        sched_item item = schedule[block][0];
+        if ((item == sched_item::STATION_MESSAGE) ||
+            (item == sched_item::STATION_SLOGAN) ||
+            (item == sched_item::LONG_STATION_NAME)) {
+            long_slots.push_back(block);
+            if ((fresh_segments[static_cast<int>(item)] > 0) &&
+                (std::find(fresh.begin(), fresh.end(), item) == fresh.end())) {
+                fresh.push_back(item);
+            }
+        }
+    }
+
+    if (!fresh.empty()) {
+        for (size_t i = 0; i < long_slots.size(); i++) {
+            schedule[long_slots[i]][0] = fresh[i % fresh.size()];
+        }
+    }
+
+    schedule_dirty = false;
+}
+
+/* Marks an item as changed, so that it is favoured until sent in full */
+void sis_frame_encoder::mark_fresh(sched_item item)
+{
+    invalidate_item(item);
+    fresh_segments[static_cast<int>(item)] = item_segments(item);
+    schedule_dirty = true;
+}
+
+/*
+ * Returns the payload bits of a schedule item in its current rotation state, encoding
+ * them on first use.
+ */
+sis_frame_encoder::packed_bits sis_frame_encoder::item_bits(sched_item item)
+{
+    std::vector<packed_bits>& cache = item_cache[static_cast<int>(item)];
+    unsigned int state = item_state(item);
+    if (state >= cache.size()) {
+        cache.resize(state + 1, { 0, 0 });
+    }
+    if (cache[state].len > 0) {
+        return cache[state];
+    }
+
+    acc = 0;
+    acc_len = 0;
+    switch (item) {
+    case sched_item::STATION_ID:
+        write_station_id();
+        break;
+    case sched_item::SHORT_STATION_NAME:
+        write_station_name_short();
+        break;
+    case sched_item::LONG_STATION_NAME:
+        write_station_name_long();
+        break;
+    case sched_item::STATION_LOCATION:
+        write_station_location();
+        break;
+    case sched_item::STATION_MESSAGE:
+        write_station_message();
+        break;
+    case sched_item::SERVICE_INFO_MESSAGE:
+        write_service_information_message();
+        break;
+    case sched_item::SIS_PARAMETER_MESSAGE:
+        write_sis_parameter_message();
+        break;
+    case sched_item::UNIVERSAL_SHORT_STATION_NAME:
+        write_universal_short_station_name();
+        break;
+    case sched_item::STATION_SLOGAN:
+        write_station_slogan();
+        break;
+    case sched_item::EA_MESSAGE:
+        write_emergency_alert();
+        break;
+    }
+
+    cache[state] = { acc, acc_len };
+    return cache[state];
+}
+
+/* Discards the cached payload bits of an item whose content has changed */
+void sis_frame_encoder::invalidate_item(sched_item item)
+{
+    item_cache[static_cast<int>(item)].clear();
+}
+
+/* 1020s.pdf section 4.10
+ * Note: The specified CRC is incorrect. It's actually a 16-bit CRC
+ * truncated to 12 bits, and g(x) = X^16 + X^11 + X^3 + X + 1 */
+int sis_frame_encoder::crc12(uint64_t payload, int tail)
+{
+    // Bits are fed from bit 79 of the PDU down to bit 0, skipping the CRC itself and
+    // preceded by four zero bits so that they fill whole bytes. Leading zeros have no
+    // effect on a zero-initialized CRC, and since the CRC is linear, the contribution
+    // of the final four bits can be looked up separately.
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (payload >> (8 * i)) & 0xff;
+    }
+    return (sis_crc16_update(0x0000, bytes, sizeof(bytes)) ^ tail_crc[tail] ^ 0x955) &
+           0xfff;
+}
+
+void sis_frame_encoder::update_control_data_crc(std::string& control_data)
+{
+    control_data[1] &= 0x00;
+    control_data[2] &= 0xf0;
+
+    uint16_t reg = 0xffff;
+    for (int byte_index = control_data.length() - 1; byte_index >= 1; byte_index--) {
+        unsigned char byte = control_data[byte_index];
+        reg = sis_crc16_update(reg, &byte, 1);
+    }
+
+    control_data[1] |= (reg & 0x00ff);
+    control_data[2] |= (reg & 0x0f00) >> 8;
+}
+
+int sis_frame_encoder::crc7(const std::string alert)
+{
+    // Each character contributes seven bits, the lowest of which is combined with the
+    // high bit of the preceding character.
+    uint8_t reg = 0x76;
+    for (int byte_index = alert.length() - 1; byte_index >= 0; byte_index--) {
+        unsigned char symbol = (unsigned char)alert[byte_index] & 0x7f;
+        if (byte_index > 0)
+            symbol ^= ((unsigned char)alert[byte_index - 1] >> 7);
+        reg = crc7_update(reg, &symbol, 1);
+    }
+    return reg;
+}
+
+void sis_frame_encoder::write_bit(int b)
+{
+    acc = (acc << 1) | (b & 1);
+    acc_len++;
+}
+
+void sis_frame_encoder::write_int(int n, int len)
+{
+    acc = (acc << len) | (n & ((1u << len) - 1));
+    acc_len += len;
+}
+
+void sis_frame_encoder::write_char5(char c)
+{
+    int n;
+    if (c >= 'A' && c <= 'Z') {
+        n = (c - 'A');
+    } else if (c >= 'a' && c <= 'z') {
+        n = (c - 'a');
+    } else {
+        switch (c) {
+        case '?':
+            n = 27;
+            break;
+        case '-':
+            n = 28;
+            break;
+        case '*':
+            n = 29;
+            break;
+        case '$':
+            n = 30;
+            break;
+        default:
+            n = 26;
+        }
+    }
+    write_int(n, 5);
+}
+
+void sis_frame_encoder::write_station_id()
+{
+    write_int(static_cast<int>(msg_id::STATION_ID_NUMBER), 4);
+    for (int i = 0; i < 2; i++) {
+        write_char5(country_code[i]);
+    }
+    write_int(0, 3); // reserved
+    write_int(fcc_facility_id, 19);
+}
+
+bool sis_frame_encoder::can_use_standard_short_station_name()
+{
+    if (this->short_name.length() > 4) {
+        return false;
+    }
+
+    for (int i = 0; i < this->short_name.length(); i++) {
+        if (std::strchr("ABCDEFGHIJKLMNOPQRSTUVWXYZ ?-*$", this->short_name[i]) ==
+            nullptr) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void sis_frame_encoder::write_station_name_short()
+{
+    write_int(static_cast<int>(msg_id::STATION_NAME_SHORT), 4);
+    for (int i = 0; i < 4; i++) {
+        if (i < short_name.length()) {
+            write_char5(short_name[i]);
+        } else {
+            write_char5(' ');
+        }
+    }
+    if (fm_suffix) {
+        write_int(static_cast<int>(name_extension::FM), 2);
+    } else {
+        write_int(static_cast<int>(name_extension::NONE), 2);
+    }
+}
+
+void sis_frame_encoder::write_station_name_long()
+{
+    write_int(static_cast<int>(msg_id::STATION_NAME_LONG), 4);
+
+    unsigned int name_length = std::min((unsigned int)slogan.length(), 56u);
+    unsigned int num_frames = std::max((name_length + 6) / 7, 1u);
+
+    write_int(num_frames - 1, 3);
+    write_int(long_name_current_frame, 3);
+    for (int i = long_name_current_frame * 7; i < long_name_current_frame * 7 + 7; i++) {
+        if (i < name_length) {
+            write_int(slogan.at(i), 7);
+        } else {
+            write_int(0, 7);
+        }
+    }
+    write_int(long_name_seq, 3);
+}
+
+void sis_frame_encoder::write_station_location()
+{
+    int altitude_int = static_cast<int>(std::round(altitude / 16));
+    altitude_int = std::max(std::min(altitude_int, 255), 0);
+
+    write_int(static_cast<int>(msg_id::STATION_LOCATION), 4);
+    write_bit(location_high);
+    if (location_high) {
+        write_int(std::round(latitude * 8192), 22);
+        write_int(altitude_int >> 4, 4);
+    } else {
+        write_int(std::round(longitude * 8192), 22);
+        write_int(altitude_int & 0xf, 4);
+    }
+}
+
+void sis_frame_encoder::write_station_message()
+{
+    write_int(static_cast<int>(msg_id::STATION_MESSAGE), 4);
+
+    unsigned int message_length = std::min((unsigned int)message.length(), 190u);
+
+    write_int(message_current_frame, 5);
+    write_int(message_seq, 2);
+
+    if (message_current_frame == 0) {
+        unsigned int checksum = 0;
+        for (int j = 0; j < message_length; j++)
+            checksum += (unsigned char)message.at(j);
+        checksum = (((checksum >> 8) & 0x7f) + (checksum & 0xff)) & 0x7f;
+
+        write_bit(static_cast<int>(priority::NORMAL));
+        write_int(static_cast<int>(encoding::ISO_8859_1), 3);
+        write_int(message_length, 8);
+        write_int(checksum, 7);
+        for (int i = 0; i < 4; i++) {
+            if (i < message_length) {
+                write_int(message.at(i), 8);
+            } else {
+                write_int(0, 8);
+            }
+        }
+    } else {
+        write_int(0, 3); // reserved
+        for (int i = message_current_frame * 6 - 2; i < message_current_frame * 6 + 4;
+             i++) {
+            if (i < message_length) {
+                write_int(message.at(i), 8);
+            } else {
+                write_int(0, 8);
+            }
+        }
+    }
+}
+
+void sis_frame_encoder::write_service_information_message()
+{
+    write_int(static_cast<int>(msg_id::SERVICE_INFORMATION_MESSAGE), 4);
+
+    if (current_service < program_types.size()) {
+        write_int(static_cast<int>(service_category::AUDIO), 2);
+        write_bit(static_cast<int>(access::PUBLIC));
+        write_int(current_service, 6);
+        write_int(static_cast<int>(program_types[current_service]), 8);
+        write_int(0, 5); // reserved
+        write_int(static_cast<int>(sound_experience::NONE), 5);
+    } else {
+        unsigned int data_index = current_service - program_types.size();
+
+        write_int(static_cast<int>(service_category::DATA), 2);
+        write_bit(static_cast<int>(access::PUBLIC));
+        write_int(static_cast<int>(data_types[data_index]), 9);
+        write_int(0, 3); // reserved
+        write_int(data_mime_types[data_index], 12);
+    }
+}
+
+void sis_frame_encoder::write_sis_parameter_message()
+{
+    write_int(static_cast<int>(msg_id::SIS_PARAMETER_MESSAGE), 4);
+    write_int(current_parameter, 6);
+
+    switch (static_cast<parameter_type>(current_parameter)) {
+    case parameter_type::LEAP_SECOND_OFFSET:
+        write_int(pending_leap_second_offset, 8);
+        write_int(current_leap_second_offset, 8);
+        break;
+    case parameter_type::LEAP_SECOND_ALFN_LSB:
+        write_int(leap_second_alfn & 0xffff, 16);
+        break;
+    case parameter_type::LEAP_SECOND_ALFN_MSB:
+        write_int(leap_second_alfn >> 16, 16);
+        break;
+    case parameter_type::LOCAL_TIME_DATA:
+        write_int(utc_offset, 11);
+        write_int(static_cast<int>(dst_sched), 3);
+        write_bit(dst_local);
+        write_bit(dst_regional);
+        break;
+    case parameter_type::EXCITER_MANUFACTURER_ID:
+        write_bit(0); // reserved
+        write_int(exciter_manufacturer_id[0], 7);
+        write_bit(static_cast<int>(icb::IMPORTER_CONNECTED));
+        write_int(exciter_manufacturer_id[1], 7);
+        break;
+    case parameter_type::EXCITER_CORE_VERSION_NUMBER_1_2_3:
+        write_int(exciter_core_version[0], 5);
+        write_int(exciter_core_version[1], 5);
+        write_int(exciter_core_version[2], 5);
+        write_bit(0); // reserved
+        break;
+    case parameter_type::EXCITER_MANUFACTURER_VERSION_NUMBER_1_2_3:
+        write_int(exciter_manufacturer_version[0], 5);
+        write_int(exciter_manufacturer_version[1], 5);
+        write_int(exciter_manufacturer_version[2], 5);
+        write_bit(0); // reserved
+        break;
+    case parameter_type::EXCITER_VERSION_NUMBER_4_AND_STATUS:
+        write_int(exciter_core_version[3], 5);
+        write_int(exciter_manufacturer_version[3], 5);
+        write_int(exciter_core_status, 3);
+        write_int(exciter_manufacturer_status, 3);
+        break;
+    case parameter_type::IMPORTER_MANUFACTURER_ID:
+        write_bit(0); // reserved
+        write_int(importer_manufacturer_id[0], 7);
+        write_bit(0); // reserved
+        write_int(importer_manufacturer_id[1], 7);
+        break;
+    case parameter_type::IMPORTER_CORE_VERSION_NUMBER_1_2_3:
+        write_int(importer_core_version[0], 5);
+        write_int(importer_core_version[1], 5);
+        write_int(importer_core_version[2], 5);
+        write_bit(0); // reserved
+        break;
+    case parameter_type::IMPORTER_MANUFACTURER_VERSION_NUMBER_1_2_3:
+        write_int(importer_manufacturer_version[0], 5);
+        write_int(importer_manufacturer_version[1], 5);
+        write_int(importer_manufacturer_version[2], 5);
+        write_bit(0); // reserved
+        break;
+    case parameter_type::IMPORTER_VERSION_NUMBER_4_AND_STATUS:
+        write_int(importer_core_version[3], 5);
+        write_int(importer_manufacturer_version[3], 5);
+        write_int(importer_core_status, 3);
+        write_int(importer_manufacturer_status, 3);
+        break;
+    case parameter_type::IMPORTER_CONFIGURATION_NUMBER:
+        write_int(importer_configuration_number, 16);
+    }
+}
+
+void sis_frame_encoder::write_universal_short_station_name()
+{
+    write_int(static_cast<int>(msg_id::UNIVERSAL_SHORT_STATION_NAME), 4);
+
+    unsigned int short_name_length = std::min((unsigned int)short_name.length(), 12u);
+    unsigned int num_frames = std::max((short_name_length + 5) / 6, 1u);
+
+    write_int(ussn_current_frame, 4);
+    write_bit(static_cast<int>(name_type::UNIVERSAL_SHORT_STATION_NAME));
+
+    if (ussn_current_frame == 0) {
+        write_int(static_cast<int>(encoding::ISO_8859_1), 3);
+        write_bit(fm_suffix);
+        write_bit(num_frames - 1);
+    } else {
+        write_int(0, 5); // reserved
+    }
+
+    for (int i = ussn_current_frame * 6; i < ussn_current_frame * 6 + 6; i++) {
+        if (i < short_name_length) {
+            write_int(short_name.at(i), 8);
+        } else {
+            write_int(0, 8);
+        }
+    }
+}
+
+void sis_frame_encoder::write_station_slogan()
+{
+    write_int(static_cast<int>(msg_id::UNIVERSAL_SHORT_STATION_NAME), 4);
+
+    unsigned int slogan_length = std::min((unsigned int)slogan.length(), 95u);
+
+    write_int(slogan_current_frame, 4);
+    write_bit(static_cast<int>(name_type::SLOGAN));
+
+    if (slogan_current_frame == 0) {
+        write_int(static_cast<int>(encoding::ISO_8859_1), 3);
+        write_int(0, 3); // reserved
+        write_int(slogan_length, 7);
+        for (int i = 0; i < 5; i++) {
+            if (i < slogan_length) {
+                write_int(slogan.at(i), 8);
+            } else {
+                write_int(0, 8);
+            }
+        }
+    } else {
+        write_int(0, 5); // reserved
+        for (int i = slogan_current_frame * 6 - 1; i < slogan_current_frame * 6 + 5;
+             i++) {
+            if (i < slogan_length) {
+                write_int(slogan.at(i), 8);
+            } else {
+                write_int(0, 8);
+            }
+        }
+    }
+}
+
+void sis_frame_encoder::write_emergency_alert()
+{
+    write_int(static_cast<int>(msg_id::EMERGENCY_ALERTS_MESSAGE), 4);
+
+    write_int(emergency_alert_current_frame, 6);
+    write_int(emergency_alert_seq, 2);
+    write_int(0, 2); // reserved
+
+    if (emergency_alert_current_frame == 0) {
+        write_int(static_cast<int>(encoding::ISO_8859_1), 3);
+        write_int(emergency_alert.length(), 9);
+        write_int(crc7(emergency_alert), 7);
+        write_int(emergency_alert_cnt_len, 5);
+        for (int i = 0; i < 3; i++) {
+            write_int(emergency_alert.at(i), 8);
+        }
+    } else {
+        for (int i = emergency_alert_current_frame * 6 - 3;
+             i < emergency_alert_current_frame * 6 + 3;
+             i++) {
+            if (i < emergency_alert.length()) {
+                write_int(emergency_alert.at(i), 8);
+            } else {
+                write_int(0, 8);
+            }
+        }
+    }
+}
+
+std::string sis_frame_encoder::generate_sig_program(unsigned int program_id)
+{
+    std::stringstream out;
+    unsigned int component_id = 0;
+    uint16_t port = 0x1000 + 2 * program_id;
+
+    out << generate_sig_service(
+        sig_service_type::AUDIO, program_id + 1, program_names[program_id]);
+
+    out << generate_sig_audio_component(
+        component_id++, program_id, program_types[program_id], mime_hash::HDC);
+
+    out << generate_sig_data_component(component_id++,
+                                       port++,
+                                       service_data_type::AUDIO_RELATED_DATA,
+                                       data_type::LOT,
+                                       mime_hash::PRIMARY_IMAGE,
+                                       0x28 + program_id);
+
+    out << generate_sig_data_component(component_id++,
+                                       port++,
+                                       service_data_type::AUDIO_RELATED_DATA,
+                                       data_type::LOT,
+                                       mime_hash::STATION_LOGO,
+                                       0x32 + program_id);
+
+    return out.str();
+}
+
+/*
+ * Serializes the SIG packet from the cached per-program records. The sequence number
+ * in the AAS header is filled in when the packet is sent.
+ */
+void sis_frame_encoder::encode_sig()
+{
+    std::string header = generate_aas_header(SIG_PORT, 0);
+
+    size_t len = header.length();
+    for (const std::string& program : sig_programs) {
+        len += program.length();
+    }
+
+    sig_packet.clear();
+    sig_packet.reserve(len);
+    sig_packet.insert(sig_packet.end(), header.begin(), header.end());
+    for (const std::string& program : sig_programs) {
+        sig_packet.insert(sig_packet.end(), program.begin(), program.end());
+    }
+    sig_valid = true;
+}
+
+/* Re-encodes the SIG record of one program after it has been added or changed */
+void sis_frame_encoder::update_sig_program(unsigned int program_id)
+{
+    if (program_id == sig_programs.size()) {
+        sig_programs.push_back(generate_sig_program(program_id));
+    } else {
+        sig_programs[program_id] = generate_sig_program(program_id);
+    }
+    sig_valid = false;
+}
+
+void sis_frame_encoder::services_changed()
+{
+    invalidate_item(sched_item::SERVICE_INFO_MESSAGE);
+    current_service %= item_segments(sched_item::SERVICE_INFO_MESSAGE);
+}
+
+} /* namespace nrsc5 */
+} /* namespace gr */
@@ -0,0 +1,48 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Clayton Smith.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef INCLUDED_NRSC5_TIMING_H
+#define INCLUDED_NRSC5_TIMING_H
+
+#include <pmt/pmt.h>
+#include <cstdint>
+
+namespace gr {
+namespace nrsc5 {
+
+/* 1020s.pdf section 3.3: ALFN counts frames of 65536 samples at 44.1 kHz since the
+ * GPS epoch (1980-01-06 00:00:00 UTC) */
+constexpr uint64_t GPS_EPOCH_UNIX = 315964800;
+constexpr uint64_t ALFN_SAMPLE_RATE = 44100;
+constexpr uint64_t SAMPLES_PER_ALFN = 65536;
+
+/* Absolute layer 1 frame number, placed on the first item of each frame */
+inline const pmt::pmt_t& alfn_tag()
+{
+    static const pmt::pmt_t key = pmt::intern("alfn");
+    return key;
+}
+
+/* Block number within the frame, placed on the first symbol of each block */
+inline const pmt::pmt_t& block_tag()
+{
+    static const pmt::pmt_t key = pmt::intern("block");
+    return key;
+}
+
+/* Transmit time of the tagged item, as a tuple of (integer seconds, fractional
+ * seconds) since the Unix epoch, as used by UHD sinks */
+inline const pmt::pmt_t& tx_time_tag()
+{
+    static const pmt::pmt_t key = pmt::intern("tx_time");
+    return key;
+}
+
+} // namespace nrsc5
+} // namespace gr
+
+#endif /* INCLUDED_NRSC5_TIMING_H */
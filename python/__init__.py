@@ -20,5 +20,4 @@ except ModuleNotFoundError:
     pass
 
 # import any pure python here
-from .lot_encoder import lot_encoder
 #
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(adts_file_source.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(9f3dcd2f0bcac4ad35edf6896c2ee663)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <nrsc5/adts_file_source.h>
+// pydoc.h is automatically generated in the build directory
+#include <adts_file_source_pydoc.h>
+
+void bind_adts_file_source(py::module& m)
+{
+
+    using adts_file_source    = ::gr::nrsc5::adts_file_source;
+
+
+    py::class_<adts_file_source, gr::sync_block, gr::block, gr::basic_block,
+        std::shared_ptr<adts_file_source>>(m, "adts_file_source", D(adts_file_source))
+
+        .def(py::init(&adts_file_source::make),
+           py::arg("filename"),
+           py::arg("realtime") = true,
+           py::arg("repeat") = true,
+           D(adts_file_source,make)
+        )
+        
+
+
+
+        .def("seek",&adts_file_source::seek,
+            py::arg("frame"),
+            D(adts_file_source,seek)
+        )
+
+
+        .def("num_frames",&adts_file_source::num_frames,
+            D(adts_file_source,num_frames)
+        )
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
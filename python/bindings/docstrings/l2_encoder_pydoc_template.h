@@ -24,4 +24,7 @@
 
  static const char *__doc_gr_nrsc5_l2_encoder_make = R"doc()doc";
 
+
+ static const char *__doc_gr_nrsc5_l2_encoder_set_lockstep_ports = R"doc()doc";
+
   
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+#include "pydoc_macros.h"
+#define D(...) DOC(gr,nrsc5, __VA_ARGS__ )
+/*
+  This file contains placeholders for docstrings for the Python bindings.
+  Do not edit! These were automatically extracted during the binding process
+  and will be overwritten during the build process
+ */
+
+
+ 
+ static const char *__doc_gr_nrsc5_lot_carousel = R"doc()doc";
+
+
+ static const char *__doc_gr_nrsc5_lot_carousel_lot_carousel = R"doc()doc";
+
+
+ static const char *__doc_gr_nrsc5_lot_carousel_make = R"doc()doc";
+
+
+ static const char *__doc_gr_nrsc5_lot_carousel_add_file = R"doc()doc";
+
+
+ static const char *__doc_gr_nrsc5_lot_carousel_remove_file = R"doc()doc";
+
+
+ static const char *__doc_gr_nrsc5_lot_carousel_num_files = R"doc()doc";
+
+
+ static const char *__doc_gr_nrsc5_lot_carousel_files_ingested = R"doc()doc";
+
+
+ static const char *__doc_gr_nrsc5_lot_carousel_ingest_latency = R"doc()doc";
+
+
+ static const char *__doc_gr_nrsc5_lot_carousel_air_latency = R"doc()doc";
+
+  
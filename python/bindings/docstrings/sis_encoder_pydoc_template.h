@@ -24,4 +24,7 @@
 
  static const char *__doc_gr_nrsc5_sis_encoder_make = R"doc()doc";
 
+
+ static const char *__doc_gr_nrsc5_sis_encoder_underruns = R"doc()doc";
+
   
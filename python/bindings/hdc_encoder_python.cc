@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(hdc_encoder.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(189e984318a00d48a752b2e0010ef257)                     */
+/* BINDTOOL_HEADER_FILE_HASH(ca9643f29c469e733ad931eee4ecca34)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -39,6 +39,9 @@ void bind_hdc_encoder(py::module& m)
         .def(py::init(&hdc_encoder::make),
            py::arg("channels") = 2,
            py::arg("bitrate") = 64000,
+           py::arg("short_input") = false,
+           py::arg("lookahead_frames") = 0,
+           py::arg("record_file") = "",
            D(hdc_encoder,make)
         )
 
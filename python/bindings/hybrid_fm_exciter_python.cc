@@ -0,0 +1,61 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(hybrid_fm_exciter.h)                                     */
+/* BINDTOOL_HEADER_FILE_HASH(a2765320560508409e8f70b799a8e970)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <nrsc5/hybrid_fm_exciter.h>
+// pydoc.h is automatically generated in the build directory
+#include <hybrid_fm_exciter_pydoc.h>
+
+void bind_hybrid_fm_exciter(py::module& m)
+{
+
+    using hybrid_fm_exciter    = ::gr::nrsc5::hybrid_fm_exciter;
+
+
+    py::class_<hybrid_fm_exciter, gr::block, gr::basic_block,
+        std::shared_ptr<hybrid_fm_exciter>>(m, "hybrid_fm_exciter", D(hybrid_fm_exciter))
+
+        .def(py::init(&hybrid_fm_exciter::make),
+           py::arg("sample_rate") = 2000000,
+           py::arg("lsb_power_db") = -13,
+           py::arg("usb_power_db") = -13,
+           py::arg("gain") = 1,
+           D(hybrid_fm_exciter,make)
+        )
+        
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
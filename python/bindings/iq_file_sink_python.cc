@@ -0,0 +1,67 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(iq_file_sink.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(09fa40d67b4b346dd2d0ec24d6501c3f)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <nrsc5/iq_file_sink.h>
+// pydoc.h is automatically generated in the build directory
+#include <iq_file_sink_pydoc.h>
+
+void bind_iq_file_sink(py::module& m)
+{
+
+    using iq_file_sink    = ::gr::nrsc5::iq_file_sink;
+
+
+    py::class_<iq_file_sink, gr::sync_block, gr::block, gr::basic_block,
+        std::shared_ptr<iq_file_sink>>(m, "iq_file_sink", D(iq_file_sink))
+
+        .def(py::init(&iq_file_sink::make),
+           py::arg("filename"),
+           py::arg("bits"),
+           py::arg("sample_rate"),
+           py::arg("vlen") = 1,
+           py::arg("full_scale") = 1.0,
+           py::arg("mode") = "",
+           py::arg("lsb_power_db") = 0,
+           py::arg("usb_power_db") = 0,
+           D(iq_file_sink,make)
+        )
+        
+
+
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
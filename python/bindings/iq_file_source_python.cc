@@ -0,0 +1,75 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(iq_file_source.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(4d65319707432561a9905f2c795b4e2b)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <nrsc5/iq_file_source.h>
+// pydoc.h is automatically generated in the build directory
+#include <iq_file_source_pydoc.h>
+
+void bind_iq_file_source(py::module& m)
+{
+
+    using iq_file_source    = ::gr::nrsc5::iq_file_source;
+
+
+    py::class_<iq_file_source, gr::sync_block, gr::block, gr::basic_block,
+        std::shared_ptr<iq_file_source>>(m, "iq_file_source", D(iq_file_source))
+
+        .def(py::init(&iq_file_source::make),
+           py::arg("filename"),
+           py::arg("repeat") = true,
+           D(iq_file_source,make)
+        )
+        
+
+
+
+        .def("sample_rate",&iq_file_source::sample_rate,
+            D(iq_file_source,sample_rate)
+        )
+
+
+        .def("vlen",&iq_file_source::vlen,
+            D(iq_file_source,vlen)
+        )
+
+
+        .def("mode",&iq_file_source::mode,
+            D(iq_file_source,mode)
+        )
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(l2_encoder.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(b0ded61b840bd7589aff93c0979dcf5d)                     */
+/* BINDTOOL_HEADER_FILE_HASH(d2d6453c17acc17615722f1cfb28f299)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -51,6 +51,11 @@ void bind_l2_encoder(py::module& m)
         )
         
 
+        .def("set_lockstep_ports",&l2_encoder::set_lockstep_ports,
+            py::arg("ports"),
+            D(l2_encoder,set_lockstep_ports)
+        )
+
 
 
         ;
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(lot_carousel.h)                                            */
+/* BINDTOOL_HEADER_FILE_HASH(4fcde73a22e56359da89efcd60c31808)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <nrsc5/lot_carousel.h>
+// pydoc.h is automatically generated in the build directory
+#include <lot_carousel_pydoc.h>
+
+void bind_lot_carousel(py::module& m)
+{
+
+    using lot_carousel    = ::gr::nrsc5::lot_carousel;
+
+
+    py::class_<lot_carousel, gr::block, gr::basic_block,
+        std::shared_ptr<lot_carousel>>(m, "lot_carousel", D(lot_carousel))
+
+        .def(py::init(&lot_carousel::make),
+           py::arg("spool_dir") = "",
+           py::arg("spool_port") = 0x1001,
+           D(lot_carousel,make)
+        )
+        
+
+
+
+        .def("add_file",&lot_carousel::add_file,
+            py::arg("filename"),
+            py::arg("lot_id"),
+            py::arg("port") = 0x1001,
+            py::arg("priority") = 1.0,
+            py::arg("repeat") = 0,
+            py::arg("expiry") = 0.0,
+            py::arg("deadline") = 0.0,
+            D(lot_carousel,add_file)
+        )
+
+
+        .def("remove_file",&lot_carousel::remove_file,
+            py::arg("lot_id"),
+            D(lot_carousel,remove_file)
+        )
+
+
+        .def("num_files",&lot_carousel::num_files,
+            D(lot_carousel,num_files)
+        )
+
+
+        .def("files_ingested",&lot_carousel::files_ingested,
+            D(lot_carousel,files_ingested)
+        )
+
+
+        .def("ingest_latency",&lot_carousel::ingest_latency,
+            D(lot_carousel,ingest_latency)
+        )
+
+
+        .def("air_latency",&lot_carousel::air_latency,
+            D(lot_carousel,air_latency)
+        )
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(lot_encoder.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(df8e10c6680f2867e00c48dc035dadf3)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <nrsc5/lot_encoder.h>
+// pydoc.h is automatically generated in the build directory
+#include <lot_encoder_pydoc.h>
+
+void bind_lot_encoder(py::module& m)
+{
+
+    using lot_encoder    = ::gr::nrsc5::lot_encoder;
+
+
+    py::class_<lot_encoder, gr::block, gr::basic_block,
+        std::shared_ptr<lot_encoder>>(m, "lot_encoder", D(lot_encoder))
+
+        .def(py::init(&lot_encoder::make),
+           py::arg("filename") = "",
+           py::arg("lot_id") = 0,
+           py::arg("port") = 0x1001,
+           D(lot_encoder,make)
+        )
+        
+
+
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(ofdm_resampler.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(51b65e97dd8978f1d471ec885eab5b00)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <nrsc5/ofdm_resampler.h>
+// pydoc.h is automatically generated in the build directory
+#include <ofdm_resampler_pydoc.h>
+
+void bind_ofdm_resampler(py::module& m)
+{
+
+    using ofdm_resampler    = ::gr::nrsc5::ofdm_resampler;
+
+
+    py::class_<ofdm_resampler, gr::block, gr::basic_block,
+        std::shared_ptr<ofdm_resampler>>(m, "ofdm_resampler", D(ofdm_resampler))
+
+        .def(py::init(&ofdm_resampler::make),
+           py::arg("band") = ::gr::nrsc5::pids_mode::FM,
+           py::arg("sample_rate") = 2000000,
+           py::arg("rejection_db") = 80,
+           D(ofdm_resampler,make)
+        )
+        
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(psd_encoder.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(aa3c914cdda9eeb1f25aa5201cb775bd)                     */
+/* BINDTOOL_HEADER_FILE_HASH(6cce4262f8785e9a158a7732baa38dac)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -41,10 +41,17 @@ void bind_psd_encoder(py::module& m)
            py::arg("title"),
            py::arg("artist"),
            py::arg("bytes_per_frame") = 0,
+           py::arg("preempt") = false,
+           py::arg("lookahead_frames") = 1,
            D(psd_encoder,make)
         )
 
 
+        .def("underruns",&psd_encoder::underruns,
+            D(psd_encoder,underruns)
+        )
+
+
 
 
         ;
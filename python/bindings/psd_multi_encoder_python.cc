@@ -0,0 +1,71 @@
+/*
+ * Copyright 2021 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+/***********************************************************************************/
+/* This file is automatically generated using bindtool and can be manually edited  */
+/* The following lines can be configured to regenerate this file during cmake      */
+/* If manual edits are made, the following tags should be modified accordingly.    */
+/* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
+/* BINDTOOL_USE_PYGCCXML(0)                                                        */
+/* BINDTOOL_HEADER_FILE(psd_multi_encoder.h)                                        */
+/* BINDTOOL_HEADER_FILE_HASH(af0c6dae8108ecfe2138cc26c0204fdc)                     */
+/***********************************************************************************/
+
+#include <pybind11/complex.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+#include <nrsc5/psd_multi_encoder.h>
+// pydoc.h is automatically generated in the build directory
+#include <psd_multi_encoder_pydoc.h>
+
+void bind_psd_multi_encoder(py::module& m)
+{
+
+    using psd_multi_encoder    = ::gr::nrsc5::psd_multi_encoder;
+
+
+    py::class_<psd_multi_encoder, gr::sync_block, gr::block, gr::basic_block,
+        std::shared_ptr<psd_multi_encoder>>(m, "psd_multi_encoder", D(psd_multi_encoder))
+
+        .def(py::init(&psd_multi_encoder::make),
+           py::arg("num_progs"),
+           py::arg("first_prog"),
+           py::arg("titles"),
+           py::arg("artists"),
+           py::arg("bytes_per_frame") = 0,
+           py::arg("preempt") = false,
+           py::arg("lookahead_frames") = 1,
+           D(psd_multi_encoder,make)
+        )
+
+
+        .def("underruns",&psd_multi_encoder::underruns,
+            D(psd_multi_encoder,underruns)
+        )
+
+
+
+
+        ;
+
+
+
+
+}
+
+
+
+
+
+
+
+
@@ -21,12 +21,20 @@ namespace py = pybind11;
 /* Please do not delete
 /**************************************/
 // BINDING_FUNCTION_PROTOTYPES(
+    void bind_adts_file_source(py::module& m);
     void bind_am_pulse_shaper(py::module& m);
     void bind_hdc_encoder(py::module& m);
+    void bind_hybrid_fm_exciter(py::module& m);
+    void bind_iq_file_sink(py::module& m);
+    void bind_iq_file_source(py::module& m);
     void bind_l1_am_encoder(py::module& m);
     void bind_l1_fm_encoder(py::module& m);
     void bind_l2_encoder(py::module& m);
+    void bind_lot_carousel(py::module& m);
+    void bind_lot_encoder(py::module& m);
+    void bind_ofdm_resampler(py::module& m);
     void bind_psd_encoder(py::module& m);
+    void bind_psd_multi_encoder(py::module& m);
     void bind_sis_encoder(py::module& m);
 // ) END BINDING_FUNCTION_PROTOTYPES
 
@@ -56,12 +64,20 @@ PYBIND11_MODULE(nrsc5_python, m)
     /* Please do not delete
     /**************************************/
     // BINDING_FUNCTION_CALLS(
+    bind_adts_file_source(m);
     bind_am_pulse_shaper(m);
     bind_hdc_encoder(m);
+    bind_hybrid_fm_exciter(m);
+    bind_iq_file_sink(m);
+    bind_iq_file_source(m);
     bind_l1_am_encoder(m);
     bind_l1_fm_encoder(m);
     bind_l2_encoder(m);
+    bind_lot_carousel(m);
+    bind_lot_encoder(m);
+    bind_ofdm_resampler(m);
     bind_psd_encoder(m);
+    bind_psd_multi_encoder(m);
     bind_sis_encoder(m);
     // ) END BINDING_FUNCTION_CALLS
 }
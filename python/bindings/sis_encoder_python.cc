@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(0)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(sis_encoder.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(38686eef3cff9a3dab3147ef3ec3001d)                     */
+/* BINDTOOL_HEADER_FILE_HASH(e1989dbd60a25b5936c21eca41faa8c3)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -110,10 +110,16 @@ void bind_sis_encoder(py::module& m)
            py::arg("altitude") = 93.0,
            py::arg("country_code") = "US",
            py::arg("fcc_facility_id") = 0,
+           py::arg("lookahead_frames") = 1,
+           py::arg("time_locked") = false,
            D(sis_encoder,make)
         )
         
 
+        .def("underruns",&sis_encoder::underruns,
+            D(sis_encoder,underruns)
+        )
+
 
 
         ;
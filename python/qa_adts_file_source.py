@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 Clayton Smith.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import os
+import tempfile
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+try:
+    from nrsc5 import adts_file_source
+except ImportError:
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from nrsc5 import adts_file_source
+
+
+def adts_frame(length):
+    header = [0xff, 0xf1, 0x50, 0x80 | (length >> 11), (length >> 3) & 0xff,
+              ((length & 7) << 5) | 0x1f, 0xfc]
+    return bytes(header) + bytes((length + i) & 0xff for i in range(length - 7))
+
+
+class qa_adts_file_source(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.lengths = [100 + (i * 37) % 300 for i in range(20)]
+        self.data = b"".join(adts_frame(length) for length in self.lengths)
+        fd, self.filename = tempfile.mkstemp(suffix=".aac")
+        with os.fdopen(fd, "wb") as f:
+            f.write(self.data)
+
+    def tearDown(self):
+        self.tb = None
+        os.remove(self.filename)
+
+    def test_instance(self):
+        instance = adts_file_source(self.filename)
+        self.assertEqual(instance.num_frames(), len(self.lengths))
+        with self.assertRaises(ValueError):
+            instance.seek(len(self.lengths))
+
+    def test_replay(self):
+        src = adts_file_source(self.filename, realtime=False, repeat=False)
+        dst = blocks.vector_sink_b()
+        self.tb.connect(src, dst)
+        self.tb.run()
+
+        self.assertEqual(bytes(dst.data()), self.data)
+        tags = dst.tags()
+        self.assertEqual(len(tags), len(self.lengths))
+        offset = 0
+        for seq, (tag, length) in enumerate(zip(tags, self.lengths)):
+            self.assertEqual(tag.offset, offset)
+            self.assertEqual(pmt.to_long(pmt.car(tag.value)), length - 7)
+            self.assertEqual(pmt.to_uint64(pmt.cdr(tag.value)), seq)
+            offset += length
+
+    def test_repeat(self):
+        src = adts_file_source(self.filename, realtime=False, repeat=True)
+        head = blocks.head(gr.sizeof_char, 2 * len(self.data) + 10)
+        dst = blocks.vector_sink_b()
+        self.tb.connect(src, head, dst)
+        self.tb.run()
+
+        self.assertEqual(bytes(dst.data()), (self.data * 3)[:2 * len(self.data) + 10])
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_adts_file_source)
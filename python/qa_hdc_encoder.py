@@ -6,6 +6,8 @@
 # SPDX-License-Identifier: GPL-3.0-or-later
 #
 
+import os
+
 from gnuradio import gr, gr_unittest
 # from gnuradio import blocks
 try:
@@ -28,6 +30,9 @@ class qa_hdc_encoder(gr_unittest.TestCase):
     def test_instance(self):
         instance = hdc_encoder(channels=1, bitrate=32000)
         instance = hdc_encoder(channels=2, bitrate=64000)
+        instance = hdc_encoder(channels=2, bitrate=64000, short_input=True)
+        instance = hdc_encoder(channels=2, bitrate=64000, lookahead_frames=2)
+        instance = hdc_encoder(channels=2, bitrate=64000, record_file=os.devnull)
 
     def test_001_descriptive_test_name(self):
         # set up fg
@@ -0,0 +1,69 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 Clayton Smith.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import cmath
+import math
+
+from gnuradio import gr, gr_unittest, blocks
+try:
+    from nrsc5 import hybrid_fm_exciter
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from nrsc5 import hybrid_fm_exciter
+
+
+class qa_hybrid_fm_exciter(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def excite(self, channels, symbols, gain=1):
+        symbol_src = blocks.vector_source_c([0] * (2048 * symbols), vlen=2048)
+        exciter = hybrid_fm_exciter(2000000, -13, -13, gain)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(symbol_src, (exciter, 0))
+        for i in range(channels):
+            audio_src = blocks.vector_source_f([0] * (128 * symbols))
+            self.tb.connect(audio_src, (exciter, i + 1))
+        self.tb.connect(exciter, dst)
+        self.tb.run()
+        return dst.data()
+
+    def test_instance(self):
+        instance = hybrid_fm_exciter(2000000, -13, -13, 1)
+
+    def test_invalid_rate(self):
+        with self.assertRaises(ValueError):
+            hybrid_fm_exciter(300000)
+
+    def test_mono_carrier(self):
+        # with no digital signal and silence, only the carrier is left
+        out = self.excite(1, 8, 0.5)
+        expected = 8 * 2160 * 2000000 / 744187.5
+        self.assertLessEqual(len(out), math.ceil(expected))
+        self.assertGreater(len(out), expected - 50)
+        for x in out:
+            self.assertAlmostEqual(x, 0.5, 5)
+
+    def test_stereo_pilot(self):
+        # the pilot takes 10% of the 75 kHz deviation
+        out = self.excite(2, 8)
+        freqs = [cmath.phase(out[n + 1] * out[n].conjugate()) * 2000000 / (2 * math.pi)
+                 for n in range(len(out) - 1)]
+        self.assertAlmostEqual(max(freqs), 7500, delta=10)
+        self.assertAlmostEqual(min(freqs), -7500, delta=10)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_hybrid_fm_exciter)
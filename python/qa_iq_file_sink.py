@@ -0,0 +1,92 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 Clayton Smith.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import cmath
+import json
+import os
+import shutil
+import struct
+import tempfile
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+try:
+    from nrsc5 import iq_file_sink
+except ImportError:
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from nrsc5 import iq_file_sink
+
+
+class qa_iq_file_sink(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.dir = tempfile.mkdtemp()
+        self.base = os.path.join(self.dir, "capture")
+        self.samples = [0.5 * cmath.exp(0.01j * i) - 0.25j * cmath.sin(0.03 * i)
+                        for i in range(400)]
+
+    def tearDown(self):
+        self.tb = None
+        shutil.rmtree(self.dir)
+
+    def record(self, bits, tags=()):
+        src = blocks.vector_source_c(self.samples, False, 4, list(tags))
+        dst = iq_file_sink(self.base + ".sigmf-data", bits, 744187.5, 4, 1.0, "MP1",
+                           -20.0, -21.0)
+        self.tb.connect(src, dst)
+        self.tb.run()
+        with open(self.base + ".sigmf-meta") as f:
+            meta = json.load(f)
+        with open(self.base + ".sigmf-data", "rb") as f:
+            return meta, f.read()
+
+    def check_data(self, data, fmt, scale):
+        values = [v[0] for v in struct.iter_unpack(fmt, data)]
+        self.assertEqual(len(values), 2 * len(self.samples))
+        for i, sample in enumerate(self.samples):
+            received = complex(values[2 * i], values[2 * i + 1]) / scale
+            self.assertAlmostEqual(received.real, sample.real, delta=1 / scale)
+            self.assertAlmostEqual(received.imag, sample.imag, delta=1 / scale)
+
+    def test_instance(self):
+        with self.assertRaises(ValueError):
+            iq_file_sink(self.base, 12, 744187.5)
+
+    def test_int16(self):
+        meta, data = self.record(16)
+        self.assertEqual(meta["global"]["core:datatype"], "ci16_le")
+        self.assertEqual(meta["global"]["core:sample_rate"], 744187.5)
+        self.assertEqual(meta["global"]["nrsc5:mode"], "MP1")
+        self.assertEqual(meta["global"]["nrsc5:vlen"], 4)
+        self.assertEqual(meta["global"]["nrsc5:lsb_power_db"], -20.0)
+        self.assertEqual(meta["global"]["nrsc5:usb_power_db"], -21.0)
+        self.assertNotIn("nrsc5:alfn", meta["captures"][0])
+
+        self.check_data(data, "<h", 32767)
+
+    def test_int8(self):
+        meta, data = self.record(8)
+        self.assertEqual(meta["global"]["core:datatype"], "ci8")
+
+        self.check_data(data, "b", 127)
+
+    def test_alfn(self):
+        tag = gr.tag_t()
+        tag.offset = 32
+        tag.key = pmt.intern("alfn")
+        tag.value = pmt.from_uint64(1400000000)
+        meta, data = self.record(8, [tag])
+        self.assertEqual(meta["captures"][0]["nrsc5:alfn"], 1400000000)
+        self.assertEqual(meta["captures"][0]["nrsc5:alfn_sample"], 128)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_iq_file_sink)
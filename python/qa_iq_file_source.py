@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 Clayton Smith.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import json
+import os
+import shutil
+import struct
+import tempfile
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+try:
+    from nrsc5 import iq_file_source
+except ImportError:
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from nrsc5 import iq_file_source
+
+
+class qa_iq_file_source(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.dir = tempfile.mkdtemp()
+        self.base = os.path.join(self.dir, "capture")
+        self.iq = [(i * 37) % 251 * 200 - 25000 for i in range(2 * 2 * 50)]
+        with open(self.base + ".sigmf-data", "wb") as f:
+            f.write(struct.pack("<%dh" % len(self.iq), *self.iq))
+        meta = {
+            "global": {
+                "core:datatype": "ci16_le",
+                "core:sample_rate": 46511.71875,
+                "core:version": "1.0.0",
+                "nrsc5:mode": "MA1",
+                "nrsc5:full_scale": 2.0,
+                "nrsc5:vlen": 2,
+            },
+            "captures": [{"core:sample_start": 0, "nrsc5:alfn": 1234,
+                          "nrsc5:alfn_sample": 20}],
+            "annotations": [],
+        }
+        with open(self.base + ".sigmf-meta", "w") as f:
+            json.dump(meta, f)
+        self.expected = [complex(self.iq[i], self.iq[i + 1]) * 2.0 / 32767
+                         for i in range(0, len(self.iq), 2)]
+
+    def tearDown(self):
+        self.tb = None
+        shutil.rmtree(self.dir)
+
+    def test_instance(self):
+        instance = iq_file_source(self.base + ".sigmf-meta")
+        self.assertEqual(instance.sample_rate(), 46511.71875)
+        self.assertEqual(instance.vlen(), 2)
+        self.assertEqual(instance.mode(), "MA1")
+
+    def test_replay(self):
+        src = iq_file_source(self.base, repeat=False)
+        dst = blocks.vector_sink_c(2)
+        self.tb.connect(src, dst)
+        self.tb.run()
+
+        self.assertComplexTuplesAlmostEqual(dst.data(), self.expected, 5)
+        tags = dst.tags()
+        self.assertEqual(len(tags), 1)
+        self.assertEqual(tags[0].offset, 10)
+        self.assertEqual(pmt.symbol_to_string(tags[0].key), "alfn")
+        self.assertEqual(pmt.to_uint64(tags[0].value), 1234)
+
+    def test_repeat(self):
+        src = iq_file_source(self.base, repeat=True)
+        head = blocks.head(gr.sizeof_gr_complex * 2, 120)
+        dst = blocks.vector_sink_c(2)
+        self.tb.connect(src, head, dst)
+        self.tb.run()
+
+        expected = (self.expected * 3)[:240]
+        self.assertComplexTuplesAlmostEqual(dst.data(), expected, 5)
+        self.assertEqual(len(dst.tags()), 1)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_iq_file_source)
@@ -1,13 +1,15 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
 #
-# Copyright 2017 Clayton Smith.
+# Copyright 2017, 2026 Clayton Smith.
 #
 # SPDX-License-Identifier: GPL-3.0-or-later
 #
 
-from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+import time
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
 try:
     from nrsc5 import l2_encoder
 except ImportError:
@@ -35,6 +37,7 @@ class qa_l2_encoder(gr_unittest.TestCase):
         instance = l2_encoder(num_progs=1, first_prog=0, size=4608)
         instance = l2_encoder(num_progs=1, first_prog=0, size=3750)
         instance = l2_encoder(num_progs=1, first_prog=0, size=2304)
+        instance.set_lockstep_ports([0x20, 0x1001])
 
     def test_001_descriptive_test_name(self):
         # set up fg
@@ -42,5 +45,87 @@ class qa_l2_encoder(gr_unittest.TestCase):
         # check data
 
 
+    def wait_for(self, condition, timeout=10):
+        deadline = time.monotonic() + timeout
+        while not condition():
+            self.assertLess(time.monotonic(), deadline, "timed out")
+            time.sleep(0.01)
+
+    def test_lockstep(self):
+        # ADTS frames with a 10-byte payload, and silence for PSD
+        frame = [0xff, 0xf1, 0x50, 0x80, 0x02, 0x3f, 0xfc] + [0] * 10
+        audio = blocks.vector_source_b(frame, repeat=True)
+        psd = blocks.vector_source_b([0], repeat=True)
+        l2 = l2_encoder(num_progs=1, first_prog=0, size=146176, data_bytes=1000)
+        head = blocks.head(146176, 3)
+        sink = blocks.vector_sink_b(146176)
+        dbg = blocks.message_debug()
+        self.tb.connect(audio, (l2, 0))
+        self.tb.connect(psd, (l2, 1))
+        self.tb.connect(l2, head, sink)
+        self.tb.msg_connect((l2, "ready"), (dbg, "store"))
+        l2.set_lockstep_ports([0x1001])
+
+        pdu = pmt.init_u8vector(8, [0x21, 0x01, 0x10, 0, 0, 1, 2, 3])
+        l2.to_basic_block()._post(pmt.intern("aas"), pmt.cons(pmt.make_dict(), pdu))
+        self.tb.start()
+        try:
+            # once the PDU is sent, the encoder asks for more and waits for the reply
+            self.wait_for(lambda: dbg.num_messages() == 1)
+            ready = dbg.get_message(0)
+            self.assertTrue(pmt.is_pair(ready))
+            self.assertEqual(pmt.to_long(pmt.car(ready)), 0x1001)
+
+            time.sleep(0.2)
+            stalled = len(sink.data())
+            time.sleep(0.5)
+            self.assertEqual(len(sink.data()), stalled)
+
+            end = pmt.make_dict()
+            end = pmt.dict_add(end, pmt.intern("reply_end"), pmt.from_long(0x1001))
+            l2.to_basic_block()._post(pmt.intern("aas"), pmt.cons(end, pmt.PMT_NIL))
+            self.wait_for(lambda: len(sink.data()) > stalled)
+        finally:
+            self.tb.stop()
+            self.tb.wait()
+
+    def test_aas_framing(self):
+        # an AAS PDU with bytes to escape, one of them split between two L2 PDUs
+        payload = bytearray(b"A~B}C" + bytes(range(0x20, 0x70)))
+        payload[52] = 0x7e
+        pdu = [0x21, 0x01, 0x10, 0, 0] + list(payload)
+        frame = [0xff, 0xf1, 0x50, 0x80, 0x02, 0x3f, 0xfc] + [0] * 10
+        audio = blocks.vector_source_b(frame, repeat=True)
+        psd = blocks.vector_source_b([0], repeat=True)
+        l2 = l2_encoder(num_progs=1, first_prog=0, size=146176, data_bytes=64)
+        head = blocks.head(146176, 2)
+        sink = blocks.vector_sink_b(146176)
+        self.tb.connect(audio, (l2, 0))
+        self.tb.connect(psd, (l2, 1))
+        self.tb.connect(l2, head, sink)
+        msg = pmt.cons(pmt.make_dict(), pmt.init_u8vector(len(pdu), pdu))
+        l2.to_basic_block()._post(pmt.intern("aas"), msg)
+        self.tb.run()
+
+        # The data subchannel sits just before the CCC and its count byte at the end of
+        # the PDU, after all 24 bits of the spread header.
+        start = (146176 - 22) // 8 - 1 - 24 - 64
+        bits = sink.data()
+        data = bytearray()
+        for k in range(2):
+            for i in range(start, start + 64):
+                offset = k * 146176 + 24 + 8 * i
+                data.append(int("".join(str(b) for b in bits[offset:offset + 8]), 2))
+
+        # block boundary marker, then the framed PDU with its FCS and flags
+        expected = bytes.fromhex(
+            "7d3ae2422101100000417d5e427d5d43202122232425262728292a2b2c2d2e2f"
+            "303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e7d"
+            "5e505152535455565758595a5b5c5d5e5f606162636465666768696a6b6c6d6e"
+            "6f4bd17e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e7e"
+        )
+        self.assertEqual(bytes(data), expected)
+
+
 if __name__ == '__main__':
     gr_unittest.run(qa_l2_encoder)
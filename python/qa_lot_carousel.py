@@ -0,0 +1,193 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 Clayton Smith.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import os
+import shutil
+import tempfile
+import time
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+try:
+    from nrsc5 import lot_carousel
+except ImportError:
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from nrsc5 import lot_carousel
+
+class qa_lot_carousel(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+        self.dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        self.tb = None
+        shutil.rmtree(self.dir)
+
+    def make_file(self, name, size):
+        path = os.path.join(self.dir, name)
+        with open(path, "wb") as f:
+            f.write(bytes(i & 0xff for i in range(size)))
+        return path
+
+    def wait_for(self, condition, timeout=10):
+        deadline = time.monotonic() + timeout
+        while not condition():
+            self.assertLess(time.monotonic(), deadline, "timed out")
+            time.sleep(0.01)
+
+    def pdus(self, dbg):
+        return [bytes(pmt.u8vector_elements(pmt.cdr(dbg.get_message(i))))
+                for i in range(dbg.num_messages())]
+
+    def run_carousel(self, carousel, num_pdus):
+        dbg = blocks.message_debug()
+        self.tb.msg_connect((carousel, "aas"), (dbg, "store"))
+        self.tb.start()
+        self.wait_for(lambda: dbg.num_messages() >= num_pdus)
+        self.tb.stop()
+        self.tb.wait()
+        return [pdu[1] | (pdu[2] << 8) for pdu in self.pdus(dbg)]
+
+    def spool_write(self, spool, name, data):
+        # written under a hidden name first, so that it appears in one piece
+        with open(os.path.join(spool, "." + name), "wb") as f:
+            f.write(data)
+        os.rename(os.path.join(spool, "." + name), os.path.join(spool, name))
+
+    def test_instance(self):
+        instance = lot_carousel()
+
+    def test_invalid(self):
+        carousel = lot_carousel()
+        path = self.make_file("a.txt", 100)
+        with self.assertRaises(ValueError):
+            carousel.add_file(path, 1, priority=0)
+        with self.assertRaises(ValueError):
+            carousel.add_file(path, 1, repeat=-1)
+        with self.assertRaises(ValueError):
+            carousel.add_file(self.make_file("a.bin", 100), 1)
+        with self.assertRaises(ValueError):
+            carousel.add_file(self.make_file("a" * 228 + ".txt", 100), 1)
+        self.assertEqual(carousel.num_files(), 0)
+
+    def test_priority(self):
+        carousel = lot_carousel()
+        carousel.add_file(self.make_file("a.txt", 2560), 1, port=0x1001, priority=4)
+        carousel.add_file(self.make_file("b.txt", 2560), 2, port=0x1002, priority=1)
+        self.assertEqual(carousel.num_files(), 2)
+
+        ports = self.run_carousel(carousel, 8)
+        self.assertEqual(len(ports), 8)
+        self.assertEqual(ports.count(0x1001), 5)
+        self.assertEqual(ports.count(0x1002), 3)
+
+    def test_repeat(self):
+        carousel = lot_carousel()
+        carousel.add_file(self.make_file("a.txt", 300), 1, port=0x1001, repeat=1)
+
+        ports = self.run_carousel(carousel, 2)
+        self.assertEqual(ports, [0x1001, 0x1001])
+        self.assertEqual(carousel.num_files(), 0)
+
+    def test_remove(self):
+        carousel = lot_carousel()
+        carousel.add_file(self.make_file("a.txt", 300), 1)
+        carousel.add_file(self.make_file("b.txt", 300), 2)
+        carousel.remove_file(1)
+        self.assertEqual(carousel.num_files(), 1)
+
+    def test_lockstep(self):
+        # a lockstep "ready" is always answered with a reply_end, even for a port with
+        # nothing to send, so that the Layer 2 encoder never waits forever
+        carousel = lot_carousel()
+        carousel.add_file(self.make_file("a.txt", 300), 1, port=0x1001)
+        dbg = blocks.message_debug()
+        self.tb.msg_connect((carousel, "aas"), (dbg, "store"))
+        self.tb.start()
+        try:
+            self.wait_for(lambda: dbg.num_messages() >= 2)
+            for port in (0x1001, 0x1002):
+                carousel.to_basic_block()._post(
+                    pmt.intern("ready"), pmt.cons(pmt.from_long(port), pmt.intern("reply_end")))
+
+            def reply_ends():
+                ends = []
+                for i in range(dbg.num_messages()):
+                    meta = pmt.car(dbg.get_message(i))
+                    port = pmt.dict_ref(meta, pmt.intern("reply_end"), pmt.PMT_NIL)
+                    if not pmt.is_null(port):
+                        ends.append(pmt.to_long(port))
+                return ends
+
+            self.wait_for(lambda: len(reply_ends()) == 2)
+            self.assertEqual(reply_ends(), [0x1001, 0x1002])
+        finally:
+            self.tb.stop()
+            self.tb.wait()
+
+    def test_spool(self):
+        spool = os.path.join(self.dir, "spool")
+        os.mkdir(spool)
+        with open(os.path.join(spool, "7_a.txt"), "wb") as f:
+            f.write(b"a" * 300)
+        with open(os.path.join(spool, "no_id.txt"), "wb") as f:
+            f.write(b"b" * 300)
+
+        carousel = lot_carousel(spool_dir=spool, spool_port=0x1234)
+        dbg = blocks.message_debug()
+        self.tb.msg_connect((carousel, "aas"), (dbg, "store"))
+        self.tb.start()
+        self.wait_for(lambda: carousel.num_files() == 1)
+
+        self.spool_write(spool, "8_b.txt", b"b" * 300)
+        self.wait_for(lambda: carousel.num_files() == 2)
+        self.assertEqual(carousel.files_ingested(), 2)
+        self.assertGreaterEqual(carousel.ingest_latency(), 0)
+
+        os.remove(os.path.join(spool, "7_a.txt"))
+        self.wait_for(lambda: carousel.num_files() == 1)
+        self.tb.stop()
+        self.tb.wait()
+
+        pdu = pmt.u8vector_elements(pmt.cdr(dbg.get_message(0)))
+        self.assertEqual(pdu[1:3], [0x34, 0x12])
+
+    def test_spool_replace(self):
+        # a new version written before the old one is deleted takes over, even though
+        # the old one is part way through being sent
+        spool = os.path.join(self.dir, "spool")
+        os.mkdir(spool)
+        self.spool_write(spool, "5_old.txt", b"a" * 256 * 1000)
+
+        carousel = lot_carousel(spool_dir=spool, spool_port=0x1234)
+        dbg = blocks.message_debug()
+        self.tb.msg_connect((carousel, "aas"), (dbg, "store"))
+        self.tb.start()
+        try:
+            self.wait_for(lambda: dbg.num_messages() >= 8)
+
+            self.spool_write(spool, "5_new.txt", b"b" * 300)
+            os.remove(os.path.join(spool, "5_old.txt"))
+            # spool events are handled in order, so once this file is in, so is the
+            # deletion before it
+            self.spool_write(spool, "6_marker.txt", b"c" * 300)
+            self.wait_for(lambda: carousel.files_ingested() == 3)
+            self.assertEqual(carousel.num_files(), 2)
+
+            carousel.to_basic_block()._post(pmt.intern("ready"), pmt.from_long(0x1234))
+            self.wait_for(lambda: any(b"new.txt" in pdu for pdu in self.pdus(dbg)))
+        finally:
+            self.tb.stop()
+            self.tb.wait()
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_lot_carousel)
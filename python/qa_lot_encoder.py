@@ -1,14 +1,24 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
 #
-# Copyright 2023 Clayton Smith.
+# Copyright 2023, 2026 Clayton Smith.
 #
 # SPDX-License-Identifier: GPL-3.0-or-later
 #
 
-from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
-from lot_encoder import lot_encoder
+import os
+import tempfile
+import time
+
+from gnuradio import gr, gr_unittest, blocks
+import pmt
+try:
+    from nrsc5 import lot_encoder
+except ImportError:
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from nrsc5 import lot_encoder
 
 class qa_lot_encoder(gr_unittest.TestCase):
 
@@ -20,11 +30,76 @@ class qa_lot_encoder(gr_unittest.TestCase):
 
     def test_instance(self):
         instance = lot_encoder(filename="../../apps/album_art.jpg", lot_id=1337, port=0x1234)
+        instance = lot_encoder()
+
+    def test_unsupported(self):
+        fd, filename = tempfile.mkstemp(suffix=".bin")
+        os.close(fd)
+        try:
+            with self.assertRaises(ValueError):
+                lot_encoder(filename=filename)
+        finally:
+            os.remove(filename)
+
+    def test_parts(self):
+        data = bytes(i & 0xff for i in range(600))
+        fd, filename = tempfile.mkstemp(suffix=".txt")
+        with os.fdopen(fd, "wb") as f:
+            f.write(data)
+        name = os.path.basename(filename).encode()
+
+        try:
+            src = lot_encoder(filename=filename, lot_id=42, port=0x1234)
+            dbg = blocks.message_debug()
+            self.tb.msg_connect((src, "aas"), (dbg, "store"))
+            self.tb.start()
+            time.sleep(0.1)
+            self.tb.stop()
+            self.tb.wait()
+        finally:
+            os.remove(filename)
+
+        self.assertEqual(dbg.num_messages(), 3)
+        pdus = [bytes(pmt.u8vector_elements(pmt.cdr(dbg.get_message(i)))) for i in range(3)]
+        for seq, pdu in enumerate(pdus):
+            self.assertEqual(pdu[:5], bytes([0x21, 0x34, 0x12, seq, 0]))
+        self.assertEqual(pdus[0][5:9], bytes([24 + len(name), 1, 42, 0]))
+        self.assertEqual(pdus[0][29:29 + len(name)], name)
+        self.assertEqual(pdus[0][29 + len(name):], data[:256])
+        self.assertEqual(pdus[1][5:], bytes([8, 1, 42, 0, 1, 0, 0, 0]) + data[256:512])
+        self.assertEqual(pdus[2][5:], bytes([8, 1, 42, 0, 2, 0, 0, 0]) + data[512:])
+
+
+    def test_lockstep(self):
+        # the end of a reply is only marked when the Layer 2 encoder asks for it
+        fd, filename = tempfile.mkstemp(suffix=".txt")
+        with os.fdopen(fd, "wb") as f:
+            f.write(b"a" * 600)
+
+        try:
+            src = lot_encoder(filename=filename, lot_id=42, port=0x1234)
+            dbg = blocks.message_debug()
+            self.tb.msg_connect((src, "aas"), (dbg, "store"))
+            self.tb.start()
+            src.to_basic_block()._post(pmt.intern("ready"), pmt.from_long(0x1234))
+            src.to_basic_block()._post(
+                pmt.intern("ready"), pmt.cons(pmt.from_long(0x1234), pmt.intern("reply_end")))
+            deadline = time.monotonic() + 10
+            while dbg.num_messages() < 10:
+                self.assertLess(time.monotonic(), deadline, "timed out")
+                time.sleep(0.01)
+            self.tb.stop()
+            self.tb.wait()
+        finally:
+            os.remove(filename)
 
-    def test_001_descriptive_test_name(self):
-        # set up fg
-        self.tb.run()
-        # check data
+        self.assertEqual(dbg.num_messages(), 10)
+        for i in range(9):
+            self.assertTrue(pmt.is_u8vector(pmt.cdr(dbg.get_message(i))))
+        end = dbg.get_message(9)
+        self.assertTrue(pmt.is_null(pmt.cdr(end)))
+        self.assertEqual(pmt.to_long(pmt.dict_ref(pmt.car(end), pmt.intern("reply_end"),
+                                                  pmt.PMT_NIL)), 0x1234)
 
 
 if __name__ == '__main__':
@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 Clayton Smith.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+import cmath
+import math
+
+from gnuradio import gr, gr_unittest, blocks
+try:
+    from nrsc5 import ofdm_resampler, pids_mode
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from nrsc5 import ofdm_resampler, pids_mode
+
+
+class qa_ofdm_resampler(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def resample(self, band, sample_rate, data):
+        src = blocks.vector_source_c(data)
+        resampler = ofdm_resampler(band, sample_rate)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(src, resampler, dst)
+        self.tb.run()
+        return dst.data()
+
+    def test_instance(self):
+        instance = ofdm_resampler(pids_mode.FM, 2000000, 80)
+
+    def test_invalid_rate(self):
+        with self.assertRaises(ValueError):
+            ofdm_resampler(pids_mode.FM, 300000)
+
+    def test_fm_length(self):
+        # 744187.5 Hz to 2 MHz is a ratio of 32000 / 11907
+        out = self.resample(pids_mode.FM, 2000000, [1] * (11907 * 4))
+        self.assertEqual(len(out), 32000 * 4)
+        for x in out[1000:]:
+            self.assertAlmostEqual(x, 1, 3)
+
+    def test_am_tone(self):
+        input_rate = 46511.71875
+        freq = 5000
+        data = [cmath.exp(2j * math.pi * freq * n / input_rate) for n in range(5000)]
+        out = self.resample(pids_mode.AM, 2400000, data)
+
+        self.assertEqual(len(out), math.ceil(5000 * 2400000 / input_rate))
+        step = cmath.exp(2j * math.pi * freq / 2400000)
+        for n in range(10000, len(out) - 1, 10):
+            self.assertAlmostEqual(abs(out[n]), 1, 3)
+            self.assertAlmostEqual(out[n + 1], out[n] * step, 3)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_ofdm_resampler)
@@ -6,8 +6,10 @@
 # SPDX-License-Identifier: GPL-3.0-or-later
 #
 
-from gnuradio import gr, gr_unittest
-# from gnuradio import blocks
+import time
+
+import pmt
+from gnuradio import gr, gr_unittest, blocks
 try:
     from nrsc5 import psd_encoder
 except ImportError:
@@ -28,6 +30,118 @@ class qa_psd_encoder(gr_unittest.TestCase):
     def test_instance(self):
         instance = psd_encoder(prog_num=0, title="Title", artist="Artist")
         instance = psd_encoder(prog_num=1, title="Title 2", artist="Artist 2")
+        instance = psd_encoder(prog_num=0, title="Title", artist="Artist",
+                               bytes_per_frame=128, preempt=True)
+        instance = psd_encoder(prog_num=0, title="Title", artist="Artist",
+                               bytes_per_frame=128, lookahead_frames=0)
+        self.assertEqual(instance.underruns(), 0)
+
+    def wait_for(self, condition, timeout=10):
+        deadline = time.monotonic() + timeout
+        while not condition():
+            self.assertLess(time.monotonic(), deadline, "timed out")
+            time.sleep(0.01)
+
+    def run_clocked(self, lookahead_frames, clocks):
+        # Sends each clock once the encoder has used up the credit from the last one
+        src = psd_encoder(prog_num=0, title="Title", artist="Artist",
+                          bytes_per_frame=128, lookahead_frames=lookahead_frames)
+        dst = blocks.vector_sink_b()
+        self.tb.connect(src, dst)
+        self.tb.start()
+        try:
+            frames = 0
+            for clock in clocks + [None]:
+                target = 128 * (frames + 1 + lookahead_frames)
+                self.wait_for(lambda: len(dst.data()) >= target)
+                if clock is not None:
+                    src.to_basic_block()._post(pmt.intern("clock"), pmt.from_long(clock))
+                    frames = clock
+        finally:
+            self.tb.stop()
+            self.tb.wait()
+        return src.underruns()
+
+    def test_underruns(self):
+        # one frame ahead, the next frame is always ready when it is clocked
+        self.assertEqual(self.run_clocked(1, [1, 2, 3, 4]), 0)
+
+    def test_underruns_skipped_frame(self):
+        # a clock that jumps two frames only now allows the second one
+        self.assertEqual(self.run_clocked(1, [1, 2, 4, 5]), 0)
+
+    def test_underruns_no_lookahead(self):
+        # with no lookahead, each frame is allowed by the clock that needs it
+        self.assertEqual(self.run_clocked(0, [1, 2, 3, 4]), 0)
+
+    def test_underruns_not_generated(self):
+        # a clock queued before the flowgraph starts is handled before any work, so
+        # the frames it was already allowed to generate are missing
+        src = psd_encoder(prog_num=0, title="Title", artist="Artist",
+                          bytes_per_frame=128, lookahead_frames=1)
+        dst = blocks.vector_sink_b()
+        self.tb.connect(src, dst)
+        src.to_basic_block()._post(pmt.intern("clock"), pmt.from_long(1))
+        self.tb.start()
+        try:
+            self.wait_for(lambda: len(dst.data()) >= 128 * 3)
+        finally:
+            self.tb.stop()
+            self.tb.wait()
+        self.assertEqual(src.underruns(), 1)
+
+    def run_meta_change(self, preempt):
+        # one frame of PSD with the old metadata, then three with the new title
+        src = psd_encoder(prog_num=0, title="Title ~}", artist="~Artist}",
+                          bytes_per_frame=64, preempt=preempt, lookahead_frames=0)
+        dst = blocks.vector_sink_b()
+        self.tb.connect(src, dst)
+        self.tb.start()
+        try:
+            self.wait_for(lambda: len(dst.data()) >= 64)
+            meta = list(b"title}~ New\n")
+            src.to_basic_block()._post(
+                pmt.intern("set_meta"),
+                pmt.cons(pmt.PMT_NIL, pmt.init_u8vector(len(meta), meta)))
+            # no more PSD is allowed until the next clock, so the change lands here
+            time.sleep(0.1)
+            for clock in range(1, 4):
+                src.to_basic_block()._post(pmt.intern("clock"), pmt.from_long(clock))
+                self.wait_for(lambda: len(dst.data()) >= 64 * (clock + 1))
+        finally:
+            self.tb.stop()
+            self.tb.wait()
+        return bytes(dst.data())
+
+    def test_meta_change(self):
+        # 0x7e and 0x7d in the ID3 frames are escaped, and the packets after the
+        # change carry the new title with a matching FCS
+        expected = bytes.fromhex(
+            "21005100004944330300000000003654495432000000090000005469746c6520"
+            "7d5e7d5d54504531000000090000007d5e4172746973747d5d58484452000000"
+            "06000036754bbe0100554606627e210051010049443303000000000034544954"
+            "32000000070000007d5d7d5e204e657754504531000000090000007d5e417274"
+            "6973747d5d5848445200000006000036754bbe010055467cca7e210051020049"
+            "44330300000000003454495432000000070000007d5d7d5e204e657754504531"
+            "000000090000007d5e4172746973747d5d5848445200000006000036754bbe01"
+            "0055460ca77e2100510300494433030000000000345449543200000007000000"
+        )
+        self.assertEqual(self.run_meta_change(False), expected)
+
+    def test_meta_change_preempt(self):
+        # the packet in progress is cut short with a flag, and the next one starts
+        # right away with the new title
+        expected = bytes.fromhex(
+            "21005100004944330300000000003654495432000000090000005469746c6520"
+            "7d5e7d5d54504531000000090000007d5e4172746973747d5d58484452000000"
+            "7e21005101004944330300000000003454495432000000070000007d5d7d5e20"
+            "4e657754504531000000090000007d5e4172746973747d5d5848445200000006"
+            "000036754bbe010055467cca7e21005102004944330300000000003454495432"
+            "000000070000007d5d7d5e204e657754504531000000090000007d5e41727469"
+            "73747d5d5848445200000006000036754bbe010055460ca77e21005103004944"
+            "330300000000003454495432000000070000007d5d7d5e204e65775450453100"
+        )
+        self.assertEqual(self.run_meta_change(True), expected)
 
     def test_001_descriptive_test_name(self):
         # set up fg
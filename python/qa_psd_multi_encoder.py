@@ -0,0 +1,52 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2026 Clayton Smith.
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+
+from gnuradio import gr, gr_unittest
+try:
+    from nrsc5 import psd_multi_encoder
+except ImportError:
+    import os
+    import sys
+    dirname, filename = os.path.split(os.path.abspath(__file__))
+    sys.path.append(os.path.join(dirname, "bindings"))
+    from nrsc5 import psd_multi_encoder
+
+class qa_psd_multi_encoder(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_instance(self):
+        instance = psd_multi_encoder(num_progs=1, first_prog=0,
+                                     titles=["Title"], artists=["Artist"])
+        instance = psd_multi_encoder(num_progs=2, first_prog=1,
+                                     titles=["Title 2", "Title 3"],
+                                     artists=["Artist 2", "Artist 3"],
+                                     bytes_per_frame=128, preempt=True)
+        instance = psd_multi_encoder(num_progs=1, first_prog=0,
+                                     titles=["Title"], artists=["Artist"],
+                                     bytes_per_frame=128, lookahead_frames=0)
+        self.assertEqual(instance.underruns(), 0)
+
+    def test_invalid(self):
+        with self.assertRaises(ValueError):
+            psd_multi_encoder(num_progs=2, first_prog=0,
+                              titles=["Title"], artists=["Artist", "Artist"])
+        with self.assertRaises(ValueError):
+            psd_multi_encoder(num_progs=2, first_prog=7,
+                              titles=["A", "B"], artists=["A", "B"])
+        with self.assertRaises(ValueError):
+            psd_multi_encoder(num_progs=1, first_prog=0, titles=["A"], artists=["A"],
+                              lookahead_frames=-1)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_psd_multi_encoder)
@@ -28,6 +28,9 @@ class qa_sis_encoder(gr_unittest.TestCase):
 
     def test_instance(self):
         instance = nrsc5.sis_encoder()
+        instance = nrsc5.sis_encoder(lookahead_frames=0)
+        instance = nrsc5.sis_encoder(time_locked=True)
+        self.assertEqual(instance.underruns(), 0)
 
     def test_fm_short(self):
         expected = [